@@ -0,0 +1,1093 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+#include <sys/time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "vector.hpp"
+#include "map.hpp"
+#include "set.hpp"
+#include "persistent_map.hpp"
+#include "concurrent_map.hpp"
+#include "skiplist_map.hpp"
+#include "unordered_map.hpp"
+#include "flat_map.hpp"
+#include "btree_map.hpp"
+#include "compact_set.hpp"
+#include "flat_set.hpp"
+#include "btree_set.hpp"
+#include "static_set.hpp"
+
+/* 성능 측정용. make bench 로 -O2 빌드한다.
+ *
+ * ./c_bench.out            : 모든 항목 실행
+ * ./c_bench.out <name>     : 이름이 name인 항목만 실행
+ * ./c_bench.out <name> <n> : 원소 수를 n으로 바꿔서 실행
+ */
+
+static const char*	g_only = NULL;
+static int			g_n = 1000000;
+// 측정한 loop의 결과를 여기에 써서, 최적화로 loop가 지워지지 않게 한다.
+static volatile long long	g_sink = 0;
+
+static bool selected(const char* name) {
+	return (g_only == NULL || std::strcmp(g_only, name) == 0);
+}
+
+static double elapsed_ms(clock_t start) {
+	return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static void report(const char* what, int n, double ms) {
+	std::cout << std::left << std::setw(40) << what
+		<< std::right << std::setw(10) << n << " elems "
+		<< std::setw(10) << std::fixed << std::setprecision(1) << ms << " ms "
+		<< std::setw(10) << std::setprecision(1) << (ms * 1e6 / n) << " ns/op\n";
+}
+
+
+/* 단조증가하는 key(timestamp, sequence id 등)를 차례로 넣는 경우.
+ * 균형을 맞추지 않는 BinarySearchTree는 linked list가 되어 insert 한 번이 O(n)이므로,
+ * 1M개를 넣으면 끝나지 않는다. 그래서 bst는 n/50 개로 줄여서 측정한다. (원소 수가 같으면 비교도 불가) */
+template <typename Map>
+static void sorted_insert(const char* what, int n) {
+	Map m;
+	clock_t start = clock();
+	for (int i = 0; i < n; i++)
+		m.insert(ft::make_pair(i, i));
+	report(what, n, elapsed_ms(start));
+}
+
+static void bench_sorted_insert() {
+	typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, ft::BinarySearchTreeEngine>	bst_map;
+	typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, ft::RB_TreeEngine>		rb_map;
+
+	std::cout << "=== sorted insert ===\n";
+	sorted_insert<bst_map>("map<int,int> BinarySearchTree", g_n / 50);
+	sorted_insert<rb_map>("map<int,int> RB_Tree", g_n / 50);
+	sorted_insert<rb_map>("map<int,int> RB_Tree", g_n);
+}
+
+
+/* 재할당, 중간 삽입/삭제 시 원소를 옮기는 비용.
+ * Packet은 is_trivially_relocatable을 특수화해서 memcpy/memmove 경로를 탄다. */
+struct Packet {
+	int		id;
+	short	port;
+	char	flags;
+	double	ts;
+};
+
+namespace ft {
+template <>
+struct is_trivially_relocatable<Packet> : public true_type { };
+}
+
+template <typename T>
+static void vector_relocate(const char* name, int n) {
+	std::string what;
+	T val = T();
+	{
+		ft::vector<T> v;
+		clock_t start = clock();
+		for (int i = 0; i < n; i++)
+			v.push_back(val);
+		report((what = name + std::string(" push_back")).c_str(), n, elapsed_ms(start));
+	}
+	{
+		ft::vector<T> v(n / 100, val);
+		clock_t start = clock();
+		for (int i = 0; i < 1000; i++)
+			v.insert(v.begin(), val);
+		for (int i = 0; i < 1000; i++)
+			v.erase(v.begin());
+		report((what = name + std::string(" insert/erase front")).c_str(), 2000, elapsed_ms(start));
+	}
+}
+
+static void bench_vector_relocate() {
+	std::cout << "=== vector relocation ===\n";
+	vector_relocate<int>("vector<int>", g_n * 10);
+	vector_relocate<Packet>("vector<Packet>", g_n * 10);
+}
+
+
+/* 지금 process가 실제로 쓰고 있는 메모리. (/proc/self/statm의 resident page 수) */
+static size_t resident_bytes() {
+	unsigned long size = 0;
+	unsigned long resident = 0;
+	FILE* f = std::fopen("/proc/self/statm", "r");
+	if (f == NULL)
+		return 0;
+	if (std::fscanf(f, "%lu %lu", &size, &resident) != 2)
+		resident = 0;
+	std::fclose(f);
+	return resident * sysconf(_SC_PAGESIZE);
+}
+
+/* node를 하나씩 malloc하는 std::allocator와 slab에서 잘라주는 pool_allocator 비교.
+ * 삽입, in-order 순회, 소멸(teardown)을 따로 재고, 삽입으로 늘어난 resident 메모리를 원소 수로 나눠 보여준다. */
+template <typename Set>
+static void node_alloc(const char* name, int n) {
+	std::string what = name;
+	size_t before = resident_bytes();
+	Set* s = new Set;
+	srand(42);
+	clock_t start = clock();
+	for (int i = 0; i < n; i++)
+		s->insert(rand());
+	report((what + " insert").c_str(), n, elapsed_ms(start));
+	std::cout << "    " << std::setprecision(1) << (double)(resident_bytes() - before) / s->size() << " byte/elem resident\n";
+
+	long long sum = 0;
+	start = clock();
+	for (typename Set::iterator it = s->begin(); it != s->end(); ++it)
+		sum += *it;
+	report((what + " iterate").c_str(), n, elapsed_ms(start));
+
+	start = clock();
+	delete s;
+	report((what + " destroy").c_str(), n, elapsed_ms(start));
+	g_sink = sum;
+}
+
+/* resident 메모리가 앞의 측정이 해제한 heap에 섞이지 않도록 각각 fork 한 자식 프로세스에서 잰다. */
+static void bench_node_alloc() {
+	std::cout << "=== node allocator (sizeof node = " << sizeof(ft::nodeBase<int>) << ") ===\n";
+	for (int k = 0; k < 2; k++) {
+		std::cout.flush();
+		pid_t pid = fork();
+		if (pid == 0) {
+			if (k == 0)
+				node_alloc< ft::set<int> >("set<int> std::allocator", g_n);
+			else
+				node_alloc< ft::set<int, std::less<int>, ft::pool_allocator<int> > >("set<int> pool_allocator", g_n);
+			std::cout.flush();
+			_exit(0);
+		}
+		waitpid(pid, NULL, 0);
+	}
+}
+
+
+/* set<int> 에서 find 한 번의 지연시간. 있는 key와 없는 key를 반씩 찾는다. */
+static void bench_find() {
+	std::cout << "=== find ===\n";
+	int sizes[] = { 1000, 100000, g_n };
+	for (int k = 0; k < 3; k++) {
+		int n = sizes[k];
+		ft::set<int> s;
+		for (int i = 0; i < n; i++)
+			s.insert(i * 2);
+		int lookups = 2000000;
+		ft::vector<int> keys;
+		srand(7);
+		for (int i = 0; i < lookups; i++)
+			keys.push_back(rand() % (2 * n));
+		long long found = 0;
+		clock_t start = clock();
+		for (int i = 0; i < lookups; i++)
+			found += (s.find(keys[i]) != s.end());
+		char what[64];
+		std::sprintf(what, "set<int>(%d) find", n);
+		report(what, lookups, elapsed_ms(start));
+		g_sink = found;
+	}
+}
+
+
+/* m[key]++ 로 빈도를 세는 경우. key 종류가 적으면 대부분 hit, 많으면 대부분 첫 삽입이다. */
+static void bench_counter() {
+	std::cout << "=== counter map ===\n";
+	int distinct[] = { 1000, g_n };
+	for (int k = 0; k < 2; k++) {
+		ft::vector<int> keys;
+		srand(3);
+		for (int i = 0; i < g_n; i++)
+			keys.push_back(rand() % distinct[k]);
+		ft::map<int, int> m;
+		clock_t start = clock();
+		for (int i = 0; i < g_n; i++)
+			m[keys[i]]++;
+		char what[64];
+		std::sprintf(what, "map<int,int> m[k]++ (%d keys)", distinct[k]);
+		report(what, g_n, elapsed_ms(start));
+	}
+}
+
+
+/* 정렬된 snapshot에서 set을 다시 만드는 경우. insert를 n번 하는 것과 range 생성자(O(n) bulk build)를 비교. */
+static void bench_bulk_build() {
+	std::cout << "=== build set from sorted input ===\n";
+	ft::vector<int> v;
+	for (int i = 0; i < g_n; i++)
+		v.push_back(i * 2);
+	{
+		clock_t start = clock();
+		ft::set<int> s;
+		for (int i = 0; i < g_n; i++)
+			s.insert(v[i]);
+		report("set<int> insert x n", g_n, elapsed_ms(start));
+	}
+	{
+		clock_t start = clock();
+		ft::set<int> s(v.begin(), v.end());
+		report("set<int>(first, last)", g_n, elapsed_ms(start));
+	}
+	{
+		clock_t start = clock();
+		ft::set<int> s(ft::sorted_unique, v.begin(), v.end());
+		report("set<int>(sorted_unique, first, last)", g_n, elapsed_ms(start));
+	}
+}
+
+
+/* 정렬된 stream을 insert(end(), v) 로 하나씩 붙이는 경우. (ingest pipeline)
+ * hint가 맞으면 root부터 비교하며 내려가지 않고 마지막 원소 뒤에 바로 연결한다. */
+static void bench_hint_insert() {
+	std::cout << "=== hinted insert of sorted stream ===\n";
+	{
+		clock_t start = clock();
+		ft::map<int, int> m;
+		for (int i = 0; i < g_n; i++)
+			m.insert(ft::make_pair(i, i));
+		report("map<int,int> insert(v)", g_n, elapsed_ms(start));
+	}
+	{
+		clock_t start = clock();
+		ft::map<int, int> m;
+		for (int i = 0; i < g_n; i++)
+			m.insert(m.end(), ft::make_pair(i, i));
+		report("map<int,int> insert(end(), v)", g_n, elapsed_ms(start));
+	}
+	{
+		clock_t start = clock();
+		ft::map<int, int> m;
+		for (int i = g_n; i > 0; i--)
+			m.insert(m.begin(), ft::make_pair(i, i));
+		report("map<int,int> insert(begin(), v) desc", g_n, elapsed_ms(start));
+	}
+}
+
+
+/* set을 priority queue처럼 쓰는 경우. 최소/최대값을 읽고 최소값을 꺼낸 뒤 새 값을 넣는다.
+ * begin(), rbegin() 이 root부터 내려가면 매번 O(log n) 이다. */
+static void bench_minmax() {
+	std::cout << "=== min/max queries ===\n";
+	ft::set<int> s;
+	for (int i = 0; i < g_n; i++)
+		s.insert(i * 2);
+	long sum = 0;
+	clock_t start = clock();
+	for (int round = 0; round < 10; round++)
+		for (int i = 0; i < g_n; i++)
+			sum += *s.begin() + *s.rbegin();
+	report("set<int> begin() + rbegin() x 10", g_n * 10, elapsed_ms(start));
+	start = clock();
+	for (int i = 0; i < g_n; i++) {
+		sum += *s.begin();
+		s.erase(s.begin());
+		s.insert(s.end(), g_n * 2 + i);
+	}
+	report("set<int> pop min, push max", g_n, elapsed_ms(start));
+	g_sink = sum;
+}
+
+
+/* 살아있는 set에서 백분위수(p50, p90, p99)를 구하는 경우.
+ * 보통의 RB_Tree는 begin()부터 k칸을 걸어가야 하고, OrderStatisticEngine은 서브트리 크기를 따라 내려간다.
+ * 대신 삽입, 삭제할 때마다 경로의 크기를 갱신하는 비용이 든다. */
+static void bench_order_stat() {
+	typedef ft::set<int, std::less<int>, std::allocator<int>, ft::OrderStatisticEngine>	os_set;
+
+	std::cout << "=== order statistics ===\n";
+	srand(42);
+	ft::vector<int> keys;
+	for (int i = 0; i < g_n; i++)
+		keys.push_back(rand());
+	long sum = 0;
+	{
+		clock_t start = clock();
+		ft::set<int> s;
+		for (int i = 0; i < g_n; i++)
+			s.insert(keys[i]);
+		report("set<int> random insert", g_n, elapsed_ms(start));
+		int queries = 30;
+		start = clock();
+		for (int q = 0; q < queries; q++) {
+			ft::set<int>::iterator it = s.begin();
+			std::advance(it, s.size() * (q % 3 == 0 ? 50 : q % 3 == 1 ? 90 : 99) / 100);
+			sum += *it;
+		}
+		report("set<int> percentile by advance()", queries, elapsed_ms(start));
+	}
+	{
+		clock_t start = clock();
+		os_set s;
+		for (int i = 0; i < g_n; i++)
+			s.insert(keys[i]);
+		report("OrderStatistic set<int> random insert", g_n, elapsed_ms(start));
+		int queries = 1000000;
+		start = clock();
+		for (int q = 0; q < queries; q++)
+			sum += *s.nth(s.size() * (q % 3 == 0 ? 50 : q % 3 == 1 ? 90 : 99) / 100);
+		report("OrderStatistic percentile by nth()", queries, elapsed_ms(start));
+		start = clock();
+		for (int q = 0; q < queries; q++)
+			sum += s.count_range(keys[q % g_n], keys[q % g_n] + (RAND_MAX / 100));
+		report("OrderStatistic count_range()", queries, elapsed_ms(start));
+	}
+	g_sink = sum;
+}
+
+
+/* key 구간의 mapped value 합. 보통의 map은 lower_bound부터 구간을 순회하고,
+ * monoid_augment 를 쓰면 서브트리 합을 이용해 O(log n)에 구한다. 구간 폭은 전체의 1%. */
+static void bench_aggregate() {
+	typedef ft::map<int, long, std::less<int>, std::allocator<ft::pair<const int, long> >,
+				ft::AugmentedRB_TreeEngine<ft::monoid_augment<ft::sum_monoid<long> > > >	sum_map;
+
+	std::cout << "=== range sum ===\n";
+	int width = g_n / 100;
+	long sum = 0;
+	{
+		ft::map<int, long> m;
+		for (int i = 0; i < g_n; i++)
+			m.insert(m.end(), ft::make_pair(i, (long)i));
+		int queries = 1000;
+		clock_t start = clock();
+		for (int q = 0; q < queries; q++) {
+			int lo = (int)(((long)q * 7919) % (g_n - width));
+			ft::map<int, long>::iterator last = m.lower_bound(lo + width);
+			for (ft::map<int, long>::iterator it = m.lower_bound(lo); it != last; ++it)
+				sum += it->second;
+		}
+		report("map<int,long> iterate [lo, hi)", queries, elapsed_ms(start));
+	}
+	{
+		sum_map m;
+		clock_t start = clock();
+		for (int i = 0; i < g_n; i++)
+			m.insert(m.end(), ft::make_pair(i, (long)i));
+		report("sum_map insert(end(), v)", g_n, elapsed_ms(start));
+		int queries = 1000000;
+		start = clock();
+		for (int q = 0; q < queries; q++) {
+			int lo = (int)(((long)q * 7919) % (g_n - width));
+			sum += m.aggregate(lo, lo + width);
+		}
+		report("sum_map aggregate(lo, hi)", queries, elapsed_ms(start));
+		start = clock();
+		for (int q = 0; q < queries; q++)
+			m.insert_or_assign(q % g_n, (long)q);
+		report("sum_map insert_or_assign", queries, elapsed_ms(start));
+	}
+	g_sink = sum;
+}
+
+
+/* 큰 set끼리의 합집합, 교집합, 차집합. 하나씩 insert/erase 하는 방법과 split/join 으로 합치는 방법 비교.
+ * 작은 set(n/1000)을 큰 set에 합치는 경우와 구간 삭제도 측정한다. */
+static void make_sets(ft::set<int>& a, ft::set<int>& b, int na, int nb) {
+	for (int i = 0; i < na; i++)
+		a.insert(a.end(), i * 2);
+	for (int i = 0; i < nb; i++)
+		b.insert(b.end(), i * 3);
+}
+
+static void bench_set_algebra() {
+	std::cout << "=== set algebra ===\n";
+	{
+		ft::set<int> a, b;
+		make_sets(a, b, g_n, g_n);
+		clock_t start = clock();
+		for (ft::set<int>::iterator it = b.begin(); it != b.end(); ++it)
+			a.insert(*it);
+		report("union by insert loop", g_n, elapsed_ms(start));
+	}
+	{
+		ft::set<int> a, b;
+		make_sets(a, b, g_n, g_n);
+		clock_t start = clock();
+		a.set_union(b);
+		report("set_union", g_n, elapsed_ms(start));
+	}
+	{
+		ft::set<int> a, b;
+		make_sets(a, b, g_n, g_n);
+		clock_t start = clock();
+		for (ft::set<int>::iterator it = b.begin(); it != b.end(); ++it)
+			a.erase(*it);
+		report("difference by erase loop", g_n, elapsed_ms(start));
+	}
+	{
+		ft::set<int> a, b;
+		make_sets(a, b, g_n, g_n);
+		clock_t start = clock();
+		a.set_difference(b);
+		report("set_difference", g_n, elapsed_ms(start));
+	}
+	{
+		ft::set<int> a, b;
+		make_sets(a, b, g_n, g_n);
+		clock_t start = clock();
+		a.set_intersection(b);
+		report("set_intersection", g_n, elapsed_ms(start));
+	}
+	{
+		ft::set<int> a, b;
+		make_sets(a, b, g_n, g_n / 1000);
+		clock_t start = clock();
+		for (int i = 0; i < 1000; i++) {
+			ft::set<int> small(b);
+			a.set_union(small);
+		}
+		report("set_union of n/1000 into n (x1000)", 1000, elapsed_ms(start));
+	}
+	{
+		ft::set<int> a, b;
+		make_sets(a, b, g_n, 0);
+		clock_t start = clock();
+		ft::set<int>::iterator first = a.lower_bound(g_n / 2);
+		ft::set<int>::iterator last = a.lower_bound(g_n + g_n / 2);
+		while (first != last)
+			a.erase(first++);
+		report("erase loop half", g_n / 2, elapsed_ms(start));
+	}
+	{
+		ft::set<int> a, b;
+		make_sets(a, b, g_n, 0);
+		clock_t start = clock();
+		a.erase(a.lower_bound(g_n / 2), a.lower_bound(g_n + g_n / 2));
+		report("erase(first, last) half", g_n / 2, elapsed_ms(start));
+	}
+}
+
+
+/* 병렬 합집합, 교집합. thread 수를 1부터 코어 수(최소 4)까지 두 배씩 늘려가며 측정한다.
+ * clock()은 모든 thread의 CPU 시간을 더하므로 벽시계 시간(gettimeofday)으로 잰다.
+ * 앞선 측정에서 조각난 heap이 뒤의 측정을 느리게 하므로, 각 thread 수는 fork 한 자식 프로세스에서 잰다. */
+static double wall_ms() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+static void parallel_set_with(size_t threads) {
+	ft::task_pool pool(threads);
+	char what[64];
+	{
+		ft::set<int> a, b;
+		make_sets(a, b, g_n, g_n);
+		double start = wall_ms();
+		a.set_union(b, pool);
+		std::sprintf(what, "set_union, %lu threads", (unsigned long)threads);
+		report(what, g_n, wall_ms() - start);
+	}
+	{
+		ft::set<int> a, b;
+		make_sets(a, b, g_n, g_n);
+		double start = wall_ms();
+		a.set_intersection(b, pool);
+		std::sprintf(what, "set_intersection, %lu threads", (unsigned long)threads);
+		report(what, g_n, wall_ms() - start);
+	}
+}
+
+static void bench_parallel_set() {
+	std::cout << "=== parallel set algebra ===\n";
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	size_t max_threads = (cores > 4) ? cores : 4;
+	for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+		std::cout.flush();
+		pid_t pid = fork();
+		if (pid == 0) {
+			parallel_set_with(threads);
+			std::cout.flush();
+			_exit(0);
+		}
+		waitpid(pid, NULL, 0);
+	}
+	std::cout << "(" << cores << " cores online)\n";
+}
+
+/* 쓰는 중인 map의 읽기 전용 시점(point-in-time view)을 얻는 경우.
+ * ft::map은 복사 생성자로 전체를 복사해야 하고, persistent_map은 root를 공유하는 O(1) snapshot을 만든다.
+ * 대신 snapshot이 살아있는 동안의 insert는 경로를 복사한다. 매 update마다 snapshot을 뜨는 최악의 경우도 잰다. */
+static void bench_persistent() {
+	typedef ft::persistent_map<int, int>	pmap;
+
+	std::cout << "=== persistent map snapshots ===\n";
+	srand(42);
+	ft::vector<int> keys;
+	for (int i = 0; i < g_n; i++)
+		keys.push_back(rand());
+	long sum = 0;
+	int copies = 10;
+	{
+		ft::map<int, int> m;
+		clock_t start = clock();
+		for (int i = 0; i < g_n; i++)
+			m.insert_or_assign(keys[i], i);
+		report("map<int,int> random insert_or_assign", g_n, elapsed_ms(start));
+		start = clock();
+		for (int i = 0; i < g_n; i++)
+			sum += m.find(keys[i])->second;
+		report("map<int,int> find", g_n, elapsed_ms(start));
+		start = clock();
+		for (int i = 0; i < copies; i++) {
+			ft::map<int, int> view(m);
+			sum += view.size();
+		}
+		report("map<int,int> copy as a view", copies, elapsed_ms(start));
+	}
+	{
+		pmap m;
+		clock_t start = clock();
+		for (int i = 0; i < g_n; i++)
+			m.insert_or_assign(keys[i], i);
+		report("persistent_map random insert_or_assign", g_n, elapsed_ms(start));
+		start = clock();
+		for (int i = 0; i < g_n; i++)
+			sum += m.find(keys[i])->second;
+		report("persistent_map find", g_n, elapsed_ms(start));
+		start = clock();
+		for (int i = 0; i < g_n; i++) {
+			pmap view = m.snapshot();
+			sum += view.size();
+		}
+		report("persistent_map snapshot()", g_n, elapsed_ms(start));
+		pmap view;
+		start = clock();
+		for (int i = 0; i < g_n; i++) {
+			m.insert_or_assign(keys[i], -i);
+			view = m.snapshot();
+		}
+		report("insert_or_assign + snapshot() each", g_n, elapsed_ms(start));
+		sum += view.begin()->second;
+	}
+	g_sink = sum;
+}
+
+/* 여러 thread가 한 map을 읽고 쓰는 경우. mutex 하나로 감싼 ft::map과 shard마다 rwlock을 둔 concurrent_map 비교.
+ * 전체 연산 수(n)를 thread들이 나눠서 하고, 읽기 비율(90%, 50%)과 thread 수(1, 4, 16, 32)를 바꿔가며 벽시계 시간으로 잰다.
+ * 쓰기는 insert_or_assign과 erase를 반씩 해서 크기를 대략 유지한다. key는 n/10 개 범위에서 고른다. */
+class locked_map {
+	ft::map<int, int>	_map;
+	pthread_mutex_t		_lock;
+	public:
+		locked_map() { pthread_mutex_init(&_lock, NULL); }
+		~locked_map() { pthread_mutex_destroy(&_lock); }
+		bool	find(int k, int& out) {
+			pthread_mutex_lock(&_lock);
+			ft::map<int, int>::iterator it = _map.find(k);
+			bool found = (it != _map.end());
+			if (found)
+				out = it->second;
+			pthread_mutex_unlock(&_lock);
+			return found;
+		}
+		void	insert_or_assign(int k, int v) {
+			pthread_mutex_lock(&_lock);
+			_map.insert_or_assign(k, v);
+			pthread_mutex_unlock(&_lock);
+		}
+		void	erase(int k) {
+			pthread_mutex_lock(&_lock);
+			_map.erase(k);
+			pthread_mutex_unlock(&_lock);
+		}
+};
+
+template <typename Map>
+struct mixed_args {
+	Map*		map;
+	int			ops;
+	int			read_pct;
+	int			keys;
+	unsigned	seed;
+	long		hits;
+};
+
+template <typename Map>
+static void* mixed_worker(void* p) {
+	mixed_args<Map>* a = static_cast<mixed_args<Map>*>(p);
+	unsigned x = a->seed;
+	int v;
+	for (int i = 0; i < a->ops; i++) {
+		x ^= x << 13;			// xorshift32
+		x ^= x >> 17;
+		x ^= x << 5;
+		int k = (int)(x % (unsigned)a->keys);
+		if ((int)((x >> 8) % 100) < a->read_pct)
+			a->hits += a->map->find(k, v);
+		else if (x & 1)
+			a->map->insert_or_assign(k, i);
+		else
+			a->map->erase(k);
+	}
+	return NULL;
+}
+
+template <typename Map>
+static void mixed_run(const char* name, Map& m, int threads, int read_pct) {
+	int keys = g_n / 10 + 1;
+	for (int k = 0; k < keys; k += 2)
+		m.insert_or_assign(k, k);
+	ft::vector<pthread_t> tid(threads);
+	ft::vector<mixed_args<Map> > args(threads);
+	double start = wall_ms();
+	for (int t = 0; t < threads; t++) {
+		mixed_args<Map> a = { &m, g_n / threads, read_pct, keys, 2463534242u + t * 7919u, 0 };
+		args[t] = a;
+		pthread_create(&tid[t], NULL, &mixed_worker<Map>, &args[t]);
+	}
+	for (int t = 0; t < threads; t++)
+		pthread_join(tid[t], NULL);
+	char what[64];
+	std::sprintf(what, "%s %d%% read, %d threads", name, read_pct, threads);
+	report(what, g_n / threads * threads, wall_ms() - start);
+}
+
+static void bench_concurrent() {
+	std::cout << "=== concurrent map, mixed read / write ===\n";
+	static const int thread_counts[] = { 1, 4, 16, 32 };
+	static const int read_pcts[] = { 90, 50 };
+	for (int r = 0; r < 2; r++) {
+		for (int t = 0; t < 4; t++) {
+			locked_map lm;
+			mixed_run("mutex map", lm, thread_counts[t], read_pcts[r]);
+			ft::concurrent_map<int, int> cm;
+			mixed_run("concurrent_map", cm, thread_counts[t], read_pcts[r]);
+		}
+	}
+	std::cout << "(" << sysconf(_SC_NPROCESSORS_ONLN) << " cores online)\n";
+}
+
+/* 쓰기가 많은 경우 lock 없는 skiplist_map과 mutex로 감싼 ft::map 비교. 위의 mixed_run을 쓴다.
+ * skiplist_map의 원소는 바꿀 수 없으므로 쓰기는 insert(이미 있으면 그대로)와 erase다. */
+class skiplist_adapter {
+	ft::skiplist_map<int, int>	_map;
+	public:
+		bool	find(int k, int& out) {
+			ft::skiplist_map<int, int>::const_iterator it = _map.find(k);
+			if (it == _map.end())
+				return false;
+			out = it->second;
+			return true;
+		}
+		void	insert_or_assign(int k, int v)	{ _map.insert(ft::make_pair(k, v)); }
+		void	erase(int k)					{ _map.erase(k); }
+};
+
+static void bench_skiplist() {
+	std::cout << "=== lock-free skiplist_map, write heavy ===\n";
+	static const int thread_counts[] = { 1, 4, 16, 32 };
+	static const int read_pcts[] = { 50, 10 };
+	for (int r = 0; r < 2; r++) {
+		for (int t = 0; t < 4; t++) {
+			locked_map lm;
+			mixed_run("mutex map", lm, thread_counts[t], read_pcts[r]);
+			skiplist_adapter sl;
+			mixed_run("skiplist_map", sl, thread_counts[t], read_pcts[r]);
+		}
+	}
+	std::cout << "(" << sysconf(_SC_NPROCESSORS_ONLN) << " cores online)\n";
+}
+
+/* 큰 map에서 임의의 key를 찾는 경우. map은 find 한 번에 tree 높이(log2 n)만큼 node를 따라가며 거의 매번 cache miss가 나고,
+ * unordered_map은 control byte group 하나와 slot 하나만 본다. 있는 key와 없는 key를 반씩 찾는다. (기본 n = 1M, 10M)
+ * key는 띄엄띄엄(i * 2) 넣으므로 정수 hash가 값 그대로여도 hash_mix 없이는 한쪽으로 몰렸을 것이다. */
+static void bench_unordered() {
+	std::cout << "=== unordered_map find vs map find ===\n";
+	int sizes[] = { g_n, g_n * 10 };
+	for (int k = 0; k < 2; k++) {
+		int n = sizes[k];
+		int lookups = 2000000;
+		ft::vector<int> keys;
+		srand(7);
+		for (int i = 0; i < lookups; i++)
+			keys.push_back((int)(((long)rand() * RAND_MAX + rand()) % (2L * n)));
+		char what[64];
+		{
+			ft::map<int, int> m;
+			for (int i = 0; i < n; i++)
+				m.insert(m.end(), ft::make_pair(i * 2, i));
+			long long found = 0;
+			clock_t start = clock();
+			for (int i = 0; i < lookups; i++)
+				found += (m.find(keys[i]) != m.end());
+			std::sprintf(what, "map<int,int>(%d) find", n);
+			report(what, lookups, elapsed_ms(start));
+			g_sink = found;
+		}
+		{
+			ft::unordered_map<int, int> m;
+			clock_t start = clock();
+			for (int i = 0; i < n; i++)
+				m.insert(ft::make_pair(i * 2, i));
+			std::sprintf(what, "unordered_map<int,int>(%d) insert", n);
+			report(what, n, elapsed_ms(start));
+			long long found = 0;
+			start = clock();
+			for (int i = 0; i < lookups; i++)
+				found += (m.find(keys[i]) != m.end());
+			std::sprintf(what, "unordered_map<int,int>(%d) find", n);
+			report(what, lookups, elapsed_ms(start));
+			g_sink = found;
+		}
+	}
+}
+
+/* 한 번 만들고 계속 읽는 사전. 임의 순서의 원소를 한꺼번에 넣어 만든 뒤 find만 한다.
+ * flat_map은 insert(first, last)로 모아 정렬 한 번에 만들고, 찾을 때는 연속된 배열을 이분 탐색한다. */
+static void bench_flat() {
+	std::cout << "=== flat_map vs map, read mostly ===\n";
+	int sizes[] = { 1000, 100000, g_n };
+	for (int k = 0; k < 3; k++) {
+		int n = sizes[k];
+		ft::vector<ft::pair<int, int> > items;
+		srand(11);
+		for (int i = 0; i < n; i++)
+			items.push_back(ft::make_pair(rand() % (2 * n), i));
+		int lookups = 2000000;
+		ft::vector<int> keys;
+		for (int i = 0; i < lookups; i++)
+			keys.push_back(rand() % (2 * n));
+		char what[64];
+		{
+			clock_t start = clock();
+			ft::map<int, int> m;
+			m.insert(items.begin(), items.end());
+			std::sprintf(what, "map<int,int>(%d) insert(first, last)", n);
+			report(what, n, elapsed_ms(start));
+			long long found = 0;
+			start = clock();
+			for (int i = 0; i < lookups; i++)
+				found += (m.find(keys[i]) != m.end());
+			std::sprintf(what, "map<int,int>(%d) find", n);
+			report(what, lookups, elapsed_ms(start));
+			g_sink = found;
+		}
+		{
+			clock_t start = clock();
+			ft::flat_map<int, int> m;
+			m.insert(items.begin(), items.end());
+			std::sprintf(what, "flat_map<int,int>(%d) insert(first, last)", n);
+			report(what, n, elapsed_ms(start));
+			long long found = 0;
+			start = clock();
+			for (int i = 0; i < lookups; i++)
+				found += (m.find(keys[i]) != m.end());
+			std::sprintf(what, "flat_map<int,int>(%d) find", n);
+			report(what, lookups, elapsed_ms(start));
+			g_sink = found;
+		}
+	}
+}
+
+/* 할당한 byte 수를 세는 allocator. (malloc 자체의 머리 부분은 빠져 있다) */
+static size_t	g_alloc_bytes = 0;
+
+template <typename T>
+struct counting_allocator : public std::allocator<T> {
+	template <typename U> struct rebind { typedef counting_allocator<U> other; };
+	counting_allocator() { }
+	counting_allocator(const counting_allocator&) : std::allocator<T>() { }
+	template <typename U> counting_allocator(const counting_allocator<U>&) { }
+	T*		allocate(size_t n, const void* = 0) {
+		g_alloc_bytes += n * sizeof(T);
+		return std::allocator<T>::allocate(n);
+	}
+	void	deallocate(T* p, size_t n) {
+		g_alloc_bytes -= n * sizeof(T);
+		std::allocator<T>::deallocate(p, n);
+	}
+};
+
+/* 같은 random key를 넣고 찾는다. btree_map은 node 하나에 key가 수십 개라 find가 node 몇 개만 읽는다. byte/elem은 원소당 할당량 */
+template <typename Map>
+static void btree_round(const char* name, const ft::vector<ft::pair<int, int> >& items, const ft::vector<int>& keys) {
+	char what[64];
+	int n = items.size();
+	size_t before = g_alloc_bytes;
+	clock_t start = clock();
+	Map m;
+	for (int i = 0; i < n; i++)
+		m.insert(items[i]);
+	std::sprintf(what, "%s(%d) insert", name, n);
+	report(what, n, elapsed_ms(start));
+	std::cout << "    " << std::setprecision(1) << (double)(g_alloc_bytes - before) / m.size() << " byte/elem\n";
+	long long found = 0;
+	start = clock();
+	for (size_t i = 0; i < keys.size(); i++)
+		found += (m.find(keys[i]) != m.end());
+	std::sprintf(what, "%s(%d) find", name, n);
+	report(what, keys.size(), elapsed_ms(start));
+	g_sink = found;
+	start = clock();
+	for (int i = 0; i < n; i += 2)
+		m.erase(items[i].first);
+	std::sprintf(what, "%s(%d) erase half", name, n);
+	report(what, n / 2, elapsed_ms(start));
+}
+
+static void bench_btree() {
+	typedef ft::map<int, int, std::less<int>, counting_allocator<ft::pair<const int, int> > >			rb_map;
+	typedef ft::btree_map<int, int, std::less<int>, counting_allocator<ft::pair<const int, int> > >	b_map;
+	std::cout << "=== btree_map vs map ===\n";
+	int sizes[] = { 1000, 100000, g_n };
+	for (int k = 0; k < 3; k++) {
+		int n = sizes[k];
+		ft::vector<ft::pair<int, int> > items;
+		srand(13);
+		for (int i = 0; i < n; i++)
+			items.push_back(ft::make_pair(rand() % (2 * n), i));
+		ft::vector<int> keys;
+		for (int i = 0; i < 2000000; i++)
+			keys.push_back(rand() % (2 * n));
+		btree_round<rb_map>("map<int,int>", items, keys);
+		btree_round<b_map>("btree_map<int,int>", items, keys);
+	}
+	// 정렬된 입력은 leaf를 꽉 채워 한 번에 쌓는다.
+	ft::vector<ft::pair<int, int> > sorted;
+	for (int i = 0; i < g_n; i++)
+		sorted.push_back(ft::make_pair(i, i));
+	size_t before = g_alloc_bytes;
+	clock_t start = clock();
+	b_map m(sorted.begin(), sorted.end());
+	report("btree_map<int,int> bulk load", g_n, elapsed_ms(start));
+	std::cout << "    " << std::setprecision(1) << (double)(g_alloc_bytes - before) / m.size() << " byte/elem\n";
+}
+
+/* 작은 key를 많이 담는 set. node마다 포인터 3개인 set과 32 bit index로 잇는 compact_set을 비교한다.
+ * 넣는 동안 늘어난 resident 메모리, find, 복사(compact_set은 arena memcpy)를 잰다. 각각 fork 한 자식 프로세스에서 잰다. */
+template <typename Set>
+static void compact_round(const char* name, int n) {
+	char what[64];
+	size_t before = resident_bytes();
+	Set* s = new Set;
+	srand(5);
+	clock_t start = clock();
+	for (int i = 0; i < n; i++)
+		s->insert(rand());
+	std::sprintf(what, "%s(%d) insert", name, n);
+	report(what, n, elapsed_ms(start));
+	std::cout << "    " << std::setprecision(1) << (double)(resident_bytes() - before) / s->size() << " byte/elem resident\n";
+	long long found = 0;
+	start = clock();
+	for (int i = 0; i < 2000000; i++)
+		found += s->count(rand());
+	std::sprintf(what, "%s(%d) find", name, n);
+	report(what, 2000000, elapsed_ms(start));
+	start = clock();
+	Set* copy = new Set(*s);
+	std::sprintf(what, "%s(%d) copy", name, n);
+	report(what, n, elapsed_ms(start));
+	g_sink = found;
+	delete copy;
+	delete s;
+}
+
+static void bench_compact() {
+	std::cout << "=== compact_set vs set, small keys ===\n";
+	for (int k = 0; k < 3; k++) {
+		std::cout.flush();
+		pid_t pid = fork();
+		if (pid == 0) {
+			if (k == 0)
+				compact_round< ft::set<int> >("set<int>", g_n);
+			else if (k == 1)
+				compact_round< ft::set<int, std::less<int>, ft::pool_allocator<int> > >("set<int> pool", g_n);
+			else
+				compact_round< ft::compact_set<int> >("compact_set<int>", g_n);
+			std::cout.flush();
+			_exit(0);
+		}
+		waitpid(pid, NULL, 0);
+	}
+}
+
+/* key 64개, 256개를 한 번에 찾는 요청. find()를 차례로 부르는 것과 find_many()를 비교한다.
+ * tree가 LLC(이 기계는 105 MiB)보다 훨씬 커야 node마다 cache miss가 난다. g_n * 4개면 set<int>가 200 MB쯤 된다. */
+static void bench_find_many() {
+	std::cout << "=== set<int> find loop vs find_many ===\n";
+	int sizes[] = { 100000, g_n * 4 };
+	for (int k = 0; k < 2; k++) {
+		int n = sizes[k];
+		ft::set<int> s;
+		srand(17);
+		for (int i = 0; i < n; i++)
+			s.insert(rand() % (2 * n));
+		ft::vector<int> keys;
+		for (int i = 0; i < 2000000; i++)
+			keys.push_back(rand() % (2 * n));
+		int batches[] = { 64, 256 };
+		for (int b = 0; b < 2; b++) {
+			int batch = batches[b];
+			ft::vector<ft::set<int>::iterator> out(batch);
+			char what[64];
+			long long found = 0;
+			clock_t start = clock();
+			for (size_t i = 0; i + batch <= keys.size(); i += batch)
+				for (int j = 0; j < batch; j++)
+					found += (s.find(keys[i + j]) != s.end());
+			std::sprintf(what, "set<int>(%d) find x%d", n, batch);
+			report(what, keys.size(), elapsed_ms(start));
+			start = clock();
+			for (size_t i = 0; i + batch <= keys.size(); i += batch) {
+				s.find_many(keys.begin() + i, keys.begin() + i + batch, out.begin());
+				for (int j = 0; j < batch; j++)
+					found -= (out[j] != s.end());
+			}
+			std::sprintf(what, "set<int>(%d) find_many x%d", n, batch);
+			report(what, keys.size(), elapsed_ms(start));
+			if (found != 0)
+				std::cout << "    find_many disagrees with find\n";
+		}
+	}
+}
+
+/* map 전체를 key 순서로 읽기. ++it는 parent를 타고 올라가지만 scan()은 stack으로 돌면서 다음 subtree를 prefetch 한다. */
+struct sum_mapped {
+	long long sum;
+	sum_mapped() : sum(0) { }
+	void operator()(const ft::pair<const int, int>& v) { sum += v.second; }
+};
+
+template <typename Map>
+static void scan_round(const char* name, int n) {
+	Map m;
+	srand(19);
+	for (int i = 0; i < n; i++)
+		m.insert(ft::make_pair(rand(), i));
+	char what[64];
+	long long sum = 0;
+	clock_t start = clock();
+	for (int r = 0; r < 5; r++)
+		for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it)
+			sum += it->second;
+	std::sprintf(what, "%s(%d) ++it", name, n);
+	report(what, 5 * m.size(), elapsed_ms(start));
+	start = clock();
+	for (int r = 0; r < 5; r++)
+		sum -= m.scan(sum_mapped()).sum;
+	std::sprintf(what, "%s(%d) scan", name, n);
+	report(what, 5 * m.size(), elapsed_ms(start));
+	if (sum != 0)
+		std::cout << "    scan disagrees with ++it\n";
+}
+
+static void bench_scan() {
+	std::cout << "=== map<int,int> full scan: ++it vs scan() ===\n";
+	scan_round< ft::map<int, int> >("map<int,int>", 100000);
+	scan_round< ft::map<int, int> >("map<int,int>", g_n * 4);
+	scan_round< ft::map<int, int, std::less<int>, ft::pool_allocator<ft::pair<const int, int> > > >("map<int,int> pool", g_n * 4);
+}
+
+/* 한 번 만들고 찾기만 하는 int 표. set(RB_Tree)의 find와 정렬된 배열들을 비교한다.
+ * int_less는 std::less와 같지만 다른 타입이라 static_set이 SSE2 대신 보통 비교로 node를 센다. */
+struct int_less {
+	bool operator()(int a, int b) const { return a < b; }
+};
+
+template <typename Set>
+static void static_round(const char* name, const Set& s, const ft::vector<int>& keys) {
+	long long found = 0;
+	clock_t start = clock();
+	for (size_t i = 0; i < keys.size(); i++)
+		found += s.count(keys[i]);
+	char what[64];
+	std::sprintf(what, "%s(%d) find", name, (int)s.size());
+	report(what, keys.size(), elapsed_ms(start));
+	g_sink = found;
+}
+
+static void bench_static() {
+	std::cout << "=== static_set vs set, flat_set, btree_set ===\n";
+	int sizes[] = { 100000, g_n * 4 };
+	for (int k = 0; k < 2; k++) {
+		int n = sizes[k];
+		ft::set<int> s;
+		srand(23);
+		for (int i = 0; i < n; i++)
+			s.insert(rand() % (2 * n));
+		ft::vector<int> keys;
+		for (int i = 0; i < 2000000; i++)
+			keys.push_back(rand() % (2 * n));
+		static_round("set<int>", s, keys);
+		{
+			ft::flat_set<int> f(s.begin(), s.end());
+			static_round("flat_set<int>", f, keys);
+		}
+		{
+			ft::btree_set<int> b(s.begin(), s.end());
+			static_round("btree_set<int>", b, keys);
+		}
+		{
+			ft::static_set<int, int_less> t(ft::sorted_unique, s.begin(), s.end());
+			static_round("static_set<int> scalar", t, keys);
+		}
+		char what[64];
+		clock_t start = clock();
+		ft::static_set<int> t(ft::sorted_unique, s.begin(), s.end());
+		std::sprintf(what, "static_set<int>(%d) build from set", (int)t.size());
+		report(what, t.size(), elapsed_ms(start));
+		static_round("static_set<int>", t, keys);
+	}
+}
+
+int main(int argc, char** argv) {
+	if (argc > 1)
+		g_only = argv[1];
+	if (argc > 2)
+		g_n = std::atoi(argv[2]);
+
+	if (selected("sorted_insert"))
+		bench_sorted_insert();
+	if (selected("vector_relocate"))
+		bench_vector_relocate();
+	if (selected("node_alloc"))
+		bench_node_alloc();
+	if (selected("find"))
+		bench_find();
+	if (selected("counter"))
+		bench_counter();
+	if (selected("bulk_build"))
+		bench_bulk_build();
+	if (selected("hint_insert"))
+		bench_hint_insert();
+	if (selected("minmax"))
+		bench_minmax();
+	if (selected("order_stat"))
+		bench_order_stat();
+	if (selected("aggregate"))
+		bench_aggregate();
+	if (selected("set_algebra"))
+		bench_set_algebra();
+	if (selected("parallel_set"))
+		bench_parallel_set();
+	if (selected("persistent"))
+		bench_persistent();
+	if (selected("concurrent"))
+		bench_concurrent();
+	if (selected("skiplist"))
+		bench_skiplist();
+	if (selected("unordered"))
+		bench_unordered();
+	if (selected("flat"))
+		bench_flat();
+	if (selected("btree"))
+		bench_btree();
+	if (selected("compact"))
+		bench_compact();
+	if (selected("find_many"))
+		bench_find_many();
+	if (selected("scan"))
+		bench_scan();
+	if (selected("static"))
+		bench_static();
+}
@@ -0,0 +1,235 @@
+#ifndef BTREE_MAP_HPP
+# define BTREE_MAP_HPP
+
+# include <functional> // less
+# include <memory> // allocator
+# include <limits> // numeric_limits, max
+# include <stdexcept> // out_of_range
+# include <cstddef> // ptrdiff_t
+# include <iterator> // iterator tags, distance
+# include "utils/pair.hpp"
+# include "utils/btree.hpp"
+# include "utils/tree_interface.hpp" // sorted_unique_t
+# include "utils/reverse_iterator.hpp"
+# include "utils/iterators_traits.hpp"
+# include "utils/key_of_value.hpp"
+
+namespace ft {
+
+/* An ordered map over a B+ tree whose nodes fit in 256 bytes (see utils/btree.hpp), with the interface of ft::map.
+ * A node holds tens of elements, so a lookup reads a handful of nodes instead of one node per level of a red-black tree,
+ * searching each one without branches, and there are no per-element pointers.
+ * Elements move between slots and nodes as the tree changes: insert and erase invalidate every iterator. */
+template <typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<ft::pair<const Key,T> > >
+class btree_map {
+	public:
+		typedef Key										key_type;
+		typedef T										mapped_type;
+		typedef ft::pair<const Key, T>					value_type;
+		typedef Compare									key_compare;
+		class	value_compare {
+			friend class btree_map<Key, T, Compare, Alloc>;
+			protected:
+				Compare comp;
+				value_compare (Compare c) : comp(c) { }
+			public:
+				bool operator() (const value_type& x, const value_type& y) const {
+					return (comp(x.first, y.first));
+				}
+		};
+		typedef Alloc									allocator_type;
+		typedef typename Alloc::reference				reference;
+		typedef typename Alloc::const_reference			const_reference;
+		typedef typename Alloc::pointer					pointer;
+		typedef typename Alloc::const_pointer			const_pointer;
+		typedef btree_iterator<value_type>				iterator;
+		typedef btree_const_iterator<value_type>		const_iterator;
+		typedef ft::reverse_iterator<iterator>			reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+		typedef ptrdiff_t								difference_type;
+		typedef size_t									size_type;
+
+	private:
+		typedef BTree<key_type, value_type, ft::select1st<value_type>, key_compare, Alloc>	tree_type;
+
+		tree_type _tree;
+		key_compare _comp;
+		allocator_type _alloc;
+
+	public:
+		// default Ctor
+		btree_map(const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _tree(comp, alloc), _comp(comp), _alloc(alloc) { }
+
+		// range Ctor
+		// sorted input (checked in one pass when the iterators allow it) is bulk-loaded in O(n) with full leaves.
+		template<typename InputIterator>
+		btree_map(InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _tree(comp, alloc), _comp(comp), _alloc(alloc) {
+				_range_init(first, last, typename ft::iterator_traits<InputIterator>::iterator_category());
+		}
+
+		// sorted range Ctor : [first, last) must be sorted by key with no duplicates. O(n).
+		template<typename ForwardIterator>
+		btree_map(ft::sorted_unique_t, ForwardIterator first, ForwardIterator last,
+			const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _tree(comp, alloc), _comp(comp), _alloc(alloc) {
+				_tree.build_sorted(first, last, std::distance(first, last));
+		}
+
+		// copy Ctor : bulk-loaded from other in order, O(n).
+		btree_map(const btree_map& other) : _tree(other._tree), _comp(other._comp), _alloc(other._alloc) { }
+
+		btree_map& operator=(const btree_map& rhs) {
+			btree_map tmp(rhs);
+			swap(tmp);
+			return *this;
+		}
+
+		~btree_map() { }
+
+		// Iterators
+		iterator		begin()			{ return _tree.begin(); }
+		const_iterator	begin() const	{ return _tree.begin(); }
+		iterator		end()			{ return _tree.end(); }
+		const_iterator	end() const		{ return _tree.end(); }
+
+		reverse_iterator		rbegin()		{ return reverse_iterator(end()); }
+		const_reverse_iterator	rbegin() const	{ return const_reverse_iterator(end()); }
+		reverse_iterator		rend()			{ return reverse_iterator(begin()); }
+		const_reverse_iterator	rend() const	{ return const_reverse_iterator(begin()); }
+
+		// Capacity
+		bool		empty()		const { return (_tree.getSize() == 0); }
+		size_type	size()		const { return _tree.getSize(); }
+		size_type	max_size()	const { return std::numeric_limits<difference_type>::max() / sizeof(T); }
+
+		// if k matches the key, returns a reference to its mapped value.
+		// if not, inserts a new element with that key and returns a reference to its mapped value.
+		mapped_type& operator[](const key_type& k) {
+			typename tree_type::position pos = _tree.locate(k);
+			if (pos.found)
+				return pos.node->slots()[pos.index].second;
+			return _tree.insert_at(pos, value_type(k, mapped_type()))->second;
+		}
+
+		mapped_type&		at(const key_type& k) {
+			iterator it = find(k);
+			if (it == end())
+				throw std::out_of_range("btree_map::at");
+			return it->second;
+		}
+		const mapped_type&	at(const key_type& k) const {
+			const_iterator it = find(k);
+			if (it == end())
+				throw std::out_of_range("btree_map::at");
+			return it->second;
+		}
+
+		// if k is not present, inserts (k, obj). if it is, does nothing (obj is not used).
+		ft::pair<iterator,bool>	try_emplace(const key_type& k, const mapped_type& obj) {
+			typename tree_type::position pos = _tree.locate(k);
+			if (pos.found)
+				return ft::make_pair(iterator(pos.node, pos.index), false);
+			return ft::make_pair(_tree.insert_at(pos, value_type(k, obj)), true);
+		}
+
+		// if k is not present, inserts (k, obj). if it is, assigns obj to its mapped value.
+		// second of the result is true if a new element was inserted.
+		ft::pair<iterator,bool>	insert_or_assign(const key_type& k, const mapped_type& obj) {
+			typename tree_type::position pos = _tree.locate(k);
+			if (pos.found) {
+				pos.node->slots()[pos.index].second = obj;
+				return ft::make_pair(iterator(pos.node, pos.index), false);
+			}
+			return ft::make_pair(_tree.insert_at(pos, value_type(k, obj)), true);
+		}
+
+		// insert single element
+		ft::pair<iterator,bool>	insert(const value_type& val) {
+			return _tree.insert(val);
+		}
+
+		// insert with hint : the hint is not used, a descent is only a few nodes.
+		iterator				insert(iterator position, const value_type& val) {
+			(void)position;
+			return _tree.insert(val).first;
+		}
+
+		// insert range
+		template <class InputIterator>
+		void					insert(InputIterator first, InputIterator last) {
+			while (first != last)
+				_tree.insert(*first++);
+		}
+
+		void		erase(iterator position) {
+			_tree.erase(position);
+		}
+
+		size_type	erase(const key_type& k) {
+			return _tree.erase(k);
+		}
+
+		void		erase(iterator first, iterator last) {
+			_tree.erase(first, last);
+		}
+
+		void		swap(btree_map& x) {
+			_tree.swap(x._tree);
+			std::swap(_comp, x._comp);
+			std::swap(_alloc, x._alloc);
+		}
+
+		void		clear() {
+			_tree.clear();
+		}
+
+		key_compare		key_comp() const	{ return _comp; }
+		value_compare	value_comp() const	{ return value_compare(_comp); }
+
+		iterator 		find(const key_type& k)			{ return _tree.find(k); }
+		const_iterator	find(const key_type& k) const	{ return _tree.find(k); }
+
+		size_type		count(const key_type& k) const	{ return _tree.contains(k) ? 1 : 0; }
+
+		iterator		lower_bound(const key_type& k)			{ return _tree.lower_bound(k); }
+		const_iterator	lower_bound(const key_type& k) const	{ return _tree.lower_bound(k); }
+
+		iterator		upper_bound(const key_type& k)			{ return _tree.upper_bound(k); }
+		const_iterator	upper_bound(const key_type& k) const	{ return _tree.upper_bound(k); }
+
+		ft::pair<iterator,iterator>				equal_range(const key_type& k) {
+			iterator first = lower_bound(k);
+			iterator last = first;
+			if (last != end() && !_comp(k, last->first))
+				++last;
+			return ft::make_pair(first, last);
+		}
+		ft::pair<const_iterator,const_iterator>	equal_range(const key_type& k) const {
+			const_iterator first = lower_bound(k);
+			const_iterator last = first;
+			if (last != end() && !_comp(k, last->first))
+				++last;
+			return ft::make_pair(first, last);
+		}
+
+		allocator_type	get_allocator() const { return _alloc; }
+
+	private:
+		template <typename InputIterator>
+		void	_range_init(InputIterator first, InputIterator last, std::input_iterator_tag) {
+			while (first != last)
+				_tree.insert(*first++);
+		}
+
+		template <typename ForwardIterator>
+		void	_range_init(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag) {
+			if (!_tree.build_if_sorted(first, last))
+				_range_init(first, last, std::input_iterator_tag());
+		}
+};
+
+
+}
+#endif
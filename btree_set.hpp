@@ -0,0 +1,168 @@
+#ifndef BTREE_SET_HPP
+# define BTREE_SET_HPP
+
+# include <functional> // less
+# include <memory> // allocator
+# include <limits> // numeric_limits, max
+# include <cstddef> // ptrdiff_t
+# include <iterator> // iterator tags, distance
+# include "utils/pair.hpp"
+# include "utils/btree.hpp"
+# include "utils/tree_interface.hpp" // sorted_unique_t
+# include "utils/reverse_iterator.hpp"
+# include "utils/iterators_traits.hpp"
+# include "utils/key_of_value.hpp"
+
+namespace ft {
+
+/* An ordered set over the same cache-line-sized B+ tree as ft::btree_map, with the interface of ft::set.
+ * Elements cannot be modified in place, so iterator and const_iterator are both const.
+ * insert and erase invalidate every iterator. */
+template <typename T, typename Compare = std::less<T>, typename Alloc = std::allocator<T> >
+class btree_set {
+	public:
+		typedef T										key_type;
+		typedef T										value_type;
+		typedef Compare									key_compare;
+		typedef Compare									value_compare;
+		typedef Alloc									allocator_type;
+		typedef typename Alloc::reference				reference;
+		typedef typename Alloc::const_reference			const_reference;
+		typedef typename Alloc::pointer					pointer;
+		typedef typename Alloc::const_pointer			const_pointer;
+		typedef btree_const_iterator<value_type>		iterator;
+		typedef btree_const_iterator<value_type>		const_iterator;
+		typedef ft::reverse_iterator<iterator>			reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+		typedef ptrdiff_t								difference_type;
+		typedef size_t									size_type;
+
+	private:
+		typedef BTree<key_type, value_type, ft::identity<value_type>, key_compare, Alloc>	tree_type;
+
+		tree_type _tree;
+		key_compare _comp;
+		allocator_type _alloc;
+
+	public:
+		// default Ctor
+		btree_set(const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _tree(comp, alloc), _comp(comp), _alloc(alloc) { }
+
+		// range Ctor
+		// sorted input (checked in one pass when the iterators allow it) is bulk-loaded in O(n) with full leaves.
+		template<typename InputIterator>
+		btree_set(InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _tree(comp, alloc), _comp(comp), _alloc(alloc) {
+				_range_init(first, last, typename ft::iterator_traits<InputIterator>::iterator_category());
+		}
+
+		// sorted range Ctor : [first, last) must be sorted with no duplicates. O(n).
+		template<typename ForwardIterator>
+		btree_set(ft::sorted_unique_t, ForwardIterator first, ForwardIterator last,
+			const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _tree(comp, alloc), _comp(comp), _alloc(alloc) {
+				_tree.build_sorted(first, last, std::distance(first, last));
+		}
+
+		// copy Ctor : bulk-loaded from other in order, O(n).
+		btree_set(const btree_set& other) : _tree(other._tree), _comp(other._comp), _alloc(other._alloc) { }
+
+		btree_set& operator=(const btree_set& rhs) {
+			btree_set tmp(rhs);
+			swap(tmp);
+			return *this;
+		}
+
+		~btree_set() { }
+
+		// Iterators
+		const_iterator	begin() const	{ return _tree.begin(); }
+		const_iterator	end() const		{ return _tree.end(); }
+
+		const_reverse_iterator	rbegin() const	{ return const_reverse_iterator(end()); }
+		const_reverse_iterator	rend() const	{ return const_reverse_iterator(begin()); }
+
+		// Capacity
+		bool		empty()		const { return (_tree.getSize() == 0); }
+		size_type	size()		const { return _tree.getSize(); }
+		size_type	max_size()	const { return std::numeric_limits<difference_type>::max() / sizeof(T); }
+
+		// insert single element
+		ft::pair<iterator,bool>	insert(const value_type& val) {
+			ft::pair<typename tree_type::iterator, bool> ret = _tree.insert(val);
+			return ft::make_pair(iterator(ret.first), ret.second);
+		}
+
+		// insert with hint : the hint is not used, a descent is only a few nodes.
+		iterator				insert(const_iterator position, const value_type& val) {
+			(void)position;
+			return _tree.insert(val).first;
+		}
+
+		// insert range
+		template <class InputIterator>
+		void					insert(InputIterator first, InputIterator last) {
+			while (first != last)
+				_tree.insert(*first++);
+		}
+
+		void		erase(const_iterator position) {
+			_tree.erase(position);
+		}
+
+		size_type	erase(const key_type& k) {
+			return _tree.erase(k);
+		}
+
+		void		erase(const_iterator first, const_iterator last) {
+			_tree.erase(first, last);
+		}
+
+		void		swap(btree_set& x) {
+			_tree.swap(x._tree);
+			std::swap(_comp, x._comp);
+			std::swap(_alloc, x._alloc);
+		}
+
+		void		clear() {
+			_tree.clear();
+		}
+
+		key_compare		key_comp() const	{ return _comp; }
+		value_compare	value_comp() const	{ return _comp; }
+
+		const_iterator	find(const key_type& k) const	{ return _tree.find(k); }
+
+		size_type		count(const key_type& k) const	{ return _tree.contains(k) ? 1 : 0; }
+
+		const_iterator	lower_bound(const key_type& k) const	{ return _tree.lower_bound(k); }
+		const_iterator	upper_bound(const key_type& k) const	{ return _tree.upper_bound(k); }
+
+		ft::pair<const_iterator,const_iterator>	equal_range(const key_type& k) const {
+			const_iterator first = lower_bound(k);
+			const_iterator last = first;
+			if (last != end() && !_comp(k, *last))
+				++last;
+			return ft::make_pair(first, last);
+		}
+
+		allocator_type	get_allocator() const { return _alloc; }
+
+	private:
+		template <typename InputIterator>
+		void	_range_init(InputIterator first, InputIterator last, std::input_iterator_tag) {
+			while (first != last)
+				_tree.insert(*first++);
+		}
+
+		template <typename ForwardIterator>
+		void	_range_init(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag) {
+			if (!_tree.build_if_sorted(first, last))
+				_range_init(first, last, std::input_iterator_tag());
+		}
+};
+
+
+}
+#endif
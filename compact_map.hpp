@@ -0,0 +1,240 @@
+#ifndef COMPACT_MAP_HPP
+# define COMPACT_MAP_HPP
+
+# include <functional> // less
+# include <memory> // allocator
+# include <stdexcept> // out_of_range
+# include <cstddef> // ptrdiff_t
+# include <iterator> // iterator tags, distance
+# include "utils/pair.hpp"
+# include "utils/compact_tree.hpp"
+# include "utils/tree_interface.hpp" // sorted_unique_t
+# include "utils/reverse_iterator.hpp"
+# include "utils/iterators_traits.hpp"
+# include "utils/key_of_value.hpp"
+
+namespace ft {
+
+/* An ordered map with the interface of ft::map, over a red-black tree whose nodes live in one ft::vector
+ * and link to each other by 32-bit index (see utils/compact_tree.hpp). A node carries 12 bytes of links instead of 24 + padding,
+ * with no per-node malloc, and copying the map copies that one vector.
+ * Iterators stay valid across insert and erase of other elements, as with ft::map, but swap invalidates them.
+ * At most 2^31 - 1 elements. */
+template <typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<ft::pair<const Key,T> > >
+class compact_map {
+	public:
+		typedef Key										key_type;
+		typedef T										mapped_type;
+		typedef ft::pair<const Key, T>					value_type;
+		typedef Compare									key_compare;
+		class	value_compare {
+			friend class compact_map<Key, T, Compare, Alloc>;
+			protected:
+				Compare comp;
+				value_compare (Compare c) : comp(c) { }
+			public:
+				bool operator() (const value_type& x, const value_type& y) const {
+					return (comp(x.first, y.first));
+				}
+		};
+		typedef Alloc									allocator_type;
+		typedef typename Alloc::reference				reference;
+		typedef typename Alloc::const_reference			const_reference;
+		typedef typename Alloc::pointer					pointer;
+		typedef typename Alloc::const_pointer			const_pointer;
+
+	private:
+		typedef CompactTree<key_type, value_type, ft::select1st<value_type>, key_compare, Alloc>	tree_type;
+
+	public:
+		typedef typename tree_type::iterator			iterator;
+		typedef typename tree_type::const_iterator		const_iterator;
+		typedef ft::reverse_iterator<iterator>			reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+		typedef ptrdiff_t								difference_type;
+		typedef size_t									size_type;
+
+	private:
+		tree_type _tree;
+		key_compare _comp;
+		allocator_type _alloc;
+
+	public:
+		// default Ctor
+		compact_map(const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _tree(comp, alloc), _comp(comp), _alloc(alloc) { }
+
+		// range Ctor
+		// sorted input (checked in one pass when the iterators allow it) is built in O(n) instead of n inserts.
+		template<typename InputIterator>
+		compact_map(InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _tree(comp, alloc), _comp(comp), _alloc(alloc) {
+				_range_init(first, last, typename ft::iterator_traits<InputIterator>::iterator_category());
+		}
+
+		// sorted range Ctor : [first, last) must be sorted by key with no duplicates. O(n).
+		template<typename ForwardIterator>
+		compact_map(ft::sorted_unique_t, ForwardIterator first, ForwardIterator last,
+			const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _tree(comp, alloc), _comp(comp), _alloc(alloc) {
+				_tree.build_sorted(first, last, std::distance(first, last));
+		}
+
+		// copy Ctor : copies the node arena as it is (one memcpy for trivially relocatable elements).
+		compact_map(const compact_map& other) : _tree(other._tree), _comp(other._comp), _alloc(other._alloc) { }
+
+		compact_map& operator=(const compact_map& rhs) {
+			compact_map tmp(rhs);
+			swap(tmp);
+			return *this;
+		}
+
+		~compact_map() { }
+
+		// Iterators
+		iterator		begin()			{ return _tree.begin(); }
+		const_iterator	begin() const	{ return _tree.begin(); }
+		iterator		end()			{ return _tree.end(); }
+		const_iterator	end() const		{ return _tree.end(); }
+
+		reverse_iterator		rbegin()		{ return reverse_iterator(end()); }
+		const_reverse_iterator	rbegin() const	{ return const_reverse_iterator(end()); }
+		reverse_iterator		rend()			{ return reverse_iterator(begin()); }
+		const_reverse_iterator	rend() const	{ return const_reverse_iterator(begin()); }
+
+		// Capacity
+		bool		empty()		const { return (_tree.getSize() == 0); }
+		size_type	size()		const { return _tree.getSize(); }
+		size_type	max_size()	const { return _tree.max_size(); }
+		// nodes the arena holds without reallocating
+		size_type	capacity()	const { return _tree.capacity(); }
+		void		reserve(size_type n) { _tree.reserve(n); }
+
+		// if k matches the key, returns a reference to its mapped value.
+		// if not, inserts a new element with that key and returns a reference to its mapped value.
+		mapped_type& operator[](const key_type& k) {
+			typename tree_type::position pos = _tree.locate(k);
+			if (pos.found != compact_nil)
+				return _tree.value_at(pos.found).second;
+			return _tree.insert_at(pos, value_type(k, mapped_type()))->second;
+		}
+
+		mapped_type&		at(const key_type& k) {
+			iterator it = find(k);
+			if (it == end())
+				throw std::out_of_range("compact_map::at");
+			return it->second;
+		}
+		const mapped_type&	at(const key_type& k) const {
+			const_iterator it = find(k);
+			if (it == end())
+				throw std::out_of_range("compact_map::at");
+			return it->second;
+		}
+
+		// if k is not present, inserts (k, obj). if it is, does nothing (obj is not used).
+		ft::pair<iterator,bool>	try_emplace(const key_type& k, const mapped_type& obj) {
+			typename tree_type::position pos = _tree.locate(k);
+			if (pos.found != compact_nil)
+				return ft::make_pair(iterator(&_tree, pos.found), false);
+			return ft::make_pair(_tree.insert_at(pos, value_type(k, obj)), true);
+		}
+
+		// if k is not present, inserts (k, obj). if it is, assigns obj to its mapped value.
+		// second of the result is true if a new element was inserted.
+		ft::pair<iterator,bool>	insert_or_assign(const key_type& k, const mapped_type& obj) {
+			typename tree_type::position pos = _tree.locate(k);
+			if (pos.found != compact_nil) {
+				_tree.value_at(pos.found).second = obj;
+				return ft::make_pair(iterator(&_tree, pos.found), false);
+			}
+			return ft::make_pair(_tree.insert_at(pos, value_type(k, obj)), true);
+		}
+
+		// insert single element
+		ft::pair<iterator,bool>	insert(const value_type& val) {
+			return _tree.insert(val);
+		}
+
+		// insert with hint : only end() is used, to append a value greater than every key without descending.
+		iterator				insert(iterator position, const value_type& val) {
+			return _tree.insert(position, val);
+		}
+
+		// insert range
+		template <class InputIterator>
+		void					insert(InputIterator first, InputIterator last) {
+			while (first != last)
+				_tree.insert(end(), *first++);
+		}
+
+		void		erase(iterator position) {
+			_tree.erase(position);
+		}
+
+		size_type	erase(const key_type& k) {
+			return _tree.erase(k);
+		}
+
+		void		erase(iterator first, iterator last) {
+			_tree.erase(first, last);
+		}
+
+		void		swap(compact_map& x) {
+			_tree.swap(x._tree);
+			std::swap(_comp, x._comp);
+			std::swap(_alloc, x._alloc);
+		}
+
+		void		clear() {
+			_tree.clear();
+		}
+
+		key_compare		key_comp() const	{ return _comp; }
+		value_compare	value_comp() const	{ return value_compare(_comp); }
+
+		iterator 		find(const key_type& k)			{ return _tree.find(k); }
+		const_iterator	find(const key_type& k) const	{ return _tree.find(k); }
+
+		size_type		count(const key_type& k) const	{ return (_tree.locate(k).found != compact_nil) ? 1 : 0; }
+
+		iterator		lower_bound(const key_type& k)			{ return iterator(&_tree, _tree.lower_bound(k)); }
+		const_iterator	lower_bound(const key_type& k) const	{ return const_iterator(&_tree, _tree.lower_bound(k)); }
+
+		iterator		upper_bound(const key_type& k)			{ return iterator(&_tree, _tree.upper_bound(k)); }
+		const_iterator	upper_bound(const key_type& k) const	{ return const_iterator(&_tree, _tree.upper_bound(k)); }
+
+		ft::pair<iterator,iterator>				equal_range(const key_type& k) {
+			iterator first = lower_bound(k);
+			iterator last = first;
+			if (last != end() && !_comp(k, last->first))
+				++last;
+			return ft::make_pair(first, last);
+		}
+		ft::pair<const_iterator,const_iterator>	equal_range(const key_type& k) const {
+			const_iterator first = lower_bound(k);
+			const_iterator last = first;
+			if (last != end() && !_comp(k, last->first))
+				++last;
+			return ft::make_pair(first, last);
+		}
+
+		allocator_type	get_allocator() const { return _alloc; }
+
+	private:
+		template <typename InputIterator>
+		void	_range_init(InputIterator first, InputIterator last, std::input_iterator_tag) {
+			while (first != last)
+				_tree.insert(end(), *first++);
+		}
+
+		template <typename ForwardIterator>
+		void	_range_init(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag) {
+			if (!_tree.build_if_sorted(first, last))
+				_range_init(first, last, std::input_iterator_tag());
+		}
+};
+
+
+}
+#endif
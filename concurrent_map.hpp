@@ -0,0 +1,336 @@
+#ifndef CONCURRENT_MAP_HPP
+# define CONCURRENT_MAP_HPP
+
+# include <functional> // less
+# include <memory> // allocator
+# include <cstddef> // ptrdiff_t, size_t
+# include <new> // placement new
+# include <iterator> // forward_iterator_tag
+# include <pthread.h>
+# include "vector.hpp"
+# include "utils/pair.hpp"
+# include "utils/hash.hpp"
+# include "utils/RB_Tree.hpp"
+# include "utils/key_of_value.hpp"
+
+namespace ft {
+
+/* A map that many threads can use at once.
+ * Keys are spread over a power-of-two number of shards by Hash. Each shard is an RB_Tree behind its own
+ * reader-writer lock, so operations on different shards never wait for each other and readers of one shard share it.
+ * Since an element may be changed or erased by another thread as soon as the lock is released,
+ * lookups copy the mapped value out (find) or run a function under the lock (update) instead of returning iterators.
+ * Ordered traversal across shards goes through an ordered_view, which read-locks every shard for its lifetime
+ * and merges the shards' in-order sequences (k-way merge). */
+template <typename Key, typename T, typename Compare = std::less<Key>, typename Hash = ft::hash<Key>,
+			typename Alloc = std::allocator<ft::pair<const Key,T> > >
+class concurrent_map {
+	public:
+		typedef Key										key_type;
+		typedef T										mapped_type;
+		typedef ft::pair<const Key, T>					value_type;
+		typedef Compare									key_compare;
+		typedef Hash									hasher;
+		typedef Alloc									allocator_type;
+		typedef ptrdiff_t								difference_type;
+		typedef size_t									size_type;
+
+		static const size_type	default_shards = 64;
+
+	private:
+		typedef nodeBase<value_type>		node;
+		typedef typename RB_TreeEngine::template rebind<key_type, value_type, ft::select1st<value_type>, key_compare, Alloc>::other	tree_type;
+
+		struct shard {
+			pthread_rwlock_t	lock;
+			tree_type			tree;
+			char				pad[64];		// keeps the next shard's lock off this cache line
+
+			shard(const key_compare& comp, const allocator_type& alloc) : tree(comp, alloc) {
+				pthread_rwlock_init(&lock, NULL);
+			}
+			~shard() { pthread_rwlock_destroy(&lock); }
+
+			private:
+			shard(const shard& other);
+			shard& operator=(const shard& rhs);
+		};
+
+		/* hold a shard's lock for the scope (released on exceptions too) */
+		class read_lock {
+			pthread_rwlock_t*	_lock;
+			read_lock(const read_lock&);
+			read_lock& operator=(const read_lock&);
+			public:
+				explicit read_lock(pthread_rwlock_t* lock) : _lock(lock) { pthread_rwlock_rdlock(_lock); }
+				~read_lock() { pthread_rwlock_unlock(_lock); }
+		};
+		class write_lock {
+			pthread_rwlock_t*	_lock;
+			write_lock(const write_lock&);
+			write_lock& operator=(const write_lock&);
+			public:
+				explicit write_lock(pthread_rwlock_t* lock) : _lock(lock) { pthread_rwlock_wrlock(_lock); }
+				~write_lock() { pthread_rwlock_unlock(_lock); }
+		};
+
+		shard*			_shards;
+		size_type		_nshards;
+		int				_shift;			// shard index = top bits of hash_mix(hash(k))
+		key_compare		_comp;
+		hasher			_hash;
+		allocator_type	_alloc;
+
+		concurrent_map(const concurrent_map& other);
+		concurrent_map& operator=(const concurrent_map& rhs);
+
+		shard&	_shard_of(const key_type& k) const {
+			if (_nshards == 1)
+				return _shards[0];
+			return _shards[ft::hash_mix(_hash(k)) >> _shift];
+		}
+
+	public:
+		// shards is rounded up to a power of two. About 2-4 times the number of threads keeps collisions on a lock rare.
+		explicit concurrent_map(size_type shards = default_shards, const key_compare& comp = key_compare(),
+								const hasher& hash = hasher(), const allocator_type& alloc = allocator_type())
+			: _shards(NULL), _nshards(1), _shift(sizeof(size_t) * 8), _comp(comp), _hash(hash), _alloc(alloc) {
+				while (_nshards < shards) {
+					_nshards <<= 1;
+					_shift--;
+				}
+				_shards = static_cast<shard*>(::operator new(_nshards * sizeof(shard)));
+				size_type i = 0;
+				try {
+					for (; i < _nshards; i++)
+						::new (static_cast<void*>(&_shards[i])) shard(_comp, _alloc);
+				} catch (...) {
+					while (i > 0)
+						_shards[--i].~shard();
+					::operator delete(_shards);
+					throw;
+				}
+		}
+
+		// Dtor : no other thread may be using the map.
+		~concurrent_map() {
+			for (size_type i = 0; i < _nshards; i++)
+				_shards[i].~shard();
+			::operator delete(_shards);
+		}
+
+		size_type	shard_count() const { return _nshards; }
+
+		// sum of the shards' sizes, each read under its lock. Exact only if no other thread is writing.
+		size_type	size() const {
+			size_type n = 0;
+			for (size_type i = 0; i < _nshards; i++) {
+				read_lock guard(&_shards[i].lock);
+				n += _shards[i].tree.getSize();
+			}
+			return n;
+		}
+
+		bool		empty() const { return size() == 0; }
+
+		// true if val was inserted, false if its key was already present (the element is left unchanged).
+		bool		insert(const value_type& val) {
+			shard& s = _shard_of(val.first);
+			write_lock guard(&s.lock);
+			return s.tree.insert(val).second;
+		}
+
+		// if k is not present, inserts (k, obj) and returns true. if it is, assigns obj to its mapped value and returns false.
+		bool		insert_or_assign(const key_type& k, const mapped_type& obj) {
+			shard& s = _shard_of(k);
+			write_lock guard(&s.lock);
+			typename tree_type::position pos = s.tree.locate(k);
+			if (pos.found) {
+				pos.found->value.second = obj;
+				return false;
+			}
+			s.tree.insert_at(pos, value_type(k, obj));
+			return true;
+		}
+
+		size_type	erase(const key_type& k) {
+			shard& s = _shard_of(k);
+			write_lock guard(&s.lock);
+			return s.tree.erase(k);
+		}
+
+		// copies the mapped value of k to out. false (out untouched) if k is not present.
+		bool		find(const key_type& k, mapped_type& out) const {
+			shard& s = _shard_of(k);
+			read_lock guard(&s.lock);
+			node* n = s.tree.find(k);
+			if (n == s.tree.end())
+				return false;
+			out = n->value.second;
+			return true;
+		}
+
+		size_type	count(const key_type& k) const {
+			shard& s = _shard_of(k);
+			read_lock guard(&s.lock);
+			return (s.tree.find(k) == s.tree.end()) ? 0 : 1;
+		}
+
+		// calls fn(mapped value of k) under the shard's write lock. false if k is not present.
+		// fn must not call back into this map.
+		template <typename Function>
+		bool		update(const key_type& k, Function fn) {
+			shard& s = _shard_of(k);
+			write_lock guard(&s.lock);
+			node* n = s.tree.find(k);
+			if (n == s.tree.end())
+				return false;
+			fn(n->value.second);
+			return true;
+		}
+
+		void		clear() {
+			for (size_type i = 0; i < _nshards; i++) {
+				write_lock guard(&_shards[i].lock);
+				_shards[i].tree.clear();
+			}
+		}
+
+		key_compare		key_comp() const		{ return _comp; }
+		hasher			hash_function() const	{ return _hash; }
+		allocator_type	get_allocator() const	{ return _alloc; }
+
+		/* Iterates every shard in one key order. Writers of any shard wait until the view is destroyed,
+		 * readers (find, count, other views) do not. Must not outlive the map, and the thread holding it
+		 * must not write to the map. */
+		class ordered_view {
+			public:
+				/* k-way merge : a binary min-heap of the shards' current nodes. ++ advances the shard at the top. */
+				class const_iterator {
+					public:
+						typedef ft::pair<const Key, T>				value_type;
+						typedef const value_type*					pointer;
+						typedef const value_type&					reference;
+						typedef ptrdiff_t							difference_type;
+						typedef std::forward_iterator_tag			iterator_category;
+
+					private:
+						friend class ordered_view;
+						struct cursor {
+							node*	cur;
+							node*	end;
+						};
+						ft::vector<cursor>	_heap;
+						key_compare			_comp;
+
+						bool	_less(size_type a, size_type b) const {
+							return _comp(_heap[a].cur->value.first, _heap[b].cur->value.first);
+						}
+						void	_sift_down(size_type i) {
+							size_type n = _heap.size();
+							for (;;) {
+								size_type min = i;
+								size_type l = 2 * i + 1;
+								if (l < n && _less(l, min))
+									min = l;
+								if (l + 1 < n && _less(l + 1, min))
+									min = l + 1;
+								if (min == i)
+									return;
+								std::swap(_heap[i], _heap[min]);
+								i = min;
+							}
+						}
+						void	_push(node* cur, node* end) {
+							if (cur == end)
+								return;
+							cursor c;
+							c.cur = cur;
+							c.end = end;
+							_heap.push_back(c);
+						}
+						void	_make_heap() {
+							for (size_type i = _heap.size() / 2; i-- > 0; )
+								_sift_down(i);
+						}
+
+					public:
+						const_iterator() : _heap(), _comp() { }
+						explicit const_iterator(const key_compare& comp) : _heap(), _comp(comp) { }
+
+						reference	operator*() const	{ return _heap[0].cur->value; }
+						pointer		operator->() const	{ return &(_heap[0].cur->value); }
+
+						const_iterator&	operator++() {
+							_heap[0].cur = _heap[0].cur->next();
+							if (_heap[0].cur == _heap[0].end) {
+								_heap[0] = _heap.back();
+								_heap.pop_back();
+							}
+							_sift_down(0);
+							return *this;
+						}
+						const_iterator	operator++(int) {
+							const_iterator tmp(*this);
+							++*this;
+							return tmp;
+						}
+
+						bool	operator==(const const_iterator& rhs) const {
+							if (_heap.empty() || rhs._heap.empty())
+								return _heap.empty() == rhs._heap.empty();
+							return _heap[0].cur == rhs._heap[0].cur;
+						}
+						bool	operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+				};
+
+			private:
+				const concurrent_map&	_map;
+
+				ordered_view(const ordered_view&);
+				ordered_view& operator=(const ordered_view&);
+
+			public:
+				// locks are always taken in shard order, so views never deadlock each other.
+				explicit ordered_view(const concurrent_map& m) : _map(m) {
+					for (size_type i = 0; i < _map._nshards; i++)
+						pthread_rwlock_rdlock(&_map._shards[i].lock);
+				}
+				~ordered_view() {
+					for (size_type i = _map._nshards; i-- > 0; )
+						pthread_rwlock_unlock(&_map._shards[i].lock);
+				}
+
+				const_iterator	begin() const {
+					const_iterator it(_map._comp);
+					it._heap.reserve(_map._nshards);
+					for (size_type i = 0; i < _map._nshards; i++)
+						it._push(_map._shards[i].tree.begin(), _map._shards[i].tree.end());
+					it._make_heap();
+					return it;
+				}
+				const_iterator	end() const { return const_iterator(_map._comp); }
+
+				// first element whose key is not less than k
+				const_iterator	lower_bound(const key_type& k) const {
+					const_iterator it(_map._comp);
+					it._heap.reserve(_map._nshards);
+					for (size_type i = 0; i < _map._nshards; i++)
+						it._push(_map._shards[i].tree.lower_bound(k), _map._shards[i].tree.end());
+					it._make_heap();
+					return it;
+				}
+
+				// exact, since no shard can change while the view exists
+				size_type		size() const {
+					size_type n = 0;
+					for (size_type i = 0; i < _map._nshards; i++)
+						n += _map._shards[i].tree.getSize();
+					return n;
+				}
+		};
+};
+
+
+}
+#endif
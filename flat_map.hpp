@@ -0,0 +1,220 @@
+#ifndef FLAT_MAP_HPP
+# define FLAT_MAP_HPP
+
+# include <functional> // less
+# include <memory> // allocator
+# include <stdexcept> // out_of_range
+# include <cstddef> // ptrdiff_t
+# include "vector.hpp"
+# include "utils/pair.hpp"
+# include "utils/sorted_vector.hpp"
+# include "utils/tree_interface.hpp" // sorted_unique_t
+# include "utils/reverse_iterator.hpp"
+# include "utils/key_of_value.hpp"
+
+namespace ft {
+
+/* An ordered map kept as one sorted ft::vector of pairs (see utils/sorted_vector.hpp).
+ * Same interface as ft::map, so it can replace a read-mostly map without touching call sites:
+ * lookups are binary searches over contiguous memory and there is no per-element node,
+ * but a single insert or erase moves every element after it (O(n)). Load many elements with insert(first, last),
+ * which sorts them and merges them in one pass.
+ * Iterators are random access. insert and erase invalidate iterators at or after the position (all of them on reallocation). */
+template <typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<ft::pair<const Key,T> > >
+class flat_map {
+	public:
+		typedef Key										key_type;
+		typedef T										mapped_type;
+		typedef ft::pair<const Key, T>					value_type;
+		typedef Compare									key_compare;
+		class	value_compare {
+			friend class flat_map<Key, T, Compare, Alloc>;
+			protected:
+				Compare comp;
+				value_compare (Compare c) : comp(c) { }
+			public:
+				bool operator() (const value_type& x, const value_type& y) const {
+					return (comp(x.first, y.first));
+				}
+		};
+		typedef Alloc									allocator_type;
+		typedef typename Alloc::reference				reference;
+		typedef typename Alloc::const_reference			const_reference;
+		typedef typename Alloc::pointer					pointer;
+		typedef typename Alloc::const_pointer			const_pointer;
+
+	private:
+		typedef SortedVector<key_type, value_type, ft::select1st<value_type>, key_compare, Alloc>	table_type;
+
+	public:
+		typedef typename table_type::iterator			iterator;
+		typedef typename table_type::const_iterator		const_iterator;
+		typedef ft::reverse_iterator<iterator>			reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+		typedef ptrdiff_t								difference_type;
+		typedef size_t									size_type;
+
+	private:
+		table_type _vec;
+		key_compare _comp;
+		allocator_type _alloc;
+
+	public:
+		// default Ctor
+		flat_map(const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _vec(comp, alloc), _comp(comp), _alloc(alloc) { }
+
+		// range Ctor : sorted once, O(n log n) (O(n) if already sorted).
+		template<typename InputIterator>
+		flat_map(InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _vec(comp, alloc), _comp(comp), _alloc(alloc) {
+				_vec.insert_range(first, last);
+		}
+
+		// sorted range Ctor : [first, last) must be sorted by key with no duplicates. O(n).
+		template<typename InputIterator>
+		flat_map(ft::sorted_unique_t, InputIterator first, InputIterator last,
+			const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _vec(comp, alloc), _comp(comp), _alloc(alloc) {
+				_vec.assign_sorted(first, last);
+		}
+
+		// copy Ctor
+		flat_map(const flat_map& other) : _vec(other._vec), _comp(other._comp), _alloc(other._alloc) { }
+
+		flat_map& operator=(const flat_map& rhs) {
+			flat_map tmp(rhs);
+			swap(tmp);
+			return *this;
+		}
+
+		~flat_map() { }
+
+		// Iterators
+		iterator		begin()			{ return _vec.begin(); }
+		const_iterator	begin() const	{ return _vec.begin(); }
+		iterator		end()			{ return _vec.end(); }
+		const_iterator	end() const		{ return _vec.end(); }
+
+		reverse_iterator		rbegin()		{ return reverse_iterator(end()); }
+		const_reverse_iterator	rbegin() const	{ return const_reverse_iterator(end()); }
+		reverse_iterator		rend()			{ return reverse_iterator(begin()); }
+		const_reverse_iterator	rend() const	{ return const_reverse_iterator(begin()); }
+
+		// Capacity
+		bool		empty()		const { return (_vec.getSize() == 0); }
+		size_type	size()		const { return _vec.getSize(); }
+		size_type	max_size()	const { return _vec.max_size(); }
+		size_type	capacity()	const { return _vec.capacity(); }
+		void		reserve(size_type n) { _vec.reserve(n); }
+
+		// if k matches the key, returns a reference to its mapped value.
+		// if not, inserts a new element with that key and returns a reference to its mapped value.
+		mapped_type& operator[](const key_type& k) {
+			typename table_type::position pos = _vec.locate(k);
+			if (pos.found)
+				return _vec.at_index(pos.index)->second;
+			return _vec.insert_at(pos, value_type(k, mapped_type()))->second;
+		}
+
+		mapped_type&		at(const key_type& k) {
+			iterator it = find(k);
+			if (it == end())
+				throw std::out_of_range("flat_map::at");
+			return it->second;
+		}
+		const mapped_type&	at(const key_type& k) const {
+			const_iterator it = find(k);
+			if (it == end())
+				throw std::out_of_range("flat_map::at");
+			return it->second;
+		}
+
+		// if k is not present, inserts (k, obj). if it is, does nothing (obj is not used).
+		ft::pair<iterator,bool>	try_emplace(const key_type& k, const mapped_type& obj) {
+			typename table_type::position pos = _vec.locate(k);
+			if (pos.found)
+				return ft::make_pair(_vec.at_index(pos.index), false);
+			return ft::make_pair(_vec.insert_at(pos, value_type(k, obj)), true);
+		}
+
+		// if k is not present, inserts (k, obj). if it is, assigns obj to its mapped value.
+		// second of the result is true if a new element was inserted.
+		ft::pair<iterator,bool>	insert_or_assign(const key_type& k, const mapped_type& obj) {
+			typename table_type::position pos = _vec.locate(k);
+			if (pos.found) {
+				iterator it = _vec.at_index(pos.index);
+				it->second = obj;
+				return ft::make_pair(it, false);
+			}
+			return ft::make_pair(_vec.insert_at(pos, value_type(k, obj)), true);
+		}
+
+		// insert single element
+		ft::pair<iterator,bool>	insert(const value_type& val) {
+			return _vec.insert(val);
+		}
+
+		// insert with hint : no search if val goes right before position.
+		iterator				insert(const_iterator position, const value_type& val) {
+			return _vec.insert(position, val);
+		}
+
+		// insert range : the new elements are sorted apart and merged in one pass, O(n + m log m).
+		// Keys already present, and later duplicates within the range, are not inserted (as with n single inserts).
+		template <class InputIterator>
+		void					insert(InputIterator first, InputIterator last) {
+			_vec.insert_range(first, last);
+		}
+
+		iterator	erase(const_iterator position) {
+			return _vec.erase(position);
+		}
+
+		size_type	erase(const key_type& k) {
+			return _vec.erase(k);
+		}
+
+		iterator	erase(const_iterator first, const_iterator last) {
+			return _vec.erase(first, last);
+		}
+
+		void		swap(flat_map& x) {
+			_vec.swap(x._vec);
+			std::swap(_comp, x._comp);
+			std::swap(_alloc, x._alloc);
+		}
+
+		void		clear() {
+			_vec.clear();
+		}
+
+		key_compare		key_comp() const	{ return _comp; }
+		value_compare	value_comp() const	{ return value_compare(_comp); }
+
+		iterator 		find(const key_type& k)			{ return _vec.find(k); }
+		const_iterator	find(const key_type& k) const	{ return _vec.find(k); }
+
+		size_type		count(const key_type& k) const	{ return _vec.locate(k).found ? 1 : 0; }
+
+		iterator		lower_bound(const key_type& k)			{ return _vec.at_index(_vec.lower_index(k)); }
+		const_iterator	lower_bound(const key_type& k) const	{ return _vec.at_index(_vec.lower_index(k)); }
+
+		iterator		upper_bound(const key_type& k)			{ return _vec.at_index(_vec.upper_index(k)); }
+		const_iterator	upper_bound(const key_type& k) const	{ return _vec.at_index(_vec.upper_index(k)); }
+
+		ft::pair<iterator,iterator>				equal_range(const key_type& k) {
+			typename table_type::position pos = _vec.locate(k);
+			return ft::make_pair(_vec.at_index(pos.index), _vec.at_index(pos.index + pos.found));
+		}
+		ft::pair<const_iterator,const_iterator>	equal_range(const key_type& k) const {
+			typename table_type::position pos = _vec.locate(k);
+			return ft::make_pair(_vec.at_index(pos.index), _vec.at_index(pos.index + pos.found));
+		}
+
+		allocator_type	get_allocator() const { return _alloc; }
+};
+
+
+}
+#endif
@@ -0,0 +1,151 @@
+#ifndef FLAT_SET_HPP
+# define FLAT_SET_HPP
+
+# include <functional> // less
+# include <memory> // allocator
+# include <cstddef> // ptrdiff_t
+# include "vector.hpp"
+# include "utils/pair.hpp"
+# include "utils/sorted_vector.hpp"
+# include "utils/tree_interface.hpp" // sorted_unique_t
+# include "utils/reverse_iterator.hpp"
+# include "utils/key_of_value.hpp"
+
+namespace ft {
+
+/* An ordered set kept as one sorted ft::vector, with the interface of ft::set. See flat_map.hpp for the trade-offs.
+ * Elements cannot be modified in place, so iterator and const_iterator are both const. */
+template <typename T, typename Compare = std::less<T>, typename Alloc = std::allocator<T> >
+class flat_set {
+	public:
+		typedef T										key_type;
+		typedef T										value_type;
+		typedef Compare									key_compare;
+		typedef Compare									value_compare;
+		typedef Alloc									allocator_type;
+		typedef typename Alloc::reference				reference;
+		typedef typename Alloc::const_reference			const_reference;
+		typedef typename Alloc::pointer					pointer;
+		typedef typename Alloc::const_pointer			const_pointer;
+
+	private:
+		typedef SortedVector<key_type, value_type, ft::identity<value_type>, key_compare, Alloc>	table_type;
+
+	public:
+		typedef typename table_type::const_iterator		iterator;
+		typedef typename table_type::const_iterator		const_iterator;
+		typedef ft::reverse_iterator<iterator>			reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+		typedef ptrdiff_t								difference_type;
+		typedef size_t									size_type;
+
+	private:
+		table_type _vec;
+		key_compare _comp;
+		allocator_type _alloc;
+
+	public:
+		// default Ctor
+		flat_set(const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _vec(comp, alloc), _comp(comp), _alloc(alloc) { }
+
+		// range Ctor : sorted once, O(n log n) (O(n) if already sorted).
+		template<typename InputIterator>
+		flat_set(InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _vec(comp, alloc), _comp(comp), _alloc(alloc) {
+				_vec.insert_range(first, last);
+		}
+
+		// sorted range Ctor : [first, last) must be sorted with no duplicates. O(n).
+		template<typename InputIterator>
+		flat_set(ft::sorted_unique_t, InputIterator first, InputIterator last,
+			const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _vec(comp, alloc), _comp(comp), _alloc(alloc) {
+				_vec.assign_sorted(first, last);
+		}
+
+		// copy Ctor
+		flat_set(const flat_set& other) : _vec(other._vec), _comp(other._comp), _alloc(other._alloc) { }
+
+		flat_set& operator=(const flat_set& rhs) {
+			flat_set tmp(rhs);
+			swap(tmp);
+			return *this;
+		}
+
+		~flat_set() { }
+
+		// Iterators
+		const_iterator	begin() const	{ return _vec.begin(); }
+		const_iterator	end() const		{ return _vec.end(); }
+
+		const_reverse_iterator	rbegin() const	{ return const_reverse_iterator(end()); }
+		const_reverse_iterator	rend() const	{ return const_reverse_iterator(begin()); }
+
+		// Capacity
+		bool		empty()		const { return (_vec.getSize() == 0); }
+		size_type	size()		const { return _vec.getSize(); }
+		size_type	max_size()	const { return _vec.max_size(); }
+		size_type	capacity()	const { return _vec.capacity(); }
+		void		reserve(size_type n) { _vec.reserve(n); }
+
+		// insert single element
+		ft::pair<iterator,bool>	insert(const value_type& val) {
+			ft::pair<typename table_type::iterator, bool> ret = _vec.insert(val);
+			return ft::make_pair(iterator(ret.first), ret.second);
+		}
+
+		// insert with hint : no search if val goes right before position.
+		iterator				insert(const_iterator position, const value_type& val) {
+			return _vec.insert(position, val);
+		}
+
+		// insert range : the new elements are sorted apart and merged in one pass, O(n + m log m).
+		template <class InputIterator>
+		void					insert(InputIterator first, InputIterator last) {
+			_vec.insert_range(first, last);
+		}
+
+		iterator	erase(const_iterator position) {
+			return _vec.erase(position);
+		}
+
+		size_type	erase(const key_type& k) {
+			return _vec.erase(k);
+		}
+
+		iterator	erase(const_iterator first, const_iterator last) {
+			return _vec.erase(first, last);
+		}
+
+		void		swap(flat_set& x) {
+			_vec.swap(x._vec);
+			std::swap(_comp, x._comp);
+			std::swap(_alloc, x._alloc);
+		}
+
+		void		clear() {
+			_vec.clear();
+		}
+
+		key_compare		key_comp() const	{ return _comp; }
+		value_compare	value_comp() const	{ return _comp; }
+
+		const_iterator	find(const key_type& k) const	{ return _vec.find(k); }
+
+		size_type		count(const key_type& k) const	{ return _vec.locate(k).found ? 1 : 0; }
+
+		const_iterator	lower_bound(const key_type& k) const	{ return _vec.at_index(_vec.lower_index(k)); }
+		const_iterator	upper_bound(const key_type& k) const	{ return _vec.at_index(_vec.upper_index(k)); }
+
+		ft::pair<const_iterator,const_iterator>	equal_range(const key_type& k) const {
+			typename table_type::position pos = _vec.locate(k);
+			return ft::make_pair(_vec.at_index(pos.index), _vec.at_index(pos.index + pos.found));
+		}
+
+		allocator_type	get_allocator() const { return _alloc; }
+};
+
+
+}
+#endif
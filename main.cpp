@@ -2,6 +2,7 @@
 #include <typeinfo>
 #include <list>
 #include <cstdlib>
+#include <sstream>
 
 #ifdef STD
 	#include <iterator>
@@ -10,6 +11,8 @@
 	#include <map>
 	#include <stack>
 	#include <set>
+	#include <unordered_map>
+	#include <unordered_set>
 	namespace ft = std;
 #else
 	#include "vector.hpp"
@@ -17,6 +20,20 @@
 	#include "map.hpp"
 	#include "stack.hpp"
 	#include "set.hpp"
+	#include "persistent_map.hpp"
+	#include "concurrent_map.hpp"
+	#include "skiplist_map.hpp"
+	#include "unordered_map.hpp"
+	#include "unordered_set.hpp"
+	#include "flat_map.hpp"
+	#include "flat_set.hpp"
+	#include "btree_map.hpp"
+	#include "btree_set.hpp"
+	#include "compact_map.hpp"
+	#include "compact_set.hpp"
+	#include "static_map.hpp"
+	#include "static_set.hpp"
+	#include <pthread.h>
 #endif
 
 void prn_vec(ft::vector<int> &v) {
@@ -35,6 +52,227 @@ void prn_map(ft::map<char,int> &m) {
 
 }
 
+// scan()에 넘기는 함수 객체
+struct sum_of_ints {
+	long	sum;
+	int		count;
+	sum_of_ints() : sum(0), count(0) { }
+	void operator()(int v) { sum += v; count++; }
+};
+
+struct double_mapped {
+	void operator()(ft::pair<const int, int>& v) const { v.second *= 2; }
+};
+
+struct triple_int {
+	void operator()(int& v) const { v *= 3; }
+};
+
+#ifdef FT
+// 만들어진(생성, 복사) 횟수를 세는 mapped type. 찾기만 하는 함수는 하나도 만들지 않아야 한다.
+struct counted_mapped {
+	static int	built;
+	int			v;
+	counted_mapped() : v(0) { built++; }
+	counted_mapped(const counted_mapped& other) : v(other.v) { built++; }
+};
+int	counted_mapped::built = 0;
+
+// tree_info()가 출력하는 Red-Black 조건이 모두 true인가
+template <typename Set>
+bool	rb_valid(const Set& s) {
+	std::ostringstream out;
+	std::streambuf* old = std::cout.rdbuf(out.rdbuf());
+	s.tree_info();
+	std::cout.rdbuf(old);
+	return out.str().find("false") == std::string::npos;
+}
+
+// a와 b를 pool로 op(0 합집합, 1 교집합, 2 차집합) 한 결과를 같은 원소의 사본을 순차로 op 한 것과 비교한다. 틀린 곳의 수.
+template <typename Set>
+int		check_set_op(Set& a, Set& b, int op, ft::task_pool& pool, size_t grain) {
+	Set ra(a);
+	Set rb(b);
+	if (op == 0) {
+		a.set_union(b, pool, grain);
+		ra.set_union(rb);
+	}
+	else if (op == 1) {
+		a.set_intersection(b, pool, grain);
+		ra.set_intersection(rb);
+	}
+	else {
+		a.set_difference(b, pool, grain);
+		ra.set_difference(rb);
+	}
+	int errors = (a.size() != ra.size()) + !b.empty() + !rb_valid(a);
+	typename Set::const_iterator r = ra.begin();
+	for (typename Set::const_iterator it = a.begin(); it != a.end() && r != ra.end(); ++it, ++r)
+		errors += (*it != *r);
+	return errors;
+}
+
+// 여러 thread가 같이 쓰는 concurrent_map. thread id는 [id * 256, id * 256 + 256)의 key만 바꾸며 그 값을 expect에 적어 둔다. (없으면 -1)
+// 값은 언제나 key * 1000 + (0 ~ 999)이다.
+struct concurrent_worker {
+	ft::concurrent_map<int, int>*	m;
+	int								id;
+	int								expect[256];
+	long							errors;
+};
+
+struct bump_version {
+	void operator()(int& v) const { v = v / 1000 * 1000 + (v % 1000 + 1) % 1000; }
+};
+
+void*	concurrent_stress(void* arg) {
+	concurrent_worker& w = *static_cast<concurrent_worker*>(arg);
+	unsigned x = 88172645u + w.id * 104729;
+	for (int i = 0; i < 256; i++)
+		w.expect[i] = -1;
+	w.errors = 0;
+	for (int round = 0; round < 40000; round++) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		int i = (x >> 4) % 256;
+		int k = w.id * 256 + i;
+		int& e = w.expect[i];
+		int v = -1;
+		switch (x % 5) {
+			case 0:
+				if (w.m->insert(ft::make_pair(k, k * 1000)) != (e == -1))
+					w.errors++;
+				if (e == -1)
+					e = k * 1000;
+				break;
+			case 1:
+				if (w.m->insert_or_assign(k, k * 1000 + round % 1000) != (e == -1))
+					w.errors++;
+				e = k * 1000 + round % 1000;
+				break;
+			case 2:
+				if (w.m->update(k, bump_version()) != (e != -1))
+					w.errors++;
+				if (e != -1)
+					bump_version()(e);
+				break;
+			case 3:
+				if (w.m->erase(k) != (e == -1 ? 0u : 1u))
+					w.errors++;
+				e = -1;
+				break;
+			default:
+				if (w.m->find(k, v) != (e != -1) || (e != -1 && v != e))
+					w.errors++;
+		}
+	}
+	return NULL;
+}
+
+// 다른 thread들이 쓰는 동안 ordered_view를 되풀이해 만들어 순서와 값을 확인한다.
+struct concurrent_checker {
+	ft::concurrent_map<int, int>*	m;
+	int								views;
+	long							errors;
+};
+
+void*	concurrent_check(void* arg) {
+	concurrent_checker& c = *static_cast<concurrent_checker*>(arg);
+	c.errors = 0;
+	for (int i = 0; i < c.views; i++) {
+		ft::concurrent_map<int, int>::ordered_view view(*c.m);
+		size_t walked = 0;
+		int prev = -1;
+		for (ft::concurrent_map<int, int>::ordered_view::const_iterator it = view.begin(); it != view.end(); ++it, ++walked) {
+			if (it->first <= prev || it->second / 1000 != it->first)
+				c.errors++;
+			prev = it->first;
+		}
+		if (walked != view.size())
+			c.errors++;
+	}
+	return NULL;
+}
+
+// 여러 thread가 같이 쓰는 skiplist_map. thread id는 [0, 512)에서 key % 4 == id 인 key만 넣고 지우며 own에 적어 두고,
+// [512, 768)은 모든 thread가 같이 넣고 지운다. 읽기(find, 앞뒤로 걷기)는 모든 key에서 한다. 값은 언제나 key * 3이다.
+struct skiplist_worker {
+	ft::skiplist_map<int, int>*	m;
+	int							id;
+	bool						own[512];
+	long						errors;
+};
+
+void*	skiplist_stress(void* arg) {
+	typedef ft::skiplist_map<int, int>::const_iterator	iter;
+	skiplist_worker& w = *static_cast<skiplist_worker*>(arg);
+	unsigned x = 2463534242u + w.id * 7919;
+	for (int i = 0; i < 512; i++)
+		w.own[i] = false;
+	w.errors = 0;
+	for (int round = 0; round < 40000; round++) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		int mine = (x >> 4) % 128 * 4 + w.id;
+		int shared = 512 + (x >> 12) % 256;
+		switch (x % 8) {
+			case 0:
+			case 1:
+				if (w.m->insert(ft::make_pair(mine, mine * 3)).second == w.own[mine])
+					w.errors++;
+				w.own[mine] = true;
+				break;
+			case 2:
+				if (w.m->erase(mine) != (w.own[mine] ? 1u : 0u))
+					w.errors++;
+				w.own[mine] = false;
+				break;
+			case 3: {
+				iter it = w.m->find(mine);
+				if ((it != w.m->end()) != w.own[mine])
+					w.errors++;
+				if (it != w.m->end()) {
+					w.m->erase(it);
+					w.own[mine] = false;
+				}
+				break;
+			}
+			case 4:
+				w.m->insert(ft::make_pair(shared, shared * 3));
+				break;
+			case 5:
+				w.m->erase(shared);
+				break;
+			case 6: {
+				int prev = -1;
+				int n = 0;
+				for (iter it = w.m->lower_bound((x >> 8) % 768); it != w.m->end() && n < 32; ++it, ++n) {
+					if (it->first <= prev || it->second != it->first * 3)
+						w.errors++;
+					prev = it->first;
+				}
+				break;
+			}
+			default: {
+				// 맨 앞 원소에서 --하면 end()가 된다
+				int prev = 768;
+				iter it = w.m->upper_bound((x >> 8) % 768);
+				for (int n = 0; n < 32; n++) {
+					--it;
+					if (it == w.m->end())
+						break;
+					if (it->first >= prev || it->second != it->first * 3)
+						w.errors++;
+					prev = it->first;
+				}
+			}
+		}
+	}
+	return NULL;
+}
+#endif
 
 int main() {
 #ifdef STD
@@ -307,9 +545,11 @@ int main() {
 
 	prn_map(m);
 
-	std::cout << "\n erase 'c'\n";
-	m.erase('c');
+	std::cout << "\n count('b') = " << m.count('b') << ", count('q') = " << m.count('q') << "\n";
+
+	std::cout << "\n erase 'c' returns " << m.erase('c') << "\n";
 	prn_map(m);
+	std::cout << " erase 'c' again returns " << m.erase('c') << "\n";
 
 	std::cout << "\n erase 'a'\n";
 	m.erase('a');
@@ -376,6 +616,91 @@ int main() {
 	}
 
 
+	{
+		std::cout << "\n lower_bound / upper_bound / equal_range\n";
+		ft::map<int,int> mm;
+		for (int i = 0; i < 10; i++)
+			mm[i * 10] = i;
+		const ft::map<int,int>& cm = mm;
+		std::cout << "lower_bound(30) = " << mm.lower_bound(30)->first << "\n";
+		std::cout << "lower_bound(31) = " << mm.lower_bound(31)->first << "\n";
+		std::cout << "upper_bound(30) = " << mm.upper_bound(30)->first << "\n";
+		std::cout << "upper_bound(-5) = " << cm.upper_bound(-5)->first << "\n";
+		std::cout << "lower_bound(95) == end : " << (cm.lower_bound(95) == cm.end()) << "\n";
+		std::cout << "upper_bound(90) == end : " << (mm.upper_bound(90) == mm.end()) << "\n";
+		ft::pair<ft::map<int,int>::const_iterator, ft::map<int,int>::const_iterator> range = cm.equal_range(40);
+		std::cout << "equal_range(40) = [" << range.first->first << ", " << range.second->first << ")\n";
+		range = cm.equal_range(45);
+		std::cout << "equal_range(45) = [" << range.first->first << ", " << range.second->first << ")\n";
+	}
+
+	{
+		std::cout << "\n begin / rbegin after erasing min and max\n";
+		ft::map<int,int> mm;
+		for (int i = 0; i < 8; i++)
+			mm[(i * 5) % 8] = i;
+		while (mm.size() > 1) {
+			std::cout << "[" << mm.begin()->first << ", " << mm.rbegin()->first << "] ";
+			mm.erase(mm.begin());
+			mm.erase(--mm.end());
+		}
+		std::cout << "\n";
+	}
+
+	{
+		std::cout << "\n insert with hint\n";
+		ft::map<int,int> mm;
+		for (int i = 0; i < 5; i++)
+			mm.insert(mm.end(), ft::make_pair(i * 10, i));			// 맞는 hint (맨 뒤)
+		mm.insert(mm.begin(), ft::make_pair(-10, -1));				// 맞는 hint (맨 앞)
+		mm.insert(mm.find(30), ft::make_pair(25, 100));				// 맞는 hint (중간)
+		mm.insert(mm.begin(), ft::make_pair(35, 200));				// 틀린 hint
+		ft::map<int,int>::iterator it = mm.insert(mm.end(), ft::make_pair(20, 300));	// 이미 있는 key
+		std::cout << "existing: (" << it->first << ", " << it->second << ")\n";
+		for (it = mm.begin(); it != mm.end(); ++it)
+			std::cout << it->first << " => " << it->second << '\n';
+	}
+
+
+#ifdef FT
+	{
+		std::cout << "\n try_emplace / insert_or_assign (c++17)\n";
+		ft::map<char,int> mm;
+		mm['a'] = 1;
+		ft::pair<ft::map<char,int>::iterator, bool> r = mm.try_emplace('a', 100);
+		std::cout << "try_emplace('a', 100)      -> (" << r.first->second << ", " << r.second << ")\n";
+		r = mm.try_emplace('b', 2);
+		std::cout << "try_emplace('b', 2)        -> (" << r.first->second << ", " << r.second << ")\n";
+		r = mm.insert_or_assign('a', 100);
+		std::cout << "insert_or_assign('a', 100) -> (" << r.first->second << ", " << r.second << ")\n";
+		r = mm.insert_or_assign('c', 3);
+		std::cout << "insert_or_assign('c', 3)   -> (" << r.first->second << ", " << r.second << ")\n";
+		for (int i = 0; i < 10; i++)
+			mm['z']++;
+		std::cout << "mm['z']++ x10 = " << mm['z'] << ", size = " << mm.size() << "\n";
+	}
+	{
+		std::cout << "\n찾을 때 mapped_type을 만들지 않는가\n";
+		ft::map<int, counted_mapped> m;
+		for (int i = 0; i < 100; i += 2)
+			m[i].v = i;
+		counted_mapped::built = 0;
+		int found = (m.find(40) != m.end()) + (m.find(41) != m.end());
+		std::cout << "find: " << counted_mapped::built;
+		found += m.count(50) + m.count(51);
+		std::cout << ", count: " << counted_mapped::built;
+		found += m.lower_bound(61)->second.v + m.upper_bound(61)->second.v;
+		std::cout << ", lower_bound, upper_bound: " << counted_mapped::built;
+		found += m.equal_range(70).first->second.v;
+		std::cout << ", equal_range: " << counted_mapped::built;
+		found += m.erase(80) + m.erase(81);
+		std::cout << ", erase(key): " << counted_mapped::built;
+		found += m[90].v;
+		std::cout << ", operator[] hit: " << counted_mapped::built << " (checksum " << found << ", size " << m.size() << ")\n";
+	}
+#endif
+
+
 	std::cout << "\n ===== stack =====\n";
 	ft::stack<int> st;
 
@@ -409,6 +734,16 @@ int main() {
 		s.tree_info();
 #endif
 
+		std::cout << "정렬된 입력으로 생성 (range ctor)\n";
+		ft::set<int> sorted(s.begin(), s.end());
+		std::cout << "size = " << sorted.size() << ", first = " << *sorted.begin() << ", last = " << *sorted.rbegin() << "\n";
+#ifdef FT
+		sorted.tree_info();
+#endif
+		int dup[] = { 1, 1, 2, 3, 3, 3, 7 };
+		ft::set<int> dedup(dup, dup + 7);
+		std::cout << "중복 포함 정렬된 입력: size = " << dedup.size() << "\n";
+
 		std::cout << "2000부터 3000까지 삭제\n";
 		for (int i = 2000; i < 3000; i++)
 			s.erase(i);
@@ -416,11 +751,531 @@ int main() {
 #ifdef FT
 		s.tree_info();
 #endif
+		std::cout << "lower_bound(2500) = " << *s.lower_bound(2500) << "\n";
+		std::cout << "upper_bound(1999) = " << *s.upper_bound(1999) << "\n";
+		std::cout << "equal_range(3000) = [" << *s.equal_range(3000).first << ", " << *s.equal_range(3000).second << ")\n";
 		s.clear();
 		std::cout << "after clear: size = " << s.size() << "\n";
 	}
 
 
+#ifdef FT
+	{
+		std::cout << "pool_allocator를 쓰는 set\n";
+		ft::set<int, std::less<int>, ft::pool_allocator<int> > s;
+		for (int i = 0; i < 5000; i++)
+			s.insert(i * 7 % 5000);
+		for (int i = 0; i < 5000; i += 2)
+			s.erase(i);
+		ft::set<int, std::less<int>, ft::pool_allocator<int> > copy(s);
+		std::cout << "size = " << s.size() << ", copy size = " << copy.size() << ", first = " << *copy.begin() << "\n";
+		s.clear();
+		s.insert(42);
+		std::cout << "after clear and insert(42): size = " << s.size() << ", first = " << *s.begin() << "\n";
+		s.tree_info();
+	}
+	{
+		std::cout << "\n순서 통계 (OrderStatisticEngine)\n";
+		ft::set<int, std::less<int>, std::allocator<int>, ft::OrderStatisticEngine> s;
+		for (int i = 0; i < 1000; i++)
+			s.insert(i * 37 % 1000);
+		for (int i = 0; i < 1000; i += 3)
+			s.erase(i);
+		std::cout << "size = " << s.size() << ", p50 = " << *s.nth(s.size() / 2)
+			<< ", p99 = " << *s.nth(s.size() * 99 / 100) << "\n";
+		std::cout << "rank(500) = " << s.rank(500) << ", count_range(100, 200) = " << s.count_range(100, 200)
+			<< ", index_of(find(700)) = " << s.index_of(s.find(700)) << "\n";
+		s.tree_info();
+	}
+	{
+		std::cout << "\n구간 합 (monoid_augment)\n";
+		ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >,
+			ft::AugmentedRB_TreeEngine<ft::monoid_augment<ft::sum_monoid<int> > > > sum;
+		ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >,
+			ft::AugmentedRB_TreeEngine<ft::monoid_augment<ft::max_monoid<int> > > > max;
+		for (int i = 1; i <= 100; i++) {
+			sum[i] = i;
+			max.insert(ft::make_pair(i, i * 37 % 101));
+		}
+		std::cout << "sum[1, 101) = " << sum.aggregate(1, 101) << ", sum[10, 20) = " << sum.aggregate(10, 20)
+			<< ", max[1, 50) = " << max.aggregate(1, 50) << "\n";
+		sum.erase(15);
+		sum.insert_or_assign(10, 1000);
+		std::cout << "after erase(15), insert_or_assign(10, 1000): sum[10, 20) = " << sum.aggregate(10, 20)
+			<< ", sum[200, 300) = " << sum.aggregate(200, 300) << "\n";
+		for (int i = 20; i < 30; i++) {
+			sum[i] += 100;
+			sum.value_changed(sum.find(i));
+		}
+		sum.update(40, triple_int());
+		std::cout << "after sum[20..29] += 100, update(40, x3): sum[1, 101) = " << sum.aggregate(1, 101)
+			<< ", sum[20, 30) = " << sum.aggregate(20, 30) << ", sum[35, 45) = " << sum.aggregate(35, 45)
+			<< ", update(15) = " << sum.update(15, triple_int()) << "\n";
+	}
+	{
+		std::cout << "\n합집합, 교집합, 차집합 (split / join)\n";
+		ft::set<int> a, b, c, d;
+		for (int i = 0; i < 30; i++) {
+			a.insert(i * 2);
+			b.insert(i * 3);
+		}
+		c = a;
+		d = a;
+		ft::set<int> b2(b), b3(b);
+		a.set_union(b);
+		c.set_intersection(b2);
+		d.set_difference(b3);
+		std::cout << "union: size = " << a.size() << ", other size = " << b.size() << "\n";
+		std::cout << "intersection:";
+		for (ft::set<int>::iterator it = c.begin(); it != c.end(); ++it)
+			std::cout << " " << *it;
+		std::cout << "\ndifference: size = " << d.size() << ", first = " << *d.begin() << ", last = " << *d.rbegin() << "\n";
+		a.erase(a.find(10), a.find(70));
+		std::cout << "union after erase [10, 70): size = " << a.size() << "\n";
+		a.tree_info();
+	}
+	{
+		std::cout << "\n병렬 합집합, 교집합 (task_pool 4 threads)\n";
+		ft::task_pool pool(4);
+		ft::set<int> a, b, c, d;
+		for (int i = 0; i < 100000; i++) {
+			a.insert(a.end(), i * 2);
+			b.insert(b.end(), i * 3);
+		}
+		c = a;
+		d = b;
+		a.set_union(b, pool, 256);
+		c.set_intersection(d, pool, 256);
+		std::cout << "union: size = " << a.size() << ", last = " << *a.rbegin()
+			<< " / intersection: size = " << c.size() << ", last = " << *c.rbegin() << "\n";
+		a.tree_info();
+	}
+	{
+		std::cout << "\n병렬 집합 연산을 무작위로 순차와 비교하기 (grain 1 ~ 64)\n";
+		typedef ft::set<int, std::less<int>, ft::pool_allocator<int> >	pool_set;
+		unsigned x = 12345;
+		const size_t threads[] = { 1, 2, 4, 8 };
+		for (int t = 0; t < 4; t++) {
+			ft::task_pool pool(threads[t]);
+			int runs = 0;
+			int errors = 0;
+			for (int trial = 0; trial < 8; trial++) {
+				for (int op = 0; op < 3; op++) {
+					x ^= x << 13;
+					x ^= x >> 17;
+					x ^= x << 5;
+					size_t grain = (size_t)1 << (x % 7);
+					int na = x % 3000;
+					int nb = (x >> 12) % 3000;
+					int range = 1 + (x >> 8) % 6000;	// 좁으면 많이 겹친다
+					ft::set<int> a, b;
+					pool_set pa, pb;									// 서로 다른 pool (allocator가 다르다)
+					pool_set pc(std::less<int>(), pa.get_allocator());	// pa와 같은 pool
+					for (int i = 0; i < na; i++) {
+						x ^= x << 13;
+						x ^= x >> 17;
+						x ^= x << 5;
+						a.insert(x % range);
+						pa.insert(x % range);
+					}
+					for (int i = 0; i < nb; i++) {
+						x ^= x << 13;
+						x ^= x >> 17;
+						x ^= x << 5;
+						b.insert(x % range);
+						pb.insert(x % range);
+						pc.insert(x % range);
+					}
+					pool_set pa2(pa);
+					errors += check_set_op(a, b, op, pool, grain);
+					errors += check_set_op(pa, pb, op, pool, grain);
+					errors += check_set_op(pa2, pc, op, pool, grain);
+					runs += 3;
+				}
+			}
+			std::cout << threads[t] << " threads: runs = " << runs << ", errors = " << errors << "\n";
+		}
+	}
+	{
+		std::cout << "\n스냅샷 (persistent_map)\n";
+		ft::persistent_map<int, int> m;
+		for (int i = 0; i < 1000; i++)
+			m.insert(ft::make_pair(i, i * i));
+		ft::persistent_map<int, int> snap = m.snapshot();
+		for (int i = 0; i < 1000; i += 2)
+			m.erase(i);
+		m.insert_or_assign(1, -1);
+		m.insert(ft::make_pair(5000, 5));
+		std::cout << "now: size = " << m.size() << ", at(1) = " << m.at(1) << ", last = " << m.rbegin()->first
+			<< ", valid = " << m.is_valid() << "\n";
+		std::cout << "snapshot: size = " << snap.size() << ", at(1) = " << snap.at(1) << ", count(0) = " << snap.count(0)
+			<< ", last = " << snap.rbegin()->first << ", valid = " << snap.is_valid() << "\n";
+		int sum = 0;
+		for (ft::persistent_map<int, int>::const_iterator it = snap.lower_bound(10); it != snap.upper_bound(20); ++it)
+			sum += it->first;
+		std::cout << "snapshot sum of keys [10, 20] = " << sum << "\n";
+	}
+	{
+		std::cout << "\n스냅샷을 남기며 무작위로 바꾸기 (persistent_map vs map)\n";
+		srand(42);
+		ft::persistent_map<int, int> m;
+		ft::map<int, int> ref;
+		ft::vector<ft::persistent_map<int, int> > snaps;
+		ft::vector<ft::map<int, int> > refs;
+		int mismatches = 0;
+		for (int step = 0; step < 20000; step++) {
+			int k = rand() % 500;
+			int op = rand() % 3;
+			if (op == 0) {
+				m.insert(ft::make_pair(k, step));
+				ref.insert(ft::make_pair(k, step));
+			}
+			else if (op == 1) {
+				m.insert_or_assign(k, -step);
+				ref[k] = -step;
+			}
+			else if (m.erase(k) != ref.erase(k))
+				mismatches++;
+			if (step % 1000 == 0) {
+				snaps.push_back(m.snapshot());
+				refs.push_back(ref);
+			}
+		}
+		for (size_t i = 0; i < snaps.size(); i++) {
+			if (snaps[i].size() != refs[i].size() || !snaps[i].is_valid())
+				mismatches++;
+			ft::persistent_map<int, int>::const_iterator it = snaps[i].begin();
+			for (ft::map<int, int>::const_iterator r = refs[i].begin(); r != refs[i].end() && it != snaps[i].end(); ++r, ++it)
+				if (it->first != r->first || it->second != r->second)
+					mismatches++;
+		}
+		std::cout << "size = " << m.size() << " (map " << ref.size() << "), snapshots = " << snaps.size()
+			<< ", mismatches = " << mismatches << "\n";
+	}
+	{
+		std::cout << "\nshard로 나눈 concurrent_map\n";
+		ft::concurrent_map<int, int> m(8);
+		for (int i = 0; i < 100; i++)
+			m.insert(ft::make_pair(i * 7 % 100, i));
+		for (int i = 0; i < 100; i += 3)
+			m.erase(i);
+		m.insert_or_assign(1, -1);
+		int v = 0;
+		bool found = m.find(1, v);
+		std::cout << "shards = " << m.shard_count() << ", size = " << m.size() << ", find(1) = " << found << " " << v
+			<< ", count(3) = " << m.count(3) << "\n";
+		ft::concurrent_map<int, int>::ordered_view view(m);
+		std::cout << "ordered:";
+		int n = 0;
+		for (ft::concurrent_map<int, int>::ordered_view::const_iterator it = view.lower_bound(50); it != view.end() && n < 10; ++it, ++n)
+			std::cout << " " << it->first;
+		std::cout << "\n";
+	}
+	{
+		std::cout << "\n여러 thread가 같이 쓰는 concurrent_map\n";
+		ft::concurrent_map<int, int> m(16);
+		concurrent_worker workers[4];
+		concurrent_checker checker;
+		pthread_t threads[5];
+		checker.m = &m;
+		checker.views = 200;
+		for (int t = 0; t < 4; t++) {
+			workers[t].m = &m;
+			workers[t].id = t;
+			pthread_create(&threads[t], NULL, &concurrent_stress, &workers[t]);
+		}
+		pthread_create(&threads[4], NULL, &concurrent_check, &checker);
+		long errors = 0;
+		for (int t = 0; t < 4; t++) {
+			pthread_join(threads[t], NULL);
+			errors += workers[t].errors;
+		}
+		pthread_join(threads[4], NULL);
+		ft::map<int, int> expected;
+		for (int t = 0; t < 4; t++)
+			for (int i = 0; i < 256; i++)
+				if (workers[t].expect[i] != -1)
+					expected[t * 256 + i] = workers[t].expect[i];
+		bool same = (m.size() == expected.size());
+		ft::concurrent_map<int, int>::ordered_view view(m);
+		same = same && view.size() == expected.size();
+		ft::map<int, int>::const_iterator e = expected.begin();
+		for (ft::concurrent_map<int, int>::ordered_view::const_iterator it = view.begin(); same && it != view.end(); ++it, ++e)
+			same = (it->first == e->first && it->second == e->second);
+		std::cout << "worker errors = " << errors << ", view errors = " << checker.errors
+			<< ", size = " << view.size() << ", same as expected = " << same << "\n";
+	}
+	{
+		std::cout << "\nlock-free skiplist_map\n";
+		ft::skiplist_map<int, char> m;
+		for (int i = 0; i < 26; i++)
+			m.insert(ft::make_pair(i * 5 % 26, (char)('a' + i * 5 % 26)));
+		m.insert(ft::make_pair(3, '?'));
+		m.erase(0);
+		m.erase(m.find(25));
+		std::cout << "size = " << m.size() << ", count(3) = " << m.count(3) << ", find(3) = " << m.find(3)->second
+			<< ", lower_bound(10) = " << m.lower_bound(10)->second << ", upper_bound(10) = " << m.upper_bound(10)->second << "\n";
+		std::cout << "forward:";
+		for (ft::skiplist_map<int, char>::const_iterator it = m.begin(); it != m.end(); ++it)
+			std::cout << " " << it->second;
+		std::cout << "\nreverse:";
+		for (ft::skiplist_map<int, char>::const_reverse_iterator it = m.rbegin(); it != m.rend(); ++it)
+			std::cout << " " << it->second;
+		std::cout << "\n";
+	}
+	{
+		std::cout << "\n여러 thread가 같이 쓰는 skiplist_map\n";
+		ft::skiplist_map<int, int> m;
+		skiplist_worker workers[4];
+		pthread_t threads[4];
+		for (int t = 0; t < 4; t++) {
+			workers[t].m = &m;
+			workers[t].id = t;
+			pthread_create(&threads[t], NULL, &skiplist_stress, &workers[t]);
+		}
+		long errors = 0;
+		for (int t = 0; t < 4; t++) {
+			pthread_join(threads[t], NULL);
+			errors += workers[t].errors;
+		}
+		size_t walked = 0;
+		size_t expected = 0;
+		bool ordered = true;
+		bool contents = true;
+		int prev = -1;
+		for (ft::skiplist_map<int, int>::const_iterator it = m.begin(); it != m.end(); ++it, ++walked) {
+			if (it->first <= prev)
+				ordered = false;
+			if (it->first < 512 && !workers[it->first % 4].own[it->first])
+				contents = false;
+			prev = it->first;
+		}
+		for (int k = 0; k < 512; k++)
+			if (workers[k % 4].own[k]) {
+				expected++;
+				contents = contents && m.count(k);
+			}
+		size_t reversed = 0;
+		for (ft::skiplist_map<int, int>::const_reverse_iterator it = m.rbegin(); it != m.rend(); ++it)
+			reversed++;
+		std::cout << "errors = " << errors << ", ascending = " << ordered << ", size == walked = " << (m.size() == walked)
+			<< ", reverse == walked = " << (reversed == walked) << ", contents = " << contents << "\n";
+		m.erase(m.lower_bound(512), m.end());
+		std::cout << "without shared keys: size = " << m.size() << " (expected " << expected << ")\n";
+	}
+	{
+		std::cout << "\n정렬된 vector (flat_map, flat_set)\n";
+		ft::vector<ft::pair<int, char> > batch;
+		for (int i = 0; i < 26; i++)
+			batch.push_back(ft::make_pair(i * 7 % 26, (char)('a' + i * 7 % 26)));
+		batch.push_back(ft::make_pair(0, '?'));
+		ft::flat_map<int, char> m(batch.begin(), batch.end());
+		m.erase(25);
+		m[30] = '!';
+		m.insert(m.end(), ft::make_pair(31, '#'));
+		ft::flat_map<int, char>::const_iterator lo = m.lower_bound(10);
+		std::cout << "size = " << m.size() << ", m[0] = " << m[0] << ", lower_bound(10) = " << lo->second
+			<< ", upper_bound(10) = " << m.upper_bound(10)->second << ", end - begin = " << (m.end() - m.begin()) << "\n";
+		std::cout << "reverse:";
+		for (ft::flat_map<int, char>::reverse_iterator it = m.rbegin(); it != m.rend(); ++it)
+			std::cout << " " << it->second;
+		std::cout << "\n";
+		int keys[] = { 8, 3, 8, 1, 5, 3 };
+		ft::flat_set<int> s(keys, keys + 6);
+		s.insert(keys, keys + 6);
+		int more[] = { 4, 2, 9 };
+		s.insert(more, more + 3);
+		std::cout << "set:";
+		for (ft::flat_set<int>::const_iterator it = s.begin(); it != s.end(); ++it)
+			std::cout << " " << *it;
+		std::cout << ", count(4) = " << s.count(4) << "\n";
+	}
+	{
+		std::cout << "\nB-tree (btree_map, btree_set)\n";
+		ft::btree_map<int, int> m;
+		for (int i = 0; i < 2000; i++)
+			m[i * 7 % 2000] = i;
+		for (int i = 0; i < 2000; i += 3)
+			m.erase(i);
+		m.erase(m.find(1), m.find(400));
+		long sum = 0;
+		for (ft::btree_map<int, int>::const_iterator it = m.begin(); it != m.end(); ++it)
+			sum += (long)it->first * it->second;
+		ft::btree_map<int, int>::reverse_iterator rit = m.rbegin();
+		std::cout << "size = " << m.size() << ", begin = " << m.begin()->first << ", last = " << rit->first
+			<< ", lower_bound(600) = " << m.lower_bound(600)->first << ", upper_bound(601) = " << m.upper_bound(601)->first
+			<< ", sum = " << sum << "\n";
+		ft::vector<ft::pair<int, int> > sorted;
+		for (int i = 0; i < 1000; i++)
+			sorted.push_back(ft::make_pair(i / 2, i));
+		ft::btree_map<int, int> bulk(sorted.begin(), sorted.end());
+		ft::btree_map<int, int> copy(bulk);
+		copy.insert_or_assign(10, -1);
+		std::cout << "bulk size = " << bulk.size() << ", bulk[10] = " << bulk[10] << ", copy[10] = " << copy[10]
+			<< ", at(499) = " << copy.at(499) << "\n";
+		const char* words[] = { "pear", "fig", "apple", "kiwi", "fig", "plum" };
+		ft::btree_set<std::string> s(words, words + 6);
+		s.erase("kiwi");
+		std::cout << "set:";
+		for (ft::btree_set<std::string>::const_reverse_iterator it = s.rbegin(); it != s.rend(); ++it)
+			std::cout << " " << *it;
+		std::cout << ", count(fig) = " << s.count("fig") << "\n";
+	}
+	{
+		std::cout << "\n32 bit index로 잇는 tree (compact_map, compact_set)\n";
+		ft::compact_map<int, std::string> m;
+		m[7] = "seven";
+		ft::compact_map<int, std::string>::iterator seven = m.find(7);
+		for (int i = 0; i < 1000; i++)
+			m[i * 3 % 1000] = "x";
+		for (int i = 0; i < 1000; i += 2)
+			if (i != 7)
+				m.erase(i);
+		for (int i = 1000; i < 1100; i++)
+			m.insert(m.end(), ft::make_pair(i, std::string("y")));
+		std::cout << "size = " << m.size() << ", kept iterator = " << seven->first << " " << seven->second
+			<< ", lower_bound(500) = " << m.lower_bound(500)->first << ", last = " << m.rbegin()->first << "\n";
+		m.erase(m.find(1), m.find(991));
+		ft::compact_map<int, std::string> copy(m);
+		copy[0] = "zero";
+		std::cout << "after erase [1, 991): size = " << m.size() << ", copy size = " << copy.size() << ", copy:";
+		int shown = 0;
+		for (ft::compact_map<int, std::string>::const_iterator it = copy.begin(); it != copy.end() && shown < 5; ++it, ++shown)
+			std::cout << " " << it->first;
+		std::cout << "\n";
+		int keys[] = { 5, 1, 4, 1, 5, 9, 2, 6 };
+		ft::compact_set<int> s(keys, keys + 8);
+		s.erase(4);
+		std::cout << "set:";
+		for (ft::compact_set<int>::const_reverse_iterator it = s.rbegin(); it != s.rend(); ++it)
+			std::cout << " " << *it;
+		std::cout << ", count(9) = " << s.count(9) << "\n";
+	}
+	{
+		std::cout << "\n여러 key를 한 번에 찾기 (find_many)\n";
+		ft::set<int> s;
+		for (int i = 0; i < 1000; i++)
+			s.insert(i * 7 % 1000 * 2);
+		ft::vector<int> keys;
+		for (int i = 0; i < 45; i++)
+			keys.push_back(i * 37 % 101);
+		ft::vector<ft::set<int>::iterator> found(keys.size());
+		s.find_many(keys.begin(), keys.end(), found.begin());
+		int hits = 0, same = 0;
+		for (size_t i = 0; i < keys.size(); i++) {
+			hits += (found[i] != s.end());
+			same += (found[i] == s.find(keys[i]));
+		}
+		std::cout << "keys = " << keys.size() << ", hits = " << hits << ", same as find = " << same << ", found:";
+		for (size_t i = 0; i < 8; i++)
+			std::cout << " " << (found[i] == s.end() ? -1 : *found[i]);
+		std::cout << "\n";
+		ft::map<int, std::string> m;
+		m[3] = "three";
+		m[5] = "five";
+		const ft::map<int, std::string>& cm = m;
+		int mk[] = { 5, 4, 3 };
+		ft::map<int, std::string>::const_iterator out[3];
+		ft::map<int, std::string>::const_iterator* last = cm.find_many(mk, mk + 3, out);
+		std::cout << "map: " << out[0]->second << " " << (out[1] == cm.end() ? "end" : "?") << " " << out[2]->second
+			<< ", written = " << (last - out) << "\n";
+	}
+	{
+		std::cout << "\nstack으로 순회하기 (scan)\n";
+		ft::set<int> s;
+		for (int i = 0; i < 500; i++)
+			s.insert(i * 13 % 500);
+		sum_of_ints all = s.scan(sum_of_ints());
+		sum_of_ints part = s.scan(100, 200, sum_of_ints());
+		sum_of_ints none = s.scan(600, 700, sum_of_ints());
+		std::cout << "all: " << all.count << " " << all.sum << ", [100, 200): " << part.count << " " << part.sum
+			<< ", [600, 700): " << none.count << "\n";
+		ft::set<int, std::less<int>, std::allocator<int>, ft::BinarySearchTreeEngine> line;
+		for (int i = 299; i >= 0; i--)		// 왼쪽으로만 300단 깊이
+			line.insert(i);
+		sum_of_ints deep = line.scan(50, 250, sum_of_ints());
+		std::cout << "unbalanced [50, 250): " << deep.count << " " << deep.sum << "\n";
+		ft::map<int, int> m;
+		for (int i = 0; i < 10; i++)
+			m[i] = i;
+		m.scan(3, 6, double_mapped());
+		std::cout << "map:";
+		for (ft::map<int, int>::const_iterator it = m.begin(); it != m.end(); ++it)
+			std::cout << " " << it->second;
+		std::cout << "\n";
+	}
+	{
+		std::cout << "\n한 번 만들고 찾기만 하는 set, map (static_set, static_map)\n";
+		ft::set<int> src;
+		for (int i = 0; i < 1000; i++)
+			src.insert(i * 7 % 1000 * 3 - 1500);
+		ft::static_set<int> s(ft::sorted_unique, src.begin(), src.end());
+		std::cout << "size = " << s.size() << ", count(-3) = " << s.count(-3) << ", count(-2) = " << s.count(-2)
+			<< ", lower_bound(1) = " << *s.lower_bound(1) << ", upper_bound(3) = " << *s.upper_bound(3)
+			<< ", last = " << *s.rbegin() << ", find(1500) == end: " << (s.find(1500) == s.end()) << "\n";
+		int raw[] = { 42, 7, 19, 7, -5 };
+		ft::static_set<int> small(raw, raw + 5);
+		std::cout << "set:";
+		for (ft::static_set<int>::const_iterator it = small.begin(); it != small.end(); ++it)
+			std::cout << " " << *it;
+		std::cout << "\n";
+		ft::map<std::string, int> names;
+		names["kiwi"] = 3;
+		names["apple"] = 1;
+		names["mango"] = 2;
+		ft::static_map<std::string, int> table(ft::sorted_unique, names.begin(), names.end());
+		ft::static_map<std::string, int> copy(table);
+		std::cout << "map: at(mango) = " << copy.at("mango") << ", count(pear) = " << copy.count("pear")
+			<< ", lower_bound(b) = " << copy.lower_bound("b")->first << "\n";
+		try {
+			copy.at("pear");
+		} catch (std::out_of_range& e) { std::cout << "out_of_range error: " << e.what() << "\n"; }
+	}
+#endif
+
+	{
+		std::cout << "\nunordered_map, unordered_set\n";
+		ft::unordered_map<int, int> m;
+		for (int i = 0; i < 1000; i++)
+			m[i * 7 % 1000] += i;
+		for (int i = 0; i < 1000; i += 3)
+			m.erase(i);
+		m.insert(ft::make_pair(5, -5));
+		m.insert(ft::make_pair(2000, 2));
+		ft::unordered_map<int, int>::iterator it = m.find(4);
+		it->second = 44;
+		long sum = 0;
+		for (ft::unordered_map<int, int>::const_iterator cit = m.begin(); cit != m.end(); ++cit)
+			sum += (long)cit->first * cit->second;
+		ft::unordered_map<int, int> copy(m);
+		copy.erase(copy.find(2000));
+		std::cout << "size = " << m.size() << ", count(3) = " << m.count(3) << ", m[4] = " << m[4] << ", at(5) = " << m.at(5)
+			<< ", sum = " << sum << ", copy size = " << copy.size() << ", copy.count(2000) = " << copy.count(2000) << "\n";
+		try {
+			m.at(3);
+		} catch (std::out_of_range& e) {
+			std::cout << "at(3) : out_of_range\n";
+		}
+		ft::unordered_set<std::string> s;
+		const char* words[] = { "red", "green", "blue", "green", "red", "cyan" };
+		for (int i = 0; i < 6; i++)
+			s.insert(words[i]);
+		s.erase("blue");
+		int odd = 0;
+		ft::unordered_set<int> nums;
+		for (int i = 0; i < 500; i++)
+			nums.insert(i * i % 101);
+		for (ft::unordered_set<int>::iterator nit = nums.begin(); nit != nums.end(); ) {
+			if (*nit % 2)
+				nit = nums.erase(nit);
+			else
+				++nit;
+		}
+		for (ft::unordered_set<int>::iterator nit = nums.begin(); nit != nums.end(); ++nit)
+			odd += *nit % 2;
+		std::cout << "words = " << s.size() << ", count(red) = " << s.count("red") << ", count(blue) = " << s.count("blue")
+			<< ", even squares mod 101 = " << nums.size() << ", odd left = " << odd << "\n";
+	}
 	{
 		ft::set<int> s;
 		std::cout << "랜덤한 숫자를 100만번 삽입\n";
@@ -5,15 +5,20 @@
 # include <memory> // allocator
 # include <limits> // numeric_limits, max
 # include <cstddef> // ptrdiff_t
+# include <iterator> // iterator tags, distance
 # include "utils/pair.hpp"
 # include "tree_iterator.hpp"
+# include "utils/RB_Tree.hpp"
 # include "utils/Binary_Search_Tree.hpp"
 # include "utils/reverse_iterator.hpp"
 # include "utils/iterators_traits.hpp"
+# include "utils/key_of_value.hpp"
 
 namespace ft {
 
-template <typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<ft::pair<const Key,T> > >
+/* Tree : 원소를 저장할 tree engine. 기본값은 RB_Tree이고, ft::BinarySearchTreeEngine으로 바꿀 수 있다. */
+template <typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<ft::pair<const Key,T> >,
+			typename Tree = ft::RB_TreeEngine>
 class map {
 	public:
 		typedef Key										key_type;
@@ -21,7 +26,7 @@ class map {
 		typedef ft::pair<const Key, T>					value_type;
 		typedef Compare									key_compare;
 		class	value_compare {
-			friend class map<Key, T, Compare, Alloc>;
+			friend class map<Key, T, Compare, Alloc, Tree>;
 			protected:
 				Compare comp;
 				value_compare (Compare c) : comp(c) { }
@@ -43,21 +48,32 @@ class map {
 		typedef size_t									size_type;
 
 	private:
-		BinarySearchTree<value_type, value_compare, Alloc> _bst;
+		typedef nodeBase<value_type>		node;
+		typedef typename Tree::template rebind<key_type, value_type, ft::select1st<value_type>, key_compare, Alloc>::other	tree_type;
+
+		tree_type _bst;
 		key_compare _comp;
 		allocator_type _alloc;
 
 	public:
 		// default Ctor
 		map(const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
-			: _bst(value_compare(comp), alloc), _comp(comp), _alloc(alloc) { }
+			: _bst(comp, alloc), _comp(comp), _alloc(alloc) { }
 
 		// range Ctor
+		// sorted input (checked in one pass when the iterators allow it) is built in O(n) instead of n inserts.
 		template<typename InputIterator>
 		map(InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
-			: _bst(value_compare(comp), alloc), _comp(comp), _alloc(alloc) {
-				while (first != last)
-					insert(first++);
+			: _bst(comp, alloc), _comp(comp), _alloc(alloc) {
+				_range_init(first, last, typename ft::iterator_traits<InputIterator>::iterator_category());
+		}
+
+		// sorted range Ctor : [first, last) must be sorted by key with no duplicates. O(n).
+		template<typename ForwardIterator>
+		map(ft::sorted_unique_t, ForwardIterator first, ForwardIterator last,
+			const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _bst(comp, alloc), _comp(comp), _alloc(alloc) {
+				_bst.build_sorted(first, last, std::distance(first, last));
 		}
 
 		// copy Ctor
@@ -90,36 +106,65 @@ class map {
 
 		// if k matches the key, returns a reference to its mapped value.
 		// if not, inserts a new element with that key and returns a reference to its mapped value.
+		// The tree is descended only once either way, and mapped_type() is built only on a miss.
 		mapped_type& operator[](const key_type& k) {
-			iterator tmp = _bst.find(k);
-			if (tmp == end())
-				tmp = insert(k).first;
-			return (*tmp).second;
+			typename tree_type::position pos = _bst.locate(k);
+			if (pos.found == NULL)
+				pos.found = _bst.insert_at(pos, value_type(k, mapped_type()));
+			return pos.found->value.second;
+		}
+
+		// if k is not present, inserts (k, obj). if it is, does nothing (obj is not used).
+		ft::pair<iterator,bool>	try_emplace(const key_type& k, const mapped_type& obj) {
+			typename tree_type::position pos = _bst.locate(k);
+			if (pos.found)
+				return ft::make_pair(iterator(pos.found), false);
+			return ft::make_pair(iterator(_bst.insert_at(pos, value_type(k, obj))), true);
+		}
+
+		// if k is not present, inserts (k, obj). if it is, assigns obj to its mapped value.
+		// second of the result is true if a new element was inserted.
+		ft::pair<iterator,bool>	insert_or_assign(const key_type& k, const mapped_type& obj) {
+			typename tree_type::position pos = _bst.locate(k);
+			if (pos.found) {
+				pos.found->value.second = obj;
+				_bst.value_changed(pos.found);		// aggregating engines recompute the path
+				return ft::make_pair(iterator(pos.found), false);
+			}
+			return ft::make_pair(iterator(_bst.insert_at(pos, value_type(k, obj))), true);
+		}
+
+		// calls fn(mapped value of k), then aggregating engines recompute the path. false if k is not present.
+		template <typename Function>
+		bool	update(const key_type& k, Function fn) {
+			typename tree_type::node* n = _bst.find(k);
+			if (n == _bst.end())
+				return false;
+			fn(n->value.second);
+			_bst.value_changed(n);
+			return true;
 		}
 
+		// after writing a mapped value through operator[] or an iterator, tells aggregating engines to recompute the path. O(log n)
+		void	value_changed(iterator position) { _bst.value_changed(position._node); }
+
 		// insert single element
 		ft::pair<iterator,bool>	insert(const value_type& val) {
-			size_type before = _bst.getSize();
-			iterator pos = _bst.insert(val);
-			size_type after = _bst.getSize();
-			return ft::make_pair<iterator, bool>(pos, before!=after);
+			ft::pair<node*, bool> ret = _bst.insert(val);
+			return ft::make_pair(iterator(ret.first), ret.second);
 		}
 
 		// insert with hint
 		iterator				insert(iterator position, const value_type& val) {
-			// if (position->second < val) // if hint is valid
-			if ( _comp(position, val) )
-				return _bst.insert(position._node, val);
-			else
-				return _bst.insert(val);
+			return iterator(_bst.insert(position._node, val));
 		}
 
 		// insert range
 		template <class InputIterator>
 		void					insert(InputIterator first, InputIterator last) {
-			difference_type n = std::distance(first, last);
-			while (n--)
-				insert(*(first++));
+			// hint end(): an ascending range is appended without descending the tree.
+			while (first != last)
+				insert(end(), *first++);
 		}
 
 		void		erase(iterator position) {
@@ -127,16 +172,11 @@ class map {
 		}
 
 		size_type	erase(const key_type& k) {
-			size_type before = _bst.getSize();
-			_bst.erase(k);
-			size_type after = _bst.getSize();
-			return after - before;
+			return _bst.erase(k);
 		}
 
 		void		erase(iterator first, iterator last) {
-			while (first != last) {
-				erase((first++._node));
-			}
+			_bst.erase(first._node, last._node);
 		}
 
 		void		swap(map& x) {
@@ -154,51 +194,102 @@ class map {
 
 
 		iterator 		find(const key_type& k)			{ return iterator(_bst.find(k)); }
-		const_iterator	find(const key_type& k) const	{ return iterator(_bst.find(k)); }
+		const_iterator	find(const key_type& k) const	{ return const_iterator(_bst.find(k)); }
 
-		size_type		count(const key_type& k) const {
-			if (find(k) == end())
-				return 1;
-			return 0;
+		// find() for every key of [keys_first, keys_last), written to out in the same order. Returns the end of out.
+		// Descents go in groups, prefetching each next node, so their cache misses overlap. keys must be a forward range.
+		template <typename ForwardIterator, typename OutputIterator>
+		OutputIterator	find_many(ForwardIterator keys_first, ForwardIterator keys_last, OutputIterator out) {
+			return _bst.template find_many<iterator>(keys_first, keys_last, out);
 		}
-
-		iterator		lower_bound(const key_type& k) {
-			iterator it = begin();
-			while (it != end()) {
-				if ( ! _comp(it->first, k) )	// return if   it->first >= k
-					break;
-				it++;
-			}
-			return it;
+		template <typename ForwardIterator, typename OutputIterator>
+		OutputIterator	find_many(ForwardIterator keys_first, ForwardIterator keys_last, OutputIterator out) const {
+			return _bst.template find_many<const_iterator>(keys_first, keys_last, out);
 		}
 
-		const_iterator	lower_bound(const key_type& k) const {
-			return const_iterator(lower_bound(k));
+		// fn(value) for every element in key order, or only for those whose key is in [lo, hi). Returns fn.
+		// Faster than a loop of ++it: the walk keeps its path on a stack and prefetches the subtree it visits next.
+		// fn may change mapped values but must not insert or erase.
+		template <typename Function>
+		Function	scan(Function fn)	{ _bst.template scan<value_type&>(NULL, NULL, fn); return fn; }
+		template <typename Function>
+		Function	scan(Function fn) const	{ _bst.template scan<const value_type&>(NULL, NULL, fn); return fn; }
+		template <typename Function>
+		Function	scan(const key_type& lo, const key_type& hi, Function fn) {
+			_bst.template scan<value_type&>(&lo, &hi, fn);
+			return fn;
 		}
-
-		iterator		upper_bound(const key_type& k) {
-			iterator it = begin();
-			while (it != end()) {
-				if ( _comp(k, it->first) )		// return if   it->first > k
-					break;
-				it++;
-			}
-			return it;
+		template <typename Function>
+		Function	scan(const key_type& lo, const key_type& hi, Function fn) const {
+			_bst.template scan<const value_type&>(&lo, &hi, fn);
+			return fn;
 		}
 
-		const_iterator	upper_bound(const key_type& k) const {
-			return const_iterator(upper_bound(k));
+		size_type		count(const key_type& k) const {
+			if (_bst.find(k) == _bst.end())
+				return 0;
+			return 1;
 		}
 
+		iterator		lower_bound(const key_type& k)			{ return iterator(_bst.lower_bound(k)); }
+		const_iterator	lower_bound(const key_type& k) const	{ return const_iterator(_bst.lower_bound(k)); }
+
+		iterator		upper_bound(const key_type& k)			{ return iterator(_bst.upper_bound(k)); }
+		const_iterator	upper_bound(const key_type& k) const	{ return const_iterator(_bst.upper_bound(k)); }
+
+		// key는 중복되지 않으므로, lower_bound가 k 자신이면 그 다음 원소가 upper_bound다.
 		ft::pair<iterator,iterator>				equal_range(const key_type& k) {
-			return ft::make_pair(lower_bound(k), upper_bound(k));
+			iterator first = lower_bound(k);
+			iterator last = first;
+			if (last != end() && !_comp(k, last->first))
+				++last;
+			return ft::make_pair(first, last);
 		}
 		ft::pair<const_iterator,const_iterator>	equal_range(const key_type& k) const {
-			return ft::make_pair(lower_bound(k), upper_bound(k));
+			const_iterator first = lower_bound(k);
+			const_iterator last = first;
+			if (last != end() && !_comp(k, last->first))
+				++last;
+			return ft::make_pair(first, last);
+		}
+
+		// order statistics, O(log n). Only with Tree = ft::OrderStatisticEngine.
+		// k-th element (from 0) in key order. end() if k >= size()
+		iterator		nth(size_type k)				{ return iterator(_bst.nth(k)); }
+		const_iterator	nth(size_type k) const			{ return const_iterator(_bst.nth(k)); }
+		// number of elements whose key is less than k
+		size_type		rank(const key_type& k) const	{ return _bst.rank(k); }
+		// number of elements whose key is in [lo, hi)
+		size_type		count_range(const key_type& lo, const key_type& hi) const {
+			size_type l = _bst.rank(lo);
+			size_type h = _bst.rank(hi);
+			return (h > l) ? h - l : 0;
+		}
+		// std::distance(begin(), pos) without walking
+		size_type		index_of(const_iterator pos) const	{ return _bst.index_of(pos._node); }
+
+		// mapped values of the elements whose key is in [lo, hi), combined in key order by Monoid, O(log n).
+		// Only with Tree = ft::AugmentedRB_TreeEngine<ft::monoid_augment<Monoid> >.
+		// Change mapped values with insert_or_assign or update. After writing through operator[] or an iterator, call value_changed.
+		typename tree_type::augment_type	aggregate(const key_type& lo, const key_type& hi) const {
+			return _bst.aggregate(lo, hi);
 		}
 
 		allocator_type	get_allocator() const { return _alloc; }
 
+	private:
+		template <typename InputIterator>
+		void	_range_init(InputIterator first, InputIterator last, std::input_iterator_tag) {
+			while (first != last)
+				insert(end(), *first++);
+		}
+
+		template <typename ForwardIterator>
+		void	_range_init(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag) {
+			if (!_bst.build_if_sorted(first, last))
+				_range_init(first, last, std::input_iterator_tag());
+		}
+
 };
 
 
@@ -0,0 +1,178 @@
+#ifndef PERSISTENT_MAP_HPP
+# define PERSISTENT_MAP_HPP
+
+# include <functional> // less
+# include <memory> // allocator
+# include <limits> // numeric_limits, max
+# include <cstddef> // ptrdiff_t
+# include <stdexcept> // out_of_range
+# include "utils/pair.hpp"
+# include "utils/persistent_tree.hpp"
+# include "utils/reverse_iterator.hpp"
+# include "utils/key_of_value.hpp"
+
+namespace ft {
+
+/* A map whose copies share structure (see utils/persistent_tree.hpp).
+ * snapshot() and the copy Ctor are O(1). insert/erase copy only the O(log n) path they change,
+ * so a snapshot keeps seeing the elements it had when it was taken while the original keeps changing.
+ * Elements are read-only through iterators: they may be shared with other snapshots.
+ * insert/erase invalidate iterators of this map only. Snapshots and their iterators are not affected.
+ * Different snapshots may be used and destroyed from different threads. One map object is not thread-safe. */
+template <typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<ft::pair<const Key,T> > >
+class persistent_map {
+	public:
+		typedef Key										key_type;
+		typedef T										mapped_type;
+		typedef ft::pair<const Key, T>					value_type;
+		typedef Compare									key_compare;
+		class	value_compare {
+			friend class persistent_map<Key, T, Compare, Alloc>;
+			protected:
+				Compare comp;
+				value_compare (Compare c) : comp(c) { }
+			public:
+				bool operator() (const value_type& x, const value_type& y) const {
+					return (comp(x.first, y.first));
+				}
+		};
+		typedef Alloc									allocator_type;
+		typedef typename Alloc::const_reference			reference;
+		typedef typename Alloc::const_reference			const_reference;
+		typedef typename Alloc::const_pointer			pointer;
+		typedef typename Alloc::const_pointer			const_pointer;
+		typedef persistent_iterator<value_type>			iterator;
+		typedef persistent_iterator<value_type>			const_iterator;
+		typedef ft::reverse_iterator<iterator>			reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+		typedef ptrdiff_t								difference_type;
+		typedef size_t									size_type;
+
+	private:
+		typedef PersistentTree<key_type, value_type, ft::select1st<value_type>, key_compare, Alloc>	tree_type;
+
+		tree_type _tree;
+		key_compare _comp;
+		allocator_type _alloc;
+
+	public:
+		// default Ctor
+		persistent_map(const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _tree(comp, alloc), _comp(comp), _alloc(alloc) { }
+
+		// range Ctor
+		template<typename InputIterator>
+		persistent_map(InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _tree(comp, alloc), _comp(comp), _alloc(alloc) {
+				insert(first, last);
+		}
+
+		// copy Ctor : O(1), shares every node with other
+		persistent_map(const persistent_map& other) : _tree(other._tree), _comp(other._comp), _alloc(other._alloc) { }
+
+		persistent_map& operator=(const persistent_map& rhs) {
+			_tree = rhs._tree;
+			_comp = rhs._comp;
+			_alloc = rhs._alloc;
+			return *this;
+		}
+
+		// Dtor : drops the reference to the root. nodes no other snapshot uses are freed.
+		~persistent_map() { }
+
+		// a point-in-time view that later changes to *this do not affect. O(1).
+		persistent_map	snapshot() const { return *this; }
+
+		// Iterators
+		const_iterator	begin() const	{ return _tree.begin(); }
+		const_iterator	end() const		{ return _tree.end(); }
+
+		const_reverse_iterator	rbegin() const	{ return const_reverse_iterator(end()); }
+		const_reverse_iterator	rend() const	{ return const_reverse_iterator(begin()); }
+
+		// Capacity
+		bool		empty()		const { return (_tree.getSize() == 0); }
+		size_type	size()		const { return _tree.getSize(); }
+		size_type	max_size()	const { return std::numeric_limits<difference_type>::max() / sizeof(T); }
+
+		// there is no operator[] : it would hand out a writable reference into a node that snapshots may share.
+		// throws std::out_of_range if k is not present.
+		const mapped_type&	at(const key_type& k) const {
+			const_iterator it = find(k);
+			if (it == end())
+				throw std::out_of_range("persistent_map::at");
+			return it->second;
+		}
+
+		// insert single element
+		ft::pair<iterator,bool>	insert(const value_type& val) {
+			bool inserted = _tree.insert(val, false);
+			return ft::make_pair(find(val.first), inserted);
+		}
+
+		// insert range
+		template <class InputIterator>
+		void					insert(InputIterator first, InputIterator last) {
+			while (first != last)
+				_tree.insert(*first++, false);
+		}
+
+		// if k is not present, inserts (k, obj). if it is, replaces its mapped value with obj.
+		// second of the result is true if a new element was inserted.
+		ft::pair<iterator,bool>	insert_or_assign(const key_type& k, const mapped_type& obj) {
+			bool inserted = _tree.insert(value_type(k, obj), true);
+			return ft::make_pair(find(k), inserted);
+		}
+
+		void		erase(iterator position) {
+			key_type k = position->first;		// position's node may be freed on the way down
+			_tree.erase(k);
+		}
+
+		size_type	erase(const key_type& k) {
+			return _tree.erase(k);
+		}
+
+		void		erase(iterator first, iterator last) {
+			persistent_map keep(*this);		// keeps the nodes first and last walk over alive while *this changes
+			for (; first != last; ++first)
+				_tree.erase(first->first);
+		}
+
+		void		swap(persistent_map& x) {
+			_tree.swap(x._tree);
+			std::swap(_comp, x._comp);
+			std::swap(_alloc, x._alloc);
+		}
+
+		void		clear() {
+			_tree.clear();
+		}
+
+		key_compare		key_comp() const	{ return _comp; }
+		value_compare	value_comp() const	{ return value_compare(_comp); }
+
+		const_iterator	find(const key_type& k) const	{ return _tree.find(k); }
+
+		size_type		count(const key_type& k) const	{ return _tree.contains(k) ? 1 : 0; }
+
+		const_iterator	lower_bound(const key_type& k) const	{ return _tree.bound(k, false); }
+		const_iterator	upper_bound(const key_type& k) const	{ return _tree.bound(k, true); }
+
+		ft::pair<const_iterator,const_iterator>	equal_range(const key_type& k) const {
+			const_iterator first = lower_bound(k);
+			const_iterator last = first;
+			if (last != end() && !_comp(k, last->first))
+				++last;
+			return ft::make_pair(first, last);
+		}
+
+		allocator_type	get_allocator() const { return _alloc; }
+
+		// AVL invariants and key order (for tests)
+		bool	is_valid() const { return _tree.isBalanced(); }
+};
+
+
+}
+#endif
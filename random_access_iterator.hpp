@@ -24,6 +24,9 @@ class random_access_iterator {
 		random_access_iterator(pointer ptr) : _p(ptr) {}
 		~random_access_iterator() {}
 		random_access_iterator(const random_access_iterator &other) : _p(other._p) {}
+		// iterator -> const_iterator (U* must convert to T*)
+		template <typename U>
+		random_access_iterator(const random_access_iterator<U> &other) : _p(other.base()) {}
 		random_access_iterator &operator=(const random_access_iterator &rhs) {
 			_p = rhs._p;
 			return *this;
@@ -37,6 +40,10 @@ class random_access_iterator {
 			return _p;
 		}
 
+		pointer base() const {
+			return _p;
+		}
+
 		random_access_iterator &operator++() {
 			_p++;
 			return *this;
@@ -5,16 +5,20 @@
 # include <memory> // allocator
 # include <limits> // numeric_limits, max
 # include <cstddef> // ptrdiff_t
+# include <iterator> // iterator tags, distance
 # include "tree_iterator.hpp"
 # include "utils/pair.hpp"
 # include "utils/RB_Tree.hpp"
+# include "utils/Binary_Search_Tree.hpp"
 # include "utils/reverse_iterator.hpp"
 # include "utils/iterators_traits.hpp"
+# include "utils/key_of_value.hpp"
 # include <iostream>
 
 namespace ft {
 
-template <typename T, typename Compare = std::less<T>, typename Alloc = std::allocator<T> >
+/* Tree : 원소를 저장할 tree engine. 기본값은 RB_Tree이고, ft::BinarySearchTreeEngine으로 바꿀 수 있다. */
+template <typename T, typename Compare = std::less<T>, typename Alloc = std::allocator<T>, typename Tree = ft::RB_TreeEngine>
 class set {
 	public:
 		typedef T										key_type;
@@ -34,7 +38,10 @@ class set {
 		typedef size_t									size_type;
 
 	private:
-		RB_Tree<value_type, value_compare, Alloc> _bst;
+		typedef nodeBase<value_type>		node;
+		typedef typename Tree::template rebind<key_type, value_type, ft::identity<value_type>, key_compare, Alloc>::other	tree_type;
+
+		tree_type _bst;
 		key_compare _comp;
 		allocator_type _alloc;
 
@@ -44,11 +51,19 @@ class set {
 			: _bst(value_compare(comp), alloc), _comp(comp), _alloc(alloc) { }
 
 		// range Ctor
+		// sorted input (checked in one pass when the iterators allow it) is built in O(n) instead of n inserts.
 		template<typename InputIterator>
 		set(InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
 			: _bst(value_compare(comp), alloc), _comp(comp), _alloc(alloc) {
-				while (first != last)
-					insert(first++);
+				_range_init(first, last, typename ft::iterator_traits<InputIterator>::iterator_category());
+		}
+
+		// sorted range Ctor : [first, last) must be sorted by key with no duplicates. O(n).
+		template<typename ForwardIterator>
+		set(ft::sorted_unique_t, ForwardIterator first, ForwardIterator last,
+			const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _bst(value_compare(comp), alloc), _comp(comp), _alloc(alloc) {
+				_bst.build_sorted(first, last, std::distance(first, last));
 		}
 
 		// copy Ctor
@@ -81,27 +96,21 @@ class set {
 
 		// insert single element
 		ft::pair<iterator,bool>	insert(const value_type& val) {
-			size_type before = _bst.getSize();
-			iterator pos = _bst.insert(val);
-			size_type after = _bst.getSize();
-			return ft::make_pair<iterator, bool>(pos, before!=after);
+			ft::pair<node*, bool> ret = _bst.insert(val);
+			return ft::make_pair(iterator(ret.first), ret.second);
 		}
 
 		// insert with hint
 		iterator				insert(iterator position, const value_type& val) {
-			// if (position->second < val) // if hint is valid
-			if ( _comp(position, val) )
-				return _bst.insert(position._node, val);
-			else
-				return _bst.insert(val);
+			return iterator(_bst.insert(position._node, val));
 		}
 
 		// insert range
 		template <class InputIterator>
 		void					insert(InputIterator first, InputIterator last) {
-			difference_type n = std::distance(first, last);
-			while (n--)
-				insert(*(first++));
+			// hint end(): an ascending range is appended without descending the tree.
+			while (first != last)
+				insert(end(), *first++);
 		}
 
 		void		erase(iterator position) {
@@ -109,16 +118,30 @@ class set {
 		}
 
 		size_type	erase(const key_type& k) {
-			size_type before = _bst.getSize();
-			_bst.erase(k);
-			size_type after = _bst.getSize();
-			return after - before;
+			return _bst.erase(k);
 		}
 
 		void		erase(iterator first, iterator last) {
-			while (first != last) {
-				erase((first++._node));
-			}
+			_bst.erase(first._node, last._node);
+		}
+
+		// set algebra with the elements of x, which is left empty (nodes are moved, not copied).
+		// O(m log(n/m + 1)) for sizes m <= n, plus freeing what drops out. Only with RB_Tree engines.
+		// on equal keys the element of *this is kept.
+		void		set_union(set& x)				{ _bst.set_union(x._bst); }
+		void		set_intersection(set& x)		{ _bst.set_intersection(x._bst); }
+		void		set_difference(set& x)			{ _bst.set_difference(x._bst); }
+
+		// same, split across the threads of pool. Parts smaller than about grain elements are not split further.
+		// falls back to one thread if the allocator is not thread-safe (ft::allocator_thread_safe).
+		void		set_union(set& x, ft::task_pool& pool, size_type grain = tree_type::parallel_grain) {
+			_bst.set_union(x._bst, pool, grain);
+		}
+		void		set_intersection(set& x, ft::task_pool& pool, size_type grain = tree_type::parallel_grain) {
+			_bst.set_intersection(x._bst, pool, grain);
+		}
+		void		set_difference(set& x, ft::task_pool& pool, size_type grain = tree_type::parallel_grain) {
+			_bst.set_difference(x._bst, pool, grain);
 		}
 
 		void		swap(set& x) {
@@ -136,52 +159,95 @@ class set {
 
 
 		iterator 		find(const key_type& k)			{ return iterator(_bst.find(k)); }
-		const_iterator	find(const key_type& k) const	{ return iterator(_bst.find(k)); }
+		const_iterator	find(const key_type& k) const	{ return const_iterator(_bst.find(k)); }
 
-		size_type		count(const key_type& k) const {
-			if (find(k) == end())
-				return 1;
-			return 0;
+		// find() for every key of [keys_first, keys_last), written to out in the same order. Returns the end of out.
+		// Descents go in groups, prefetching each next node, so their cache misses overlap. keys must be a forward range.
+		template <typename ForwardIterator, typename OutputIterator>
+		OutputIterator	find_many(ForwardIterator keys_first, ForwardIterator keys_last, OutputIterator out) {
+			return _bst.template find_many<iterator>(keys_first, keys_last, out);
 		}
-
-		iterator		lower_bound(const key_type& k) {
-			iterator it = begin();
-			while (it != end()) {
-				if ( ! _comp(it->first, k) )	// return if   it->first >= k
-					break;
-				it++;
-			}
-			return it;
+		template <typename ForwardIterator, typename OutputIterator>
+		OutputIterator	find_many(ForwardIterator keys_first, ForwardIterator keys_last, OutputIterator out) const {
+			return _bst.template find_many<const_iterator>(keys_first, keys_last, out);
 		}
 
-		const_iterator	lower_bound(const key_type& k) const {
-			return const_iterator(lower_bound(k));
+		// fn(value) for every element in key order, or only for those in [lo, hi). Returns fn.
+		// Faster than a loop of ++it: the walk keeps its path on a stack and prefetches the subtree it visits next.
+		// fn must not insert or erase.
+		template <typename Function>
+		Function	scan(Function fn) const	{ _bst.template scan<const value_type&>(NULL, NULL, fn); return fn; }
+		template <typename Function>
+		Function	scan(const key_type& lo, const key_type& hi, Function fn) const {
+			_bst.template scan<const value_type&>(&lo, &hi, fn);
+			return fn;
 		}
 
-		iterator		upper_bound(const key_type& k) {
-			iterator it = begin();
-			while (it != end()) {
-				if ( _comp(k, it->first) )		// return if   it->first > k
-					break;
-				it++;
-			}
-			return it;
+		size_type		count(const key_type& k) const {
+			if (_bst.find(k) == _bst.end())
+				return 0;
+			return 1;
 		}
 
-		const_iterator	upper_bound(const key_type& k) const {
-			return const_iterator(upper_bound(k));
-		}
+		iterator		lower_bound(const key_type& k)			{ return iterator(_bst.lower_bound(k)); }
+		const_iterator	lower_bound(const key_type& k) const	{ return const_iterator(_bst.lower_bound(k)); }
+
+		iterator		upper_bound(const key_type& k)			{ return iterator(_bst.upper_bound(k)); }
+		const_iterator	upper_bound(const key_type& k) const	{ return const_iterator(_bst.upper_bound(k)); }
 
+		// key는 중복되지 않으므로, lower_bound가 k 자신이면 그 다음 원소가 upper_bound다.
 		ft::pair<iterator,iterator>				equal_range(const key_type& k) {
-			return ft::make_pair(lower_bound(k), upper_bound(k));
+			iterator first = lower_bound(k);
+			iterator last = first;
+			if (last != end() && !_comp(k, *last))
+				++last;
+			return ft::make_pair(first, last);
 		}
 		ft::pair<const_iterator,const_iterator>	equal_range(const key_type& k) const {
-			return ft::make_pair(lower_bound(k), upper_bound(k));
+			const_iterator first = lower_bound(k);
+			const_iterator last = first;
+			if (last != end() && !_comp(k, *last))
+				++last;
+			return ft::make_pair(first, last);
+		}
+
+		// order statistics, O(log n). Only with Tree = ft::OrderStatisticEngine.
+		// k-th element (from 0) in key order. end() if k >= size()
+		iterator		nth(size_type k)				{ return iterator(_bst.nth(k)); }
+		const_iterator	nth(size_type k) const			{ return const_iterator(_bst.nth(k)); }
+		// number of elements whose key is less than k
+		size_type		rank(const key_type& k) const	{ return _bst.rank(k); }
+		// number of elements whose key is in [lo, hi)
+		size_type		count_range(const key_type& lo, const key_type& hi) const {
+			size_type l = _bst.rank(lo);
+			size_type h = _bst.rank(hi);
+			return (h > l) ? h - l : 0;
+		}
+		// std::distance(begin(), pos) without walking
+		size_type		index_of(const_iterator pos) const	{ return _bst.index_of(pos._node); }
+
+		// elements in [lo, hi) combined in order by Monoid, O(log n).
+		// Only with Tree = ft::AugmentedRB_TreeEngine<ft::monoid_augment<Monoid> >.
+		typename tree_type::augment_type	aggregate(const key_type& lo, const key_type& hi) const {
+			return _bst.aggregate(lo, hi);
 		}
 
 		allocator_type	get_allocator() const { return _alloc; }
 
+	private:
+		template <typename InputIterator>
+		void	_range_init(InputIterator first, InputIterator last, std::input_iterator_tag) {
+			while (first != last)
+				insert(end(), *first++);
+		}
 
+		template <typename ForwardIterator>
+		void	_range_init(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag) {
+			if (!_bst.build_if_sorted(first, last))
+				_range_init(first, last, std::input_iterator_tag());
+		}
+
+	public:
 		void tree_info() const {
 			std::cout << std::boolalpha << "2. root가 블랙인가? " << _bst.isRootBlack() << "\n";
 			std::cout << "4. 중복된 red가 없는가? " << !(_bst.isRedDup(_bst._root)) << "\n";
@@ -0,0 +1,175 @@
+#ifndef SKIPLIST_MAP_HPP
+# define SKIPLIST_MAP_HPP
+
+# include <functional> // less
+# include <memory> // allocator
+# include <limits> // numeric_limits, max
+# include <cstddef> // ptrdiff_t
+# include "utils/pair.hpp"
+# include "utils/skiplist.hpp"
+# include "utils/reverse_iterator.hpp"
+# include "utils/iterators_traits.hpp"
+# include "utils/key_of_value.hpp"
+
+namespace ft {
+
+/* An ordered map that any number of threads may insert into, erase from and read at the same time, without locks
+ * (see utils/skiplist.hpp). Same interface as ft::map except that elements cannot be modified once inserted:
+ * there is no operator[] or insert_or_assign, and iterators are const.
+ * Iterators stay valid while other threads erase (an erased element is still readable, ++ skips it),
+ * but memory of erased elements is only reclaimed once no iterator that could reach them is alive.
+ * Traversal is weakly consistent under concurrent writes: forward iteration never goes back, but reverse_iterator
+ * searches for the predecessor again on every step and may show an element twice if keys are inserted behind it.
+ * size() is exact only when no other thread is writing. clear(), swap() and the Dtor need exclusive access. */
+template <typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<ft::pair<const Key,T> > >
+class skiplist_map {
+	public:
+		typedef Key										key_type;
+		typedef T										mapped_type;
+		typedef ft::pair<const Key, T>					value_type;
+		typedef Compare									key_compare;
+		class	value_compare {
+			friend class skiplist_map<Key, T, Compare, Alloc>;
+			protected:
+				Compare comp;
+				value_compare (Compare c) : comp(c) { }
+			public:
+				bool operator() (const value_type& x, const value_type& y) const {
+					return (comp(x.first, y.first));
+				}
+		};
+		typedef Alloc									allocator_type;
+		typedef typename Alloc::const_reference			reference;
+		typedef typename Alloc::const_reference			const_reference;
+		typedef typename Alloc::const_pointer			pointer;
+		typedef typename Alloc::const_pointer			const_pointer;
+
+	private:
+		typedef LockFreeSkipList<key_type, value_type, ft::select1st<value_type>, key_compare, Alloc>	list_type;
+
+	public:
+		typedef typename list_type::iterator			iterator;
+		typedef typename list_type::iterator			const_iterator;
+		typedef ft::reverse_iterator<iterator>			reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+		typedef ptrdiff_t								difference_type;
+		typedef size_t									size_type;
+
+	private:
+		list_type* _list;		// the list holds atomics and its own epoch domain, so swap() exchanges pointers
+		key_compare _comp;
+		allocator_type _alloc;
+
+	public:
+		// default Ctor
+		skiplist_map(const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _list(new list_type(comp, alloc)), _comp(comp), _alloc(alloc) { }
+
+		// range Ctor
+		template<typename InputIterator>
+		skiplist_map(InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _list(new list_type(comp, alloc)), _comp(comp), _alloc(alloc) {
+				try {
+					insert(first, last);
+				} catch (...) {
+					delete _list;
+					throw;
+				}
+		}
+
+		// copy Ctor : other must not be written to while it is copied.
+		skiplist_map(const skiplist_map& other) : _list(new list_type(other._comp, other._alloc)), _comp(other._comp), _alloc(other._alloc) {
+			try {
+				insert(other.begin(), other.end());
+			} catch (...) {
+				delete _list;
+				throw;
+			}
+		}
+
+		skiplist_map& operator=(const skiplist_map& rhs) {
+			skiplist_map tmp(rhs);
+			swap(tmp);
+			return *this;
+		}
+
+		~skiplist_map() { delete _list; }
+
+		// Iterators
+		const_iterator	begin() const	{ return _list->begin(); }
+		const_iterator	end() const		{ return _list->end(); }
+
+		const_reverse_iterator	rbegin() const	{ return const_reverse_iterator(end()); }
+		const_reverse_iterator	rend() const	{ return const_reverse_iterator(begin()); }
+
+		// Capacity
+		bool		empty()		const { return (_list->getSize() == 0); }
+		size_type	size()		const { return _list->getSize(); }
+		size_type	max_size()	const { return std::numeric_limits<difference_type>::max() / sizeof(T); }
+
+		// insert single element. If another thread inserts the same key at the same time, exactly one of them gets true.
+		ft::pair<iterator,bool>	insert(const value_type& val) {
+			return _list->insert(val);
+		}
+
+		// insert with hint : the hint is ignored, towers are searched from the top anyway.
+		iterator				insert(iterator position, const value_type& val) {
+			(void)position;
+			return _list->insert(val).first;
+		}
+
+		// insert range
+		template <class InputIterator>
+		void					insert(InputIterator first, InputIterator last) {
+			while (first != last)
+				_list->insert(*first++);
+		}
+
+		// erases the element position points to, even if another thread has since inserted a new element with the same key.
+		void		erase(iterator position) {
+			_list->erase_node(position.get());
+		}
+
+		size_type	erase(const key_type& k) {
+			return _list->erase(k);
+		}
+
+		void		erase(iterator first, iterator last) {
+			while (first != last)
+				_list->erase_node((first++).get());
+		}
+
+		void		swap(skiplist_map& x) {
+			std::swap(_list, x._list);
+			std::swap(_comp, x._comp);
+			std::swap(_alloc, x._alloc);
+		}
+
+		void		clear() {
+			_list->clear();
+		}
+
+		key_compare		key_comp() const	{ return _comp; }
+		value_compare	value_comp() const	{ return value_compare(_comp); }
+
+		const_iterator	find(const key_type& k) const	{ return _list->find(k); }
+
+		size_type		count(const key_type& k) const	{ return _list->contains(k) ? 1 : 0; }
+
+		const_iterator	lower_bound(const key_type& k) const	{ return _list->lower_bound(k); }
+		const_iterator	upper_bound(const key_type& k) const	{ return _list->upper_bound(k); }
+
+		ft::pair<const_iterator,const_iterator>	equal_range(const key_type& k) const {
+			const_iterator first = lower_bound(k);
+			const_iterator last = first;
+			if (last != end() && !_comp(k, last->first))
+				++last;
+			return ft::make_pair(first, last);
+		}
+
+		allocator_type	get_allocator() const { return _alloc; }
+};
+
+
+}
+#endif
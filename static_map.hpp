@@ -0,0 +1,154 @@
+#ifndef STATIC_MAP_HPP
+# define STATIC_MAP_HPP
+
+# include <functional> // less
+# include <memory> // allocator
+# include <stdexcept> // out_of_range
+# include <cstddef> // ptrdiff_t
+# include <iterator> // distance
+# include "vector.hpp"
+# include "utils/pair.hpp"
+# include "utils/static_index.hpp"
+# include "utils/tree_interface.hpp" // sorted_unique_t
+# include "utils/reverse_iterator.hpp"
+# include "utils/key_of_value.hpp"
+# include "flat_map.hpp"
+
+namespace ft {
+
+/* An immutable ordered map for lookup tables that are built once and searched many times (see utils/static_index.hpp).
+ * The pairs are kept sorted in one ft::vector. The keys are copied once more into an implicit index of cache-line-sized
+ * nodes, so a lookup reads one cache line per level and never touches the pairs until it has found the rank.
+ * Build it from a ft::map, a sorted ft::vector of pairs or any range. There is no insert, erase or operator[],
+ * and iterator and const_iterator are both const. */
+template <typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<ft::pair<const Key,T> > >
+class static_map {
+	public:
+		typedef Key										key_type;
+		typedef T										mapped_type;
+		typedef ft::pair<const Key, T>					value_type;
+		typedef Compare									key_compare;
+		class	value_compare {
+			friend class static_map<Key, T, Compare, Alloc>;
+			protected:
+				Compare comp;
+				value_compare (Compare c) : comp(c) { }
+			public:
+				bool operator() (const value_type& x, const value_type& y) const {
+					return (comp(x.first, y.first));
+				}
+		};
+		typedef Alloc									allocator_type;
+		typedef typename Alloc::reference				reference;
+		typedef typename Alloc::const_reference			const_reference;
+		typedef typename Alloc::pointer					pointer;
+		typedef typename Alloc::const_pointer			const_pointer;
+
+	private:
+		typedef ft::vector<value_type, Alloc>															container_type;
+		typedef StaticIndex<key_type, value_type, ft::select1st<value_type>, key_compare, Alloc>	index_type;
+
+	public:
+		typedef typename container_type::const_iterator	iterator;
+		typedef typename container_type::const_iterator	const_iterator;
+		typedef ft::reverse_iterator<iterator>			reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+		typedef ptrdiff_t								difference_type;
+		typedef size_t									size_type;
+
+	private:
+		container_type _values;
+		index_type _index;
+		key_compare _comp;
+		allocator_type _alloc;
+
+	public:
+		// default Ctor : an empty map.
+		static_map(const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _values(alloc), _index(comp, alloc), _comp(comp), _alloc(alloc) { }
+
+		// range Ctor : sorted and deduplicated through a flat_map first (O(n) if already sorted, the first of equal keys wins).
+		template<typename InputIterator>
+		static_map(InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _values(alloc), _index(comp, alloc), _comp(comp), _alloc(alloc) {
+				ft::flat_map<Key, T, Compare, Alloc> staged(first, last, comp, alloc);
+				_assign_sorted(staged.begin(), staged.end());
+		}
+
+		// sorted range Ctor : [first, last) must be sorted by key with no duplicates, as a ft::map is. O(n).
+		template<typename ForwardIterator>
+		static_map(ft::sorted_unique_t, ForwardIterator first, ForwardIterator last,
+			const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _values(alloc), _index(comp, alloc), _comp(comp), _alloc(alloc) {
+				_assign_sorted(first, last);
+		}
+
+		// copy Ctor : the index is rebuilt, O(n).
+		static_map(const static_map& other)
+			: _values(other._values), _index(other._index), _comp(other._comp), _alloc(other._alloc) { }
+
+		static_map& operator=(const static_map& rhs) {
+			static_map tmp(rhs);
+			swap(tmp);
+			return *this;
+		}
+
+		~static_map() { }
+
+		// Iterators
+		const_iterator	begin() const	{ return _values.begin(); }
+		const_iterator	end() const		{ return _values.end(); }
+
+		const_reverse_iterator	rbegin() const	{ return const_reverse_iterator(end()); }
+		const_reverse_iterator	rend() const	{ return const_reverse_iterator(begin()); }
+
+		// Capacity
+		bool		empty()		const { return (_values.size() == 0); }
+		size_type	size()		const { return _values.size(); }
+		size_type	max_size()	const { return _index.max_size(); }
+
+		const mapped_type&	at(const key_type& k) const {
+			size_type i = _index.find_index(k);
+			if (i == size())
+				throw std::out_of_range("static_map::at");
+			return _values[i].second;
+		}
+
+		void		swap(static_map& x) {
+			_values.swap(x._values);
+			_index.swap(x._index);
+			std::swap(_comp, x._comp);
+			std::swap(_alloc, x._alloc);
+		}
+
+		key_compare		key_comp() const	{ return _comp; }
+		value_compare	value_comp() const	{ return value_compare(_comp); }
+
+		const_iterator	find(const key_type& k) const	{ return begin() + _index.find_index(k); }
+
+		size_type		count(const key_type& k) const	{ return _index.find_index(k) != size() ? 1 : 0; }
+
+		const_iterator	lower_bound(const key_type& k) const	{ return begin() + _index.lower_index(k); }
+		const_iterator	upper_bound(const key_type& k) const	{ return begin() + _index.upper_index(k); }
+
+		ft::pair<const_iterator,const_iterator>	equal_range(const key_type& k) const {
+			size_type i = _index.lower_index(k);
+			size_type last = (i != size() && !_comp(k, _values[i].first)) ? i + 1 : i;
+			return ft::make_pair(begin() + i, begin() + last);
+		}
+
+		allocator_type	get_allocator() const { return _alloc; }
+
+	private:
+		template <typename ForwardIterator>
+		void	_assign_sorted(ForwardIterator first, ForwardIterator last) {
+			_values.reserve(std::distance(first, last));
+			for (; first != last; ++first)
+				_values.push_back(*first);
+			_index.build(_values.begin(), _values.size());
+		}
+};
+
+
+}
+#endif
@@ -0,0 +1,121 @@
+#ifndef STATIC_SET_HPP
+# define STATIC_SET_HPP
+
+# include <functional> // less
+# include <memory> // allocator
+# include <cstddef> // ptrdiff_t
+# include <iterator> // distance
+# include "utils/pair.hpp"
+# include "utils/static_index.hpp"
+# include "utils/tree_interface.hpp" // sorted_unique_t
+# include "utils/reverse_iterator.hpp"
+# include "utils/key_of_value.hpp"
+# include "flat_set.hpp"
+
+namespace ft {
+
+/* An immutable ordered set for lookup tables that are built once and searched many times (see utils/static_index.hpp).
+ * The keys are kept sorted in one array, under an implicit index of cache-line-sized nodes laid out level by level,
+ * so a lookup reads one cache line per level and compares each node without branches (with SSE2 for 32-bit integers).
+ * Build it from a ft::set, a sorted ft::vector or any range; there is no insert or erase. */
+template <typename T, typename Compare = std::less<T>, typename Alloc = std::allocator<T> >
+class static_set {
+	public:
+		typedef T										key_type;
+		typedef T										value_type;
+		typedef Compare									key_compare;
+		typedef Compare									value_compare;
+		typedef Alloc									allocator_type;
+		typedef typename Alloc::reference				reference;
+		typedef typename Alloc::const_reference			const_reference;
+		typedef typename Alloc::pointer					pointer;
+		typedef typename Alloc::const_pointer			const_pointer;
+
+	private:
+		typedef StaticIndex<key_type, value_type, ft::identity<value_type>, key_compare, Alloc>	index_type;
+
+	public:
+		typedef typename index_type::const_iterator		iterator;
+		typedef typename index_type::const_iterator		const_iterator;
+		typedef ft::reverse_iterator<iterator>			reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+		typedef ptrdiff_t								difference_type;
+		typedef size_t									size_type;
+
+	private:
+		index_type _index;
+		key_compare _comp;
+		allocator_type _alloc;
+
+	public:
+		// default Ctor : an empty set.
+		static_set(const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _index(comp, alloc), _comp(comp), _alloc(alloc) { }
+
+		// range Ctor : sorted and deduplicated through a flat_set first (O(n) if already sorted, the first of equal keys wins).
+		template<typename InputIterator>
+		static_set(InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _index(comp, alloc), _comp(comp), _alloc(alloc) {
+				ft::flat_set<T, Compare, Alloc> staged(first, last, comp, alloc);
+				_index.build(staged.begin(), staged.size());
+		}
+
+		// sorted range Ctor : [first, last) must be sorted with no duplicates, as a ft::set or a sorted ft::vector is. O(n).
+		template<typename ForwardIterator>
+		static_set(ft::sorted_unique_t, ForwardIterator first, ForwardIterator last,
+			const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+			: _index(comp, alloc), _comp(comp), _alloc(alloc) {
+				_index.build(first, std::distance(first, last));
+		}
+
+		// copy Ctor : the index is rebuilt, O(n).
+		static_set(const static_set& other) : _index(other._index), _comp(other._comp), _alloc(other._alloc) { }
+
+		static_set& operator=(const static_set& rhs) {
+			static_set tmp(rhs);
+			swap(tmp);
+			return *this;
+		}
+
+		~static_set() { }
+
+		// Iterators
+		const_iterator	begin() const	{ return _index.begin(); }
+		const_iterator	end() const		{ return _index.end(); }
+
+		const_reverse_iterator	rbegin() const	{ return const_reverse_iterator(end()); }
+		const_reverse_iterator	rend() const	{ return const_reverse_iterator(begin()); }
+
+		// Capacity
+		bool		empty()		const { return (_index.size() == 0); }
+		size_type	size()		const { return _index.size(); }
+		size_type	max_size()	const { return _index.max_size(); }
+
+		void		swap(static_set& x) {
+			_index.swap(x._index);
+			std::swap(_comp, x._comp);
+			std::swap(_alloc, x._alloc);
+		}
+
+		key_compare		key_comp() const	{ return _comp; }
+		value_compare	value_comp() const	{ return _comp; }
+
+		const_iterator	find(const key_type& k) const	{ return begin() + _index.find_index(k); }
+
+		size_type		count(const key_type& k) const	{ return _index.find_index(k) != _index.size() ? 1 : 0; }
+
+		const_iterator	lower_bound(const key_type& k) const	{ return begin() + _index.lower_index(k); }
+		const_iterator	upper_bound(const key_type& k) const	{ return begin() + _index.upper_index(k); }
+
+		ft::pair<const_iterator,const_iterator>	equal_range(const key_type& k) const {
+			size_type i = _index.lower_index(k);
+			size_type last = (i != size() && !_comp(k, begin()[i])) ? i + 1 : i;
+			return ft::make_pair(begin() + i, begin() + last);
+		}
+
+		allocator_type	get_allocator() const { return _alloc; }
+};
+
+
+}
+#endif
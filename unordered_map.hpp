@@ -0,0 +1,210 @@
+#ifndef UNORDERED_MAP_HPP
+# define UNORDERED_MAP_HPP
+
+# include <functional> // equal_to
+# include <memory> // allocator
+# include <stdexcept> // out_of_range
+# include <cstddef> // ptrdiff_t
+# include "utils/pair.hpp"
+# include "utils/hash.hpp"
+# include "utils/swiss_table.hpp"
+# include "utils/key_of_value.hpp"
+
+namespace ft {
+
+/* A hash map (the c++11 std::unordered_map interface) over an open-addressing Swiss table (see utils/swiss_table.hpp).
+ * Elements live directly in one flat slot array, so a lookup touches the 16 control bytes of a group and then,
+ * usually, only the one slot whose key matches, instead of a node per tree level.
+ * bucket_count() is the number of slots. The maximum load factor is fixed at 7/8.
+ * insert may rehash and invalidate every iterator; erase invalidates only iterators to the erased element. */
+template <typename Key, typename T, typename Hash = ft::hash<Key>, typename Pred = std::equal_to<Key>,
+			typename Alloc = std::allocator<ft::pair<const Key,T> > >
+class unordered_map {
+	public:
+		typedef Key										key_type;
+		typedef T										mapped_type;
+		typedef ft::pair<const Key, T>					value_type;
+		typedef Hash									hasher;
+		typedef Pred									key_equal;
+		typedef Alloc									allocator_type;
+		typedef typename Alloc::reference				reference;
+		typedef typename Alloc::const_reference			const_reference;
+		typedef typename Alloc::pointer					pointer;
+		typedef typename Alloc::const_pointer			const_pointer;
+		typedef hash_iterator<value_type>				iterator;
+		typedef hash_const_iterator<value_type>			const_iterator;
+		typedef ptrdiff_t								difference_type;
+		typedef size_t									size_type;
+
+	private:
+		typedef SwissTable<key_type, value_type, ft::select1st<value_type>, hasher, key_equal, Alloc>	table_type;
+
+		table_type _table;
+		allocator_type _alloc;
+
+	public:
+		// default Ctor : n is the number of elements to make room for.
+		explicit unordered_map(size_type n = 0, const hasher& hf = hasher(), const key_equal& eql = key_equal(),
+								const allocator_type& alloc = allocator_type())
+			: _table(hf, eql, alloc), _alloc(alloc) {
+				if (n)
+					_table.reserve(n);
+		}
+
+		// range Ctor
+		template<typename InputIterator>
+		unordered_map(InputIterator first, InputIterator last, size_type n = 0, const hasher& hf = hasher(),
+						const key_equal& eql = key_equal(), const allocator_type& alloc = allocator_type())
+			: _table(hf, eql, alloc), _alloc(alloc) {
+				if (n)
+					_table.reserve(n);
+				insert(first, last);
+		}
+
+		// copy Ctor : keeps the slot layout, nothing is rehashed.
+		unordered_map(const unordered_map& other) : _table(other._table), _alloc(other._alloc) { }
+
+		unordered_map& operator=(const unordered_map& rhs) {
+			unordered_map tmp(rhs);
+			swap(tmp);
+			return *this;
+		}
+
+		~unordered_map() { }
+
+		// Iterators
+		iterator		begin()			{ return _table.begin(); }
+		const_iterator	begin() const	{ return _table.begin(); }
+		iterator		end()			{ return _table.end(); }
+		const_iterator	end() const		{ return _table.end(); }
+
+		// Capacity
+		bool		empty()		const { return (_table.getSize() == 0); }
+		size_type	size()		const { return _table.getSize(); }
+		size_type	max_size()	const { return _table.max_size(); }
+
+		// if k matches the key, returns a reference to its mapped value.
+		// if not, inserts a new element with that key and returns a reference to its mapped value.
+		// The key is hashed only once either way, and mapped_type() is built only on a miss.
+		mapped_type& operator[](const key_type& k) {
+			typename table_type::position pos = _table.locate(k);
+			if (pos.found)
+				return _table.at_index(pos.index)->second;
+			return _table.insert_at(pos, value_type(k, mapped_type()))->second;
+		}
+
+		mapped_type&		at(const key_type& k) {
+			iterator it = find(k);
+			if (it == end())
+				throw std::out_of_range("unordered_map::at");
+			return it->second;
+		}
+		const mapped_type&	at(const key_type& k) const {
+			const_iterator it = find(k);
+			if (it == end())
+				throw std::out_of_range("unordered_map::at");
+			return it->second;
+		}
+
+		// if k is not present, inserts (k, obj). if it is, does nothing (obj is not used).
+		ft::pair<iterator,bool>	try_emplace(const key_type& k, const mapped_type& obj) {
+			typename table_type::position pos = _table.locate(k);
+			if (pos.found)
+				return ft::make_pair(_table.at_index(pos.index), false);
+			return ft::make_pair(_table.insert_at(pos, value_type(k, obj)), true);
+		}
+
+		// if k is not present, inserts (k, obj). if it is, assigns obj to its mapped value.
+		// second of the result is true if a new element was inserted.
+		ft::pair<iterator,bool>	insert_or_assign(const key_type& k, const mapped_type& obj) {
+			typename table_type::position pos = _table.locate(k);
+			if (pos.found) {
+				iterator it = _table.at_index(pos.index);
+				it->second = obj;
+				return ft::make_pair(it, false);
+			}
+			return ft::make_pair(_table.insert_at(pos, value_type(k, obj)), true);
+		}
+
+		// insert single element
+		ft::pair<iterator,bool>	insert(const value_type& val) {
+			return _table.insert(val);
+		}
+
+		// insert with hint : the hint is ignored, the slot depends only on the hash.
+		iterator				insert(const_iterator position, const value_type& val) {
+			(void)position;
+			return _table.insert(val).first;
+		}
+
+		// insert range
+		template <class InputIterator>
+		void					insert(InputIterator first, InputIterator last) {
+			while (first != last)
+				_table.insert(*first++);
+		}
+
+		// returns the iterator following position.
+		iterator	erase(const_iterator position) {
+			iterator next(const_cast<ctrl_t*>(position._ctrl), const_cast<value_type*>(position._slot));
+			_table.erase(position);
+			++next;
+			return next;
+		}
+
+		size_type	erase(const key_type& k) {
+			return _table.erase(k);
+		}
+
+		iterator	erase(const_iterator first, const_iterator last) {
+			while (first != last)
+				first = erase(first);
+			return iterator(const_cast<ctrl_t*>(last._ctrl), const_cast<value_type*>(last._slot));
+		}
+
+		void		swap(unordered_map& x) {
+			_table.swap(x._table);
+			std::swap(_alloc, x._alloc);
+		}
+
+		void		clear() {
+			_table.clear();
+		}
+
+		iterator		find(const key_type& k)			{ return _table.find(k); }
+		const_iterator	find(const key_type& k) const	{ return _table.find(k); }
+
+		size_type		count(const key_type& k) const	{ return _table.contains(k) ? 1 : 0; }
+
+		ft::pair<iterator,iterator>				equal_range(const key_type& k) {
+			iterator first = find(k);
+			iterator last = first;
+			if (last != end())
+				++last;
+			return ft::make_pair(first, last);
+		}
+		ft::pair<const_iterator,const_iterator>	equal_range(const key_type& k) const {
+			const_iterator first = find(k);
+			const_iterator last = first;
+			if (last != end())
+				++last;
+			return ft::make_pair(first, last);
+		}
+
+		// Hash policy
+		size_type	bucket_count() const	{ return _table.capacity(); }
+		float		load_factor() const		{ return bucket_count() ? static_cast<float>(size()) / bucket_count() : 0.0f; }
+		float		max_load_factor() const	{ return 0.875f; }
+		// room for n elements without rehashing
+		void		reserve(size_type n)	{ _table.reserve(n); }
+		// at least n slots, also drops the slots left by erased elements
+		void		rehash(size_type n)		{ _table.rehash(n); }
+
+		hasher			hash_function() const	{ return _table.hash_function(); }
+		key_equal		key_eq() const			{ return _table.key_eq(); }
+		allocator_type	get_allocator() const	{ return _alloc; }
+};
+
+
+}
+#endif
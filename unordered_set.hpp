@@ -0,0 +1,152 @@
+#ifndef UNORDERED_SET_HPP
+# define UNORDERED_SET_HPP
+
+# include <functional> // equal_to
+# include <memory> // allocator
+# include <cstddef> // ptrdiff_t
+# include "utils/pair.hpp"
+# include "utils/hash.hpp"
+# include "utils/swiss_table.hpp"
+# include "utils/key_of_value.hpp"
+
+namespace ft {
+
+/* A hash set (the c++11 std::unordered_set interface) over the same Swiss table as ft::unordered_map.
+ * Elements cannot be modified in place, so iterator and const_iterator are both const.
+ * insert may rehash and invalidate every iterator; erase invalidates only iterators to the erased element. */
+template <typename T, typename Hash = ft::hash<T>, typename Pred = std::equal_to<T>, typename Alloc = std::allocator<T> >
+class unordered_set {
+	public:
+		typedef T										key_type;
+		typedef T										value_type;
+		typedef Hash									hasher;
+		typedef Pred									key_equal;
+		typedef Alloc									allocator_type;
+		typedef typename Alloc::reference				reference;
+		typedef typename Alloc::const_reference			const_reference;
+		typedef typename Alloc::pointer					pointer;
+		typedef typename Alloc::const_pointer			const_pointer;
+		typedef hash_const_iterator<value_type>			iterator;
+		typedef hash_const_iterator<value_type>			const_iterator;
+		typedef ptrdiff_t								difference_type;
+		typedef size_t									size_type;
+
+	private:
+		typedef SwissTable<key_type, value_type, ft::identity<value_type>, hasher, key_equal, Alloc>	table_type;
+
+		table_type _table;
+		allocator_type _alloc;
+
+	public:
+		// default Ctor : n is the number of elements to make room for.
+		explicit unordered_set(size_type n = 0, const hasher& hf = hasher(), const key_equal& eql = key_equal(),
+								const allocator_type& alloc = allocator_type())
+			: _table(hf, eql, alloc), _alloc(alloc) {
+				if (n)
+					_table.reserve(n);
+		}
+
+		// range Ctor
+		template<typename InputIterator>
+		unordered_set(InputIterator first, InputIterator last, size_type n = 0, const hasher& hf = hasher(),
+						const key_equal& eql = key_equal(), const allocator_type& alloc = allocator_type())
+			: _table(hf, eql, alloc), _alloc(alloc) {
+				if (n)
+					_table.reserve(n);
+				insert(first, last);
+		}
+
+		// copy Ctor : keeps the slot layout, nothing is rehashed.
+		unordered_set(const unordered_set& other) : _table(other._table), _alloc(other._alloc) { }
+
+		unordered_set& operator=(const unordered_set& rhs) {
+			unordered_set tmp(rhs);
+			swap(tmp);
+			return *this;
+		}
+
+		~unordered_set() { }
+
+		// Iterators
+		const_iterator	begin() const	{ return _table.begin(); }
+		const_iterator	end() const		{ return _table.end(); }
+
+		// Capacity
+		bool		empty()		const { return (_table.getSize() == 0); }
+		size_type	size()		const { return _table.getSize(); }
+		size_type	max_size()	const { return _table.max_size(); }
+
+		// insert single element
+		ft::pair<iterator,bool>	insert(const value_type& val) {
+			ft::pair<typename table_type::iterator, bool> ret = _table.insert(val);
+			return ft::make_pair(iterator(ret.first), ret.second);
+		}
+
+		// insert with hint : the hint is ignored, the slot depends only on the hash.
+		iterator				insert(const_iterator position, const value_type& val) {
+			(void)position;
+			return _table.insert(val).first;
+		}
+
+		// insert range
+		template <class InputIterator>
+		void					insert(InputIterator first, InputIterator last) {
+			while (first != last)
+				_table.insert(*first++);
+		}
+
+		// returns the iterator following position.
+		iterator	erase(const_iterator position) {
+			const_iterator next(position);
+			_table.erase(position);
+			return ++next;
+		}
+
+		size_type	erase(const key_type& k) {
+			return _table.erase(k);
+		}
+
+		iterator	erase(const_iterator first, const_iterator last) {
+			while (first != last)
+				first = erase(first);
+			return last;
+		}
+
+		void		swap(unordered_set& x) {
+			_table.swap(x._table);
+			std::swap(_alloc, x._alloc);
+		}
+
+		void		clear() {
+			_table.clear();
+		}
+
+		const_iterator	find(const key_type& k) const	{ return _table.find(k); }
+
+		size_type		count(const key_type& k) const	{ return _table.contains(k) ? 1 : 0; }
+
+		ft::pair<const_iterator,const_iterator>	equal_range(const key_type& k) const {
+			const_iterator first = find(k);
+			const_iterator last = first;
+			if (last != end())
+				++last;
+			return ft::make_pair(first, last);
+		}
+
+		// Hash policy
+		size_type	bucket_count() const	{ return _table.capacity(); }
+		float		load_factor() const		{ return bucket_count() ? static_cast<float>(size()) / bucket_count() : 0.0f; }
+		float		max_load_factor() const	{ return 0.875f; }
+		// room for n elements without rehashing
+		void		reserve(size_type n)	{ _table.reserve(n); }
+		// at least n slots, also drops the slots left by erased elements
+		void		rehash(size_type n)		{ _table.rehash(n); }
+
+		hasher			hash_function() const	{ return _table.hash_function(); }
+		key_equal		key_eq() const			{ return _table.key_eq(); }
+		allocator_type	get_allocator() const	{ return _alloc; }
+};
+
+
+}
+#endif
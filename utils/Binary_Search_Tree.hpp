@@ -24,90 +24,63 @@
 namespace ft {
 
 
-template <typename ValueType, typename Compare, typename Alloc>
-class BinarySearchTree : public TreeInterface<ValueType, Compare, Alloc> {
+template <typename Key, typename ValueType, typename KeyOfValue, typename Compare, typename Alloc>
+class BinarySearchTree;
+
+/* 균형을 맞추지 않는 engine. 정렬된 key를 넣으면 linked list가 되므로 비교용으로만 쓴다.
+ * ft::map<Key, T, Compare, Alloc, ft::BinarySearchTreeEngine> 처럼 지정한다. */
+struct BinarySearchTreeEngine {
+	template <typename Key, typename ValueType, typename KeyOfValue, typename Compare, typename Alloc>
+	struct rebind {
+		typedef BinarySearchTree<Key, ValueType, KeyOfValue, Compare, Alloc>	other;
+	};
+};
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Compare, typename Alloc>
+class BinarySearchTree : public TreeInterface<Key, ValueType, KeyOfValue, Compare, Alloc, BinarySearchTree<Key, ValueType, KeyOfValue, Compare, Alloc> > {
+	private:
+		typedef TreeInterface<Key, ValueType, KeyOfValue, Compare, Alloc, BinarySearchTree>	base;
+		friend class TreeInterface<Key, ValueType, KeyOfValue, Compare, Alloc, BinarySearchTree>;
+
 	public:
-		using TreeInterface<ValueType,Compare,Alloc>::_comp;
-		using TreeInterface<ValueType,Compare,Alloc>::_alloc;
-		using TreeInterface<ValueType,Compare,Alloc>::_end;
-		using TreeInterface<ValueType,Compare,Alloc>::_root;
-		using TreeInterface<ValueType,Compare,Alloc>::_size;
+		using base::_comp;
+		using base::_alloc;
+		using base::_end;
+		using base::_root;
+		using base::_size;
+		using base::_find;
+		using base::_find_min;
+		using base::_link_parent_child;
+		using base::_destroy_node;
+		using base::_key;
 		typedef nodeBase<ValueType>		node;
+		typedef void					augment_type;
 
-		BinarySearchTree(Compare comp, Alloc alloc) : TreeInterface<ValueType,Compare,Alloc>(comp, alloc) { }
+		BinarySearchTree(const Compare& comp, const Alloc& alloc) : base(comp, alloc) { }
 
-		BinarySearchTree(const BinarySearchTree& other) : TreeInterface<ValueType,Compare,Alloc>(other) { }
+		BinarySearchTree(const BinarySearchTree& other) : base(other) { }
 
-		virtual ~BinarySearchTree() { }
+		~BinarySearchTree() { }
 
 	private:
 		BinarySearchTree() { }
 		BinarySearchTree& operator=(const BinarySearchTree& rhs);
 
-		virtual node* _insert(node* cur, ValueType value) {
-			while (1) {
-				if (_comp(value, cur->value)) {			// 추가하려는 key가 현재 node의 key보다 작다면
-					if (cur->left == NULL) {
-						//cur->left = new node(value, cur);
-						cur->left = _alloc.allocate(1);
-						_alloc.construct(cur->left, node(value, cur));
-						_size++;
-						return cur->left;
-					}
-					else
-						cur = cur->left;
-				}
-				else if (_comp(cur->value, value)) {	// 추가하려는 key가 현재 node의 key보다 크다면
-					if ( cur->right == NULL) {
-						//cur->right = new node(value, cur);
-						cur->right = _alloc.allocate(1);
-						_alloc.construct(cur->right, node(value, cur));
-						_size++;
-						return cur->right;
-					}
-					else
-						cur = cur->right;
-				}
-				else
-					return cur;
-			}
+		// 균형을 맞추지 않으므로 연결한 뒤 할 일이 없다.
+		void _insert_fixup(node* n) {
+			(void)n;
 		}
 
-		virtual node* _find(node* cur, ValueType value) {
-			while (cur != NULL) {
-				if (_comp(value, cur->value))		// 찾으려는 key가 현재 node의 key보다 작다면
-					cur = cur->left;
-				else if (_comp(cur->value, value))	// 찾으려는 key가 현재 node의 key 보다 크다면
-					cur = cur->right;
-				else
-					return cur;
-			}
-			return cur;
+		// node에 따로 유지하는 값(augmentation)이 없다.
+		void _update(node* n) {
+			(void)n;
 		}
-
-		/* del의 부모와 child를 서로 연결.
-		 * del 이 root node라면 child를 새로운 root로 지정
-		*/
-		void _link_parent_child(node* del, node* child) {
-			if (del == _root)
-				_end->right = _root = child;
-			else
-			{
-				if (del == del->parent->left)
-					del->parent->left = child;
-				else
-					del->parent->right = child;
-			}
-			if (child != NULL)
-				child -> parent = del->parent;
+		void _update_path(node* n) {
+			(void)n;
 		}
 
-		/* cur를 기점으로 key를 탐색, 해당 노드를 삭제 */
-		virtual void _erase(node* cur, ValueType value) {
-			node* del = _find(cur, value);
-			if (!del)	// 삭제할 노드가 존재하지 않음
-				return;
-
+		/* del 노드를 삭제 */
+		void _erase(node* del) {
 			if (del->left == NULL && del->right == NULL) {
 				// 삭제할 노드가 leaf node라면
 				_link_parent_child(del, NULL);
@@ -122,9 +95,10 @@ class BinarySearchTree : public TreeInterface<ValueType, Compare, Alloc> {
 				// successor를 del 자리로 옮김
 				successor->left = del->left;
 				successor->right = del->right;
-				successor->parent = del->parent;
-				del->left->parent = successor;
-				del->right->parent = successor;
+				successor->set_parent(del->parent());
+				del->left->set_parent(successor);
+				if (del->right)						// successor가 del의 right child였고 자식이 없었다면 NULL
+					del->right->set_parent(successor);
 				_link_parent_child(del, successor);
 			}
 			else {
@@ -133,17 +107,10 @@ class BinarySearchTree : public TreeInterface<ValueType, Compare, Alloc> {
 				_link_parent_child(del, child);
 			}
 
-			//delete del;
-			_alloc.destroy(del);
-			_alloc.deallocate(del, 1);
+			_destroy_node(del);
 			_size--;
 		}
 
-		node* _find_min(node* cur) {
-			while (cur->left)
-				cur = cur->left;
-			return cur;
-		}
 
 
 };
@@ -2,6 +2,8 @@
 # define RB_TREE_HPP
 
 # include "tree_interface.hpp"
+# include "augment.hpp"
+# include "task_pool.hpp"
 
 /* Red-Black Tree는 삽입, 삭제를 하는 동안 다음 규칙을 준수하도록 구조를 수정하여 균형을 유지한다.
  * 1. 모든 노드는 red 또는 black이다.
@@ -16,94 +18,112 @@
 
 namespace ft {
 
-template <typename ValueType, typename Compare, typename Alloc>
-class RB_Tree : public TreeInterface<ValueType, Compare, Alloc> {
+template <typename Key, typename ValueType, typename KeyOfValue, typename Compare, typename Alloc, typename Augment = no_augment>
+class RB_Tree;
+
+/* map, set의 Tree 인자로 넘기는 engine policy.
+ * allocator의 rebind처럼, 컨테이너가 자신의 key_type, value_type, key 추출자, compare, allocator를 넘겨 실제 트리 타입을 얻어간다.
+ */
+struct RB_TreeEngine {
+	template <typename Key, typename ValueType, typename KeyOfValue, typename Compare, typename Alloc>
+	struct rebind {
+		typedef RB_Tree<Key, ValueType, KeyOfValue, Compare, Alloc>	other;
+	};
+};
+
+/* node마다 Augment(augment.hpp)의 값을 유지하는 RB_Tree. */
+template <typename Augment>
+struct AugmentedRB_TreeEngine {
+	template <typename Key, typename ValueType, typename KeyOfValue, typename Compare, typename Alloc>
+	struct rebind {
+		typedef RB_Tree<Key, ValueType, KeyOfValue, Compare, Alloc, Augment>	other;
+	};
+};
+
+/* 서브트리 크기를 유지해서 map, set의 nth, rank, count_range, index_of를 O(log n)에 제공한다. */
+typedef AugmentedRB_TreeEngine<subtree_size>	OrderStatisticEngine;
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Compare, typename Alloc, typename Augment>
+class RB_Tree : public TreeInterface<Key, ValueType, KeyOfValue, Compare, Alloc, RB_Tree<Key, ValueType, KeyOfValue, Compare, Alloc, Augment>,
+										typename augment_node<ValueType, Augment>::type> {
+	private:
+		typedef typename augment_node<ValueType, Augment>::type								aug_node;
+		typedef TreeInterface<Key, ValueType, KeyOfValue, Compare, Alloc, RB_Tree, aug_node>	base;
+		friend class TreeInterface<Key, ValueType, KeyOfValue, Compare, Alloc, RB_Tree, aug_node>;
+		typedef typename base::NodeAlloc											NodeAlloc;
+
 	public:
-		using TreeInterface<ValueType,Compare,Alloc>::_comp;
-		using TreeInterface<ValueType,Compare,Alloc>::_alloc;
-		using TreeInterface<ValueType,Compare,Alloc>::_end;
-		using TreeInterface<ValueType,Compare,Alloc>::_root;
-		using TreeInterface<ValueType,Compare,Alloc>::_size;
+		using base::_comp;
+		using base::_alloc;
+		using base::_end;
+		using base::_root;
+		using base::_size;
+		using base::_find;
+		using base::_find_min;
+		using base::_link_parent_child;
+		using base::_destroy_node;
+		using base::_deleteTree;
+		using base::_copy_recurse;
+		using base::_reset_empty;
+		using base::_reset_extremes;
+		using base::_key;
 		typedef nodeBase<ValueType>		node;
+		typedef typename Augment::data_type	augment_type;
 
-		RB_Tree(Compare comp, Alloc alloc) : TreeInterface<ValueType,Compare,Alloc>(comp, alloc) { }
+		RB_Tree(const Compare& comp, const Alloc& alloc) : base(comp, alloc) { }
 
-		RB_Tree(const RB_Tree& other) : TreeInterface<ValueType,Compare,Alloc>(other) { }
+		RB_Tree(const RB_Tree& other) : base(other) { }
 
-		virtual ~RB_Tree() { }
+		~RB_Tree() { }
 
 	private:
 		RB_Tree() { }
 		RB_Tree& operator=(const RB_Tree& rhs);
 
-		// 탐색은 일반 BST와 동일
-		virtual node* _find(node* cur, ValueType value) {
-			while (cur != NULL) {
-				if (_comp(value, cur->value))		// 찾으려는 key가 현재 node의 key보다 작다면
-					cur = cur->left;
-				else if (_comp(cur->value, value))	// 찾으려는 key가 현재 node의 key 보다 크다면
-					cur = cur->right;
-				else
-					return cur;
-			}
-			return cur;
+		/* 새 node는 생성자에서 color=0 (RED)로 초기화됨. 연결된 뒤 _rb_fix_insertion()에서 변환을 수행 */
+		void _insert_fixup(node* n) {
+			_update_path(n);
+			_rb_fix_insertion(n);
 		}
 
-		/* node 생성자에서 color=0 (RED)로 초기화됨. 이후 _rb_fix_insertion()에서 변환을 수행 */
-		virtual node* _insert(node* cur, ValueType value) {
-			while (1) {
-				if (_comp(value, cur->value)) {			// 추가하려는 key가 현재 node의 key보다 작다면
-					if (cur->left == NULL) {
-						//cur->left = new node(value, cur);
-						cur->left = _alloc.allocate(1);
-						_alloc.construct(cur->left, node(value, cur));
-						_size++;
-						_rb_fix_insertion(cur->left);
-						return cur->left;
-					}
-					else
-						cur = cur->left;
-				}
-				else if (_comp(cur->value, value)) {	// 추가하려는 key가 현재 node의 key보다 크다면
-					if ( cur->right == NULL) {
-						//cur->right = new node(value, cur);
-						cur->right = _alloc.allocate(1);
-						_alloc.construct(cur->right, node(value, cur));
-						_size++;
-						_rb_fix_insertion(cur->right);
-						return cur->right;
-					}
-					else
-						cur = cur->right;
-				}
-				else
-					return cur;
-			}
+		/* n의 aug를 자식들로부터 다시 계산 */
+		void _update(node* n) {
+			Augment::update(static_cast<aug_node*>(n));
 		}
 
-		void _rb_fix_insertion(node* n) {						
-			node* p = n->parent;
-			if (n == _root)	{					// 1. N이 root라면 - N을 black으로 바꾼다.
-				n->color = BLACK;
+		/* n부터 root까지. n의 서브트리에 node가 추가/삭제되면 조상들의 aug가 모두 바뀐다. */
+		void _update_path(node* n) {
+			if (!Augment::enabled)
 				return;
+			for (; n != _end; n = n->parent())
+				_update(n);
+		}
+
+		/* 반환값: root가 red에서 black으로 바뀌어 트리 전체의 black height가 1 늘었는가 (_join에서 사용) */
+		bool _rb_fix_insertion(node* n) {
+			node* p = n->parent();
+			if (n == _root)	{					// 1. N이 root라면 - N을 black으로 바꾼다.
+				bool grew = (n->color() == RED);
+				n->set_color(BLACK);
+				return grew;
 			}
-			else if (p->color == BLACK)			// 2. N의 부모 P가 black이라면 - 문제없음
-				return;
+			else if (p->color() == BLACK)			// 2. N의 부모 P가 black이라면 - 문제없음
+				return false;
 			else {
 				node* u = _uncle(n);
-				if (u && u->color == RED) {		// 3. P와 삼촌노드 U가 둘 다 red라면 - P,U를 black으로, 할아버지노드 G를 red로 바꾼다.
-					p->color = BLACK;
-					if (u) u->color = BLACK;
-					p->parent->color = RED;
-					_rb_fix_insertion(p->parent);	// G에 대해 1,2,3을 다시 적용
+				if (u && u->color() == RED) {		// 3. P와 삼촌노드 U가 둘 다 red라면 - P,U를 black으로, 할아버지노드 G를 red로 바꾼다.
+					p->set_color(BLACK);
+					if (u) u->set_color(BLACK);
+					p->parent()->set_color(RED);
+					return _rb_fix_insertion(p->parent());	// G에 대해 1,2,3을 다시 적용
 				}
 				else {
 					node* g = _grandparent(n);	// 4. P는 red, U는 black이고, G-P-N 이 꺾인 형태 (G의 left가 P, P의 right가 N)또는 (G의 right가 P, P의 left가 N)
-					if ((n == n->parent->right) && n->parent == g->left) {
-						_rotate_left(n->parent);
+					if ((n == n->parent()->right) && n->parent() == g->left) {
+						_rotate_left(n->parent());
 						n = n->left;
-					} else if ((n == n->parent->left) && (n->parent == g->right)) {
-						_rotate_right(n->parent);
+					} else if ((n == n->parent()->left) && (n->parent() == g->right)) {
+						_rotate_right(n->parent());
 						n = n->right;			//	P를 기준으로 왼쪽 또는 오른쪽 회전하면 case5 상태가 된다
 					}
 					// 5. P는 red, U는 black (G는 black)  G의 left가 P, P의 left가 N 이라면 G를 기준으로 오른쪽회전한다.
@@ -113,60 +133,42 @@ class RB_Tree : public TreeInterface<ValueType, Compare, Alloc> {
 					//		규칙5 역시 유지되는데, 바뀌기 전 P를 포함하는 모든 경로는 G를 지나고,
 					//		바뀐 후 G를 지나는 경로는 모두 P를 지나기 때문이다.
 					g = _grandparent(n);
-					n->parent->color = BLACK;
-					g->color = RED;
-					if (n == n->parent->left)
+					n->parent()->set_color(BLACK);
+					g->set_color(RED);
+					if (n == n->parent()->left)
 						_rotate_right(g);
 					else
 						_rotate_left(g);
 
 				}
-			}	
-		}
-
-		/* del의 부모와 child를 서로 연결.
-		 * del 이 root node라면 child를 새로운 root로 지정
-		*/
-		void _link_parent_child(node* del, node* child) {
-			if (del == _root)
-				_end->right = _root = child;
-			else
-			{
-				if (del == del->parent->left)
-					del->parent->left = child;
-				else
-					del->parent->right = child;
 			}
-			if (child != NULL)
-				child -> parent = del->parent;
+			return false;
 		}
 
-		/* cur를 기점으로 key를 탐색, 해당 노드를 삭제 */
-		virtual void _erase(node* cur, ValueType value) {
-			node* del = _find(cur, value);
-			if (!del)	// 삭제할 노드가 존재하지 않음
-				return;
-
-			// 삭제할 노드의 자식이 2개라면, successor의 값을 현재위치에 넣고, 실제 삭제는 successor node에서 수행한다.
+		/* del 노드를 삭제 */
+		void _erase(node* del) {
+			// 삭제할 노드의 자식이 2개라면, successor와 트리 내 위치를 맞바꾸고, 실제 삭제는 successor가 있던 자리에서 수행한다.
 			// successor는 left child가 없으므로 최대 1개의 자식노드를 갖는 노드를 삭제하는 문제로 치환할 수 있다.
+			// (값을 복사하면 map의 const key에 대입할 수 없고, successor를 가리키던 iterator도 무효화된다)
 			if (del->left && del->right) {
-				node* successor = _find_min(del->right);	// 오른쪽 서브트리에서 최소값 찾기
-				del->value = successor->value;
-				del = successor;
+				_swap_with_successor(del, _find_min(del->right));
+				_update_path(del);		// del과 successor 사이 node들의 서브트리 구성이 바뀌었다.
 			}
 
 			node* child = (del->left) ? del->left : del->right;
-			if (del->color == RED) 		// 삭제할 노드가 RED일 땐 그냥 삭제. 부모 P와 자식 N이 모두 black일 것이므로 규칙4,5모두 유지된다.
+			if (del->color() == RED) 		// 삭제할 노드가 RED일 땐 그냥 삭제. 부모 P와 자식 N이 모두 black일 것이므로 규칙4,5모두 유지된다.
 				;
-			else if (child && child->color == RED) 	// 삭제할 노드 D가 BLACK, N이 RED인 경우. 둘의 color를 바꾸고 (이제 RED가 된) D를 지우면 모든 규칙을 만족한다.
-				child->color = BLACK;
+			else if (child && child->color() == RED) 	// 삭제할 노드 D가 BLACK, N이 RED인 경우. 둘의 color를 바꾸고 (이제 RED가 된) D를 지우면 모든 규칙을 만족한다.
+				child->set_color(BLACK);
 			else						// D, N 모두 BLACK인 경우 (D는 non-null leaf, N은 null leaf) D를 삭제하면 N을 지나는 모든 경로의 black node의 수가 -1이 된다.
 				_rb_fix_erase(del);
 
 			// 삭제할 노드의 부모와 자식을 연결
+			// 위의 회전들은 del을 포함한 채로 aug를 갱신했으므로, del이 빠진 뒤 del의 조상들만 다시 계산한다.
+			node* p = del->parent();
 			_link_parent_child(del, child);
-			_alloc.destroy(del);
-			_alloc.deallocate(del, 1);
+			_update_path(p);
+			_destroy_node(del);
 			_size--;
 		}
 
@@ -183,11 +185,11 @@ class RB_Tree : public TreeInterface<ValueType, Compare, Alloc> {
 
 			// N이 root가 아니면 반드시 non-null leaf인 Sibling이 존재한다.
 			node* s = _sibling(n);
-			node* p = n->parent;
+			node* p = n->parent();
 			// case 2. S가 RED인 경우 (P는 black)
-			if (s->color == RED) {         // case 2. S가 RED인 경우 (P는 black)
-				p->color = RED;            // S와 P의 색을 바꾸고, P를 기준으로 왼쪽회전       S
-				s->color = BLACK;          /*                                             /   \           */
+			if (s->color() == RED) {         // case 2. S가 RED인 경우 (P는 black)
+				p->set_color(RED);            // S와 P의 색을 바꾸고, P를 기준으로 왼쪽회전       S
+				s->set_color(BLACK);          /*                                             /   \           */
 				if (n == p->left)          //                                            P    SR
 					_rotate_left(p);       /*                                           / \               */
 				else                       //                                          N   SL
@@ -198,10 +200,10 @@ class RB_Tree : public TreeInterface<ValueType, Compare, Alloc> {
 			// S를 RED로 칠하면 P-N과 P-S를 지나는 모든 경로의 black node의 수가 -1이 된다.
 			// 이제 P를 기준으로 rebalancing을 재수행한다.
 			s = _sibling(n);
-			if (p->color == BLACK && s->color == BLACK
+			if (p->color() == BLACK && s->color() == BLACK
 				&& _is_black(s->left) && _is_black(s->right))
 			{
-				s->color = RED;
+				s->set_color(RED);
 				_rb_fix_erase(p);                                           /*               P             */
 				return;                                                     /*             /   \           */
 			}                                                               /*            N     S          */
@@ -209,11 +211,11 @@ class RB_Tree : public TreeInterface<ValueType, Compare, Alloc> {
 			// case 4. S와 자식들이 모두 black이고 P가 red라면                /*                SL  SR       */
 			// S를 red로 , P를 black으로 칠한다.
 			// P-S를 지나는 경로의 black node 수는 변화없지만 P-N을 지나는 경로의 black node는  +1 된다.
-			if (p->color == RED && s->color == BLACK
+			if (p->color() == RED && s->color() == BLACK
 				&& _is_black(s->left) && _is_black(s->right))
 			{
-				s->color = RED;
-				p->color = BLACK;
+				s->set_color(RED);
+				p->set_color(BLACK);
 				return;
 			}
 			//                                                            /*       P                    P              */
@@ -222,15 +224,15 @@ class RB_Tree : public TreeInterface<ValueType, Compare, Alloc> {
 			// 모든 경로의 black node는 변화 없고 case 6으로 변환된다.      /*         / \                  /  \          */
 			// (case 2에 의해 S는 반드시 black이다)                        /*        SL  SR                    S         */
 			//                                                            /*        /\   /\                  /  \SR     */
-			if ( s->color == BLACK) {
-				if (n == n->parent->left && _is_black(s->right) && !_is_black(s->left)) {
-					s->color = RED;
-					s->left->color = BLACK;
+			if ( s->color() == BLACK) {
+				if (n == n->parent()->left && _is_black(s->right) && !_is_black(s->left)) {
+					s->set_color(RED);
+					s->left->set_color(BLACK);
 					_rotate_right(s);
 				}
-				else if (n == n->parent->right && _is_black(s->left) && !_is_black(s->right)) {
-					s->color = RED;
-					s->right->color = BLACK;
+				else if (n == n->parent()->right && _is_black(s->left) && !_is_black(s->right)) {
+					s->set_color(RED);
+					s->right->set_color(BLACK);
 					_rotate_left(s);
 				}
 
@@ -242,32 +244,427 @@ class RB_Tree : public TreeInterface<ValueType, Compare, Alloc> {
 			// P의 색상이 S에서, S의 색상이 SR에서 이어지므로                 /*       SL  SR            N   SL            */
 			// SR을 지나는 경로 역시 변화 없다.
 			s = _sibling(n);
-			s->color = p->color;
-			p->color = BLACK;
-			if (n == n->parent->left) {
+			s->set_color(p->color());
+			p->set_color(BLACK);
+			if (n == n->parent()->left) {
 				_rotate_left(p);
-				s->right->color = BLACK;
-			} else if (n == n->parent->right) {
+				s->right->set_color(BLACK);
+			} else if (n == n->parent()->right) {
 				_rotate_right(p);
-				s->left->color = BLACK;
+				s->left->set_color(BLACK);
 			}
 		}
 
-		node* _find_min(node* cur) {
-			while (cur->left)
-				cur = cur->left;
-			return cur;
+		/* del과 successor(del의 오른쪽 서브트리의 최솟값)의 위치와 색을 맞바꾼다.
+		 * successor는 left child가 없고, del의 right child 자신일 수도 있다. */
+		void _swap_with_successor(node* del, node* s) {
+			node* dp = del->parent();
+			node* sp = s->parent();
+			node* sr = s->right;
+
+			if (del == _root)
+				_end->right = _root = s;
+			else if (dp->left == del)
+				dp->left = s;
+			else
+				dp->right = s;
+			s->set_parent(dp);
+
+			s->left = del->left;
+			s->left->set_parent(s);
+			if (sp == del) {
+				s->right = del;
+				del->set_parent(s);
+			} else {
+				s->right = del->right;
+				s->right->set_parent(s);
+				sp->left = del;
+				del->set_parent(sp);
+			}
+
+			del->left = NULL;
+			del->right = sr;
+			if (sr)
+				sr->set_parent(del);
+
+			bool color = s->color();
+			s->set_color(del->color());
+			del->set_color(color);
+		}
+
+
+		/* split, join
+		 * 트리에서 떼어낸 서브트리를 (root, black height)로 다룬다. root는 항상 black이고 NULL의 black height는 0이다.
+		 * join(L, k, R)은 L < k < R 일 때 세 개를 하나의 RB 트리로 합치고, 두 트리의 black height 차이만큼만 내려가므로 O(log n).
+		 * split(T, key)는 T를 key보다 작은 쪽과 큰 쪽으로 나누고, 경로의 node마다 join을 한 번씩 하지만 합쳐서 O(log n)이다.
+		 * 합집합, 교집합, 차집합은 작은 쪽 트리의 root로 큰 쪽을 split해서 양쪽을 재귀로 처리한 뒤 join한다.
+		 * O(m log(n/m + 1)) 에 결과에서 빠지는 node를 해제하는 비용이 더해진다.
+		 *
+		 * join 중 색을 고치는 동안에는 큰 쪽 트리를 잠시 _root 자리(작업 공간)에 걸어서 _rb_fix_insertion과 회전을 그대로 쓴다.
+		 * 그래서 split, join을 쓰는 연산은 시작할 때 자신의 트리를 떼어내고, 끝날 때 결과를 다시 _root에 건다. */
+		struct subtree {
+			node*	root;
+			size_t	bh;
+			subtree(node* r = NULL, size_t h = 0) : root(r), bh(h) { }
+		};
+
+		static size_t _black_height(node* n) {
+			size_t h = 0;
+			for (; n != NULL; n = n->left)
+				if (n->color() == BLACK)
+					h++;
+			return h;
+		}
+
+		/* black height가 parent_bh인 (black) node에서 떼어낸 자식. root가 red면 black으로 칠하고 높이가 1 늘어난다. */
+		static subtree _child(node* c, size_t parent_bh) {
+			subtree t(c, parent_bh - 1);
+			if (c != NULL && c->color() == RED) {
+				c->set_color(BLACK);
+				t.bh++;
+			}
+			return t;
+		}
+
+		subtree _join(subtree l, node* k, subtree r) {
+			if (l.bh == r.bh) {
+				k->left = l.root;
+				k->right = r.root;
+				if (l.root)
+					l.root->set_parent(k);
+				if (r.root)
+					r.root->set_parent(k);
+				k->set_color(BLACK);
+				_update(k);
+				return subtree(k, l.bh + 1);
+			}
+			// 큰 쪽 트리의 오른쪽(또는 왼쪽) spine을 따라 작은 쪽과 black height가 같은 black node c를 찾아
+			// 그 자리에 red k를 넣고 c와 작은 쪽 트리를 k의 자식으로 단다. 이후는 insert와 같은 red-red 수정.
+			bool along_right = (l.bh > r.bh);
+			subtree& big = along_right ? l : r;
+			subtree& small = along_right ? r : l;
+			node* p = NULL;
+			node* c = big.root;
+			size_t h = big.bh;
+			while (c != NULL && !(c->color() == BLACK && h == small.bh)) {
+				if (c->color() == BLACK)
+					h--;
+				p = c;
+				c = along_right ? c->right : c->left;
+			}
+			k->set_color(RED);
+			k->set_parent(p);
+			if (along_right) {
+				k->left = c;
+				k->right = small.root;
+				p->right = k;
+			}
+			else {
+				k->left = small.root;
+				k->right = c;
+				p->left = k;
+			}
+			if (c)
+				c->set_parent(k);
+			if (small.root)
+				small.root->set_parent(k);
+
+			_end->right = _root = big.root;
+			_root->set_parent(_end);
+			_update(k);
+			_update_path(p);
+			bool grew = _rb_fix_insertion(k);
+			return subtree(_root, big.bh + (grew ? 1 : 0));
+		}
+
+		/* pivot 없이 l < r 을 합친다. r의 최솟값을 떼어내서 pivot으로 쓴다. */
+		subtree _join2(subtree l, subtree r) {
+			if (r.root == NULL)
+				return l;
+			if (l.root == NULL)
+				return r;
+			node* m = _find_min(r.root);
+			subtree empty, rest;
+			_split(r, _key(m), empty, rest);
+			return _join(l, m, rest);
+		}
+
+		/* t를 key보다 작은 쪽(l)과 큰 쪽(r)으로 나눈다. key와 같은 node가 있으면 떼어내서 반환, 없으면 NULL */
+		node* _split(subtree t, const Key& key, subtree& l, subtree& r) {
+			if (t.root == NULL) {
+				l = r = subtree();
+				return NULL;
+			}
+			node* n = t.root;
+			subtree lc = _child(n->left, t.bh);
+			subtree rc = _child(n->right, t.bh);
+			if (_comp(key, _key(n))) {
+				subtree mid;
+				node* found = _split(lc, key, l, mid);
+				r = _join(mid, n, rc);
+				return found;
+			}
+			if (_comp(_key(n), key)) {
+				subtree mid;
+				node* found = _split(rc, key, mid, r);
+				l = _join(lc, n, mid);
+				return found;
+			}
+			l = lc;
+			r = rc;
+			return n;
+		}
+
+		void _drop(node* n) {
+			_destroy_node(n);
+			_size--;
+		}
+
+		/* 같은 key가 양쪽에 있으면 a_wins일 때 a의 node를 남긴다. */
+		subtree _union(subtree a, subtree b, bool a_wins) {
+			if (a.root == NULL)
+				return b;
+			if (b.root == NULL)
+				return a;
+			node* n = a.root;
+			subtree al = _child(n->left, a.bh);
+			subtree ar = _child(n->right, a.bh);
+			subtree bl, br;
+			node* dup = _split(b, _key(n), bl, br);
+			if (dup != NULL) {
+				if (!a_wins)
+					std::swap(n, dup);
+				_drop(dup);
+			}
+			subtree l = _union(al, bl, a_wins);
+			subtree r = _union(ar, br, a_wins);
+			return _join(l, n, r);
+		}
+
+		subtree _intersection(subtree a, subtree b, bool a_wins) {
+			if (a.root == NULL || b.root == NULL) {
+				_deleteTree(a.root);
+				_deleteTree(b.root);
+				return subtree();
+			}
+			node* n = a.root;
+			subtree al = _child(n->left, a.bh);
+			subtree ar = _child(n->right, a.bh);
+			subtree bl, br;
+			node* dup = _split(b, _key(n), bl, br);
+			subtree l = _intersection(al, bl, a_wins);
+			subtree r = _intersection(ar, br, a_wins);
+			if (dup == NULL) {
+				_drop(n);
+				return _join2(l, r);
+			}
+			if (!a_wins)
+				std::swap(n, dup);
+			_drop(dup);
+			return _join(l, n, r);
+		}
+
+		/* a - b */
+		subtree _difference(subtree a, subtree b) {
+			if (a.root == NULL || b.root == NULL) {
+				_deleteTree(b.root);
+				return a;
+			}
+			node* n = b.root;
+			subtree bl = _child(n->left, b.bh);
+			subtree br = _child(n->right, b.bh);
+			subtree al, ar;
+			node* dup = _split(a, _key(n), al, ar);
+			if (dup != NULL)
+				_drop(dup);
+			_drop(n);
+			subtree l = _difference(al, bl);
+			subtree r = _difference(ar, br);
+			return _join2(l, r);
+		}
+
+		enum set_op { UNION, INTERSECTION, DIFFERENCE };
+
+		subtree _sequential(set_op op, subtree a, subtree b, bool a_wins) {
+			if (op == UNION)
+				return _union(a, b, a_wins);
+			if (op == INTERSECTION)
+				return _intersection(a, b, a_wins);
+			return _difference(a, b);
+		}
+
+		/* 병렬 버전. 나누는 쪽 root의 key로 다른 쪽을 split한 뒤, 오른쪽 절반은 pool에 넘기고 왼쪽 절반은 직접 처리한다.
+		 * join은 _root 자리를 작업 공간으로 쓰므로, 넘긴 쪽은 자신의 _end, _root를 가진 임시 RB_Tree(scratch)에서 실행한다.
+		 * depth번까지만 나누고, 작은 쪽의 black height가 grain_bh보다 낮으면 (node가 2^grain_bh 개 미만일 수 있으면) 순차로 처리한다. */
+		struct parallel_args {
+			RB_Tree*	tree;
+			set_op		op;
+			subtree		a;
+			subtree		b;
+			bool		a_wins;
+			task_pool*	pool;
+			size_t		depth;
+			size_t		grain_bh;
+			subtree		result;
+		};
+
+		static void _parallel_task(void* arg) {
+			parallel_args* x = static_cast<parallel_args*>(arg);
+			x->result = x->tree->_parallel(x->op, x->a, x->b, x->a_wins, *x->pool, x->depth, x->grain_bh);
+		}
+
+		subtree _parallel(set_op op, subtree a, subtree b, bool a_wins, task_pool& pool, size_t depth, size_t grain_bh) {
+			if (depth == 0 || a.root == NULL || b.root == NULL || a.bh < grain_bh || b.bh < grain_bh)
+				return _sequential(op, a, b, a_wins);
+
+			// 차집합은 b의 root로 a를 나누고, 합집합과 교집합은 a의 root로 b를 나눈다.
+			bool by_b = (op == DIFFERENCE);
+			subtree& by = by_b ? b : a;
+			node* n = by.root;
+			subtree by_l = _child(n->left, by.bh);
+			subtree by_r = _child(n->right, by.bh);
+			subtree cut_l, cut_r;
+			node* dup = _split(by_b ? a : b, _key(n), cut_l, cut_r);
+
+			RB_Tree scratch(_comp, Alloc(_alloc));
+			parallel_args right;
+			right.tree = &scratch;
+			right.op = op;
+			right.a = by_b ? cut_r : by_r;
+			right.b = by_b ? by_r : cut_r;
+			right.a_wins = a_wins;
+			right.pool = &pool;
+			right.depth = depth - 1;
+			right.grain_bh = grain_bh;
+			task_pool::task t(&_parallel_task, &right);
+			pool.submit(&t);
+			subtree l = by_b ? _parallel(op, cut_l, by_l, a_wins, pool, depth - 1, grain_bh)
+							: _parallel(op, by_l, cut_l, a_wins, pool, depth - 1, grain_bh);
+			pool.wait(&t);
+			subtree r = right.result;
+			_size += scratch._size;		// scratch는 0에서 시작해 해제한 node 수만큼 줄어 있다 (unsigned이므로 wrap 되어도 합은 맞다)
+			scratch._reset_empty();		// 결과 node들은 이제 이 트리의 것
+
+			if (op == DIFFERENCE) {
+				if (dup != NULL)
+					_drop(dup);
+				_drop(n);
+				return _join2(l, r);
+			}
+			if (dup == NULL) {
+				if (op == UNION)
+					return _join(l, n, r);
+				_drop(n);
+				return _join2(l, r);
+			}
+			if (!a_wins)
+				std::swap(n, dup);
+			_drop(dup);
+			return _join(l, n, r);
+		}
+
+		/* other의 node를 모두 가져와서 *this와 op 한 결과를 *this에 남기고, other는 비운다.
+		 * 두 allocator가 같지 않으면 (서로 다른 pool을 쓰는 pool_allocator 등) node를 그대로 옮길 수 없으므로 복사해 온다.
+		 * pool이 있고 allocator를 여러 thread에서 써도 되면 병렬로 처리한다. */
+		void _merge(RB_Tree& other, set_op op, task_pool* pool = NULL, size_t grain = 0) {
+			if (this == &other) {
+				if (op == DIFFERENCE)
+					this->clear();
+				return;
+			}
+			subtree a(_root, _black_height(_root));
+			subtree b;
+			_size += other._size;
+			if (_alloc == other._alloc) {
+				b = subtree(other._root, _black_height(other._root));
+				other._reset_empty();
+				other._size = 0;
+			}
+			else {
+				node* copy = _copy_recurse(other._root, NULL);
+				b = subtree(copy, _black_height(copy));
+				other.clear();
+			}
+			_reset_empty();
+
+			subtree result;
+			if (pool != NULL && pool->size() > 1 && allocator_thread_safe<NodeAlloc>::value) {
+				size_t depth = 0;		// thread 수의 4배 정도의 task로 나눈다
+				while (((size_t)1 << depth) < pool->size() * 4)
+					depth++;
+				size_t grain_bh = 0;	// black height가 h인 서브트리는 node가 2^h - 1 개 이상
+				while (((size_t)1 << grain_bh) < grain)
+					grain_bh++;
+				if (op == DIFFERENCE)
+					result = _parallel(op, a, b, true, *pool, depth, grain_bh);
+				else
+					result = (a.bh <= b.bh) ? _parallel(op, a, b, true, *pool, depth, grain_bh) : _parallel(op, b, a, false, *pool, depth, grain_bh);
+			}
+			else if (op == UNION)			// 작은 쪽의 key로 큰 쪽을 split 한다
+				result = (a.bh <= b.bh) ? _union(a, b, true) : _union(b, a, false);
+			else if (op == INTERSECTION)
+				result = (a.bh <= b.bh) ? _intersection(a, b, true) : _intersection(b, a, false);
+			else
+				result = _difference(a, b);
+
+			_end->right = _root = result.root;
+			if (_root)
+				_root->set_parent(_end);
+			_reset_extremes();
+		}
+
+		/* [first, last) 를 split 두 번과 join 한 번으로 잘라낸다. O(log n + 지운 원소 수), 회전은 O(log n)번.
+		 * 짧은 구간은 하나씩 지우는 편이 싸다. */
+		void _erase_range(node* first, node* last) {
+			node* it = first;
+			for (size_t i = 0; i < 16 && it != last; i++)
+				it = it->next();
+			if (it == last) {
+				base::_erase_range(first, last);
+				return;
+			}
+			if (first == this->_leftmost && last == _end) {
+				this->clear();
+				return;
+			}
+			subtree t(_root, _black_height(_root));
+			_reset_empty();
+			subtree l, mid, r;
+			_split(t, _key(first), l, mid);		// first는 떼어내서 반환된다
+			subtree result = l;
+			if (last != _end) {
+				subtree erased;
+				_split(mid, _key(last), erased, r);		// last도 떼어내서 pivot으로 다시 넣는다
+				_deleteTree(erased.root);
+				result = _join(l, last, r);
+			}
+			else
+				_deleteTree(mid.root);
+			_drop(first);
+
+			_end->right = _root = result.root;
+			if (_root)
+				_root->set_parent(_end);
+			_reset_extremes();
+		}
+
+		static size_t _subtree_size(node* n) {
+			return Augment::size(static_cast<const aug_node*>(n));
+		}
+
+		static augment_type _summary(node* n) {
+			return Augment::summary(static_cast<const aug_node*>(n));
 		}
 
 		bool _is_black(node* n) {
-			if (n == NULL || n->color == BLACK)
+			if (n == NULL || n->color() == BLACK)
 				return true;
 			return false;
 		}
 
 		node* _grandparent(node* n) {
-			if (n && n != _root && n->parent && n->parent != _root)
-				return n->parent->parent;
+			if (n && n != _root && n->parent() && n->parent() != _root)
+				return n->parent()->parent();
 			return NULL;
 		}
 
@@ -275,32 +672,36 @@ class RB_Tree : public TreeInterface<ValueType, Compare, Alloc> {
 			node* g = _grandparent(n);
 			if (g == NULL)
 				return NULL;
-			if (n->parent == g->left)
+			if (n->parent() == g->left)
 				return g->right;
 			else
 				return g->left;
 		}
 
 		node* _sibling(node* n) {
-			if (n == n->parent->left)
-				return n->parent->right;
-			return n->parent->left;
+			if (n == n->parent()->left)
+				return n->parent()->right;
+			return n->parent()->left;
 		}
 
 		void _rotate_left(node* n) {
 			node* c = n->right;
-			node* p = n->parent;
+			node* p = n->parent();
 
 			if (c->left != NULL)
-				c->left->parent = n;
+				c->left->set_parent(n);
 
 			n->right = c->left;
-			n->parent = c;
+			n->set_parent(c);
 			c->left = n;
-			c->parent = p;
+			c->set_parent(p);
+			if (Augment::enabled) {		// n이 c의 자식이 되었으므로 n을 먼저 계산
+				_update(n);
+				_update(c);
+			}
 
 			if (p == _end)
-				_root = c;
+				_end->right = _root = c;
 			else {
 				if (p->left == n)
 					p->left = c;
@@ -311,18 +712,22 @@ class RB_Tree : public TreeInterface<ValueType, Compare, Alloc> {
 
 		void _rotate_right(node* n) {
 			node* c = n->left;
-			node* p = n->parent;
+			node* p = n->parent();
 
 			if (c->right != NULL)
-				c->right->parent = n;
+				c->right->set_parent(n);
 
 			n->left = c->right;
-			n->parent = c;
+			n->set_parent(c);
 			c->right = n;
-			c->parent = p;
+			c->set_parent(p);
+			if (Augment::enabled) {
+				_update(n);
+				_update(c);
+			}
 
 			if (p == _end)
-				_root = c;
+				_end->right = _root = c;
 			else {
 				if (p->right == n)
 					p->right = c;
@@ -333,6 +738,101 @@ class RB_Tree : public TreeInterface<ValueType, Compare, Alloc> {
 
 
 	public:
+		/* other의 원소를 옮겨와서 *this를 합집합, 교집합, 차집합으로 바꾼다. other는 비워진다.
+		 * 같은 key가 양쪽에 있으면 *this의 원소가 남는다. */
+		void set_union(RB_Tree& other)				{ _merge(other, UNION); }
+		void set_intersection(RB_Tree& other)		{ _merge(other, INTERSECTION); }
+		void set_difference(RB_Tree& other)		{ _merge(other, DIFFERENCE); }
+
+		/* 위와 같지만 pool의 thread들이 나눠서 처리한다. 대략 grain개보다 작은 부분은 나누지 않는다.
+		 * allocator가 thread-safe 하지 않으면 (allocator_thread_safe) 순차로 처리한다. */
+		static const size_t	parallel_grain = 16384;
+		void set_union(RB_Tree& other, task_pool& pool, size_t grain)			{ _merge(other, UNION, &pool, grain); }
+		void set_intersection(RB_Tree& other, task_pool& pool, size_t grain)	{ _merge(other, INTERSECTION, &pool, grain); }
+		void set_difference(RB_Tree& other, task_pool& pool, size_t grain)		{ _merge(other, DIFFERENCE, &pool, grain); }
+
+		/* 순서 통계. Augment가 서브트리 크기를 제공할 때(OrderStatisticEngine)만 쓸 수 있다. */
+
+		/* k번째(0부터) 원소. k >= size 이면 tree end */
+		node* nth(size_t k) const {
+			node* cur = _root;
+			while (cur != NULL) {
+				size_t left = _subtree_size(cur->left);
+				if (k < left)
+					cur = cur->left;
+				else if (k == left)
+					return cur;
+				else {
+					k -= left + 1;
+					cur = cur->right;
+				}
+			}
+			return _end;
+		}
+
+		/* key보다 작은 원소의 수 */
+		size_t rank(const Key& key) const {
+			size_t r = 0;
+			node* cur = _root;
+			while (cur != NULL) {
+				if (_comp(_key(cur), key)) {			// cur와 cur의 왼쪽 서브트리는 모두 key보다 작다
+					r += _subtree_size(cur->left) + 1;
+					cur = cur->right;
+				}
+				else
+					cur = cur->left;
+			}
+			return r;
+		}
+
+		/* key가 [lo, hi)인 원소들을 Augment(monoid_augment)의 연산으로 key 순서대로 합친 값.
+		 * lo와 hi의 경로가 갈라지는 node에서 양쪽으로 한 번씩 내려가며, 구간에 완전히 포함되는 서브트리는 aug를 그대로 쓴다. */
+		augment_type aggregate(const Key& lo, const Key& hi) const {
+			node* split = _root;
+			while (split != NULL) {
+				if (_comp(_key(split), lo))
+					split = split->right;
+				else if (!_comp(_key(split), hi))
+					split = split->left;
+				else
+					break;
+			}
+			if (split == NULL)
+				return Augment::identity();
+
+			augment_type left = Augment::identity();		// split의 왼쪽 서브트리 중 lo 이상
+			for (node* cur = split->left; cur != NULL; ) {
+				if (_comp(_key(cur), lo))
+					cur = cur->right;
+				else {		// cur와 오른쪽 서브트리 전체가 구간 안. 이미 모은 것보다 앞에 온다
+					left = Augment::combine(Augment::combine(Augment::measure(cur->value), _summary(cur->right)), left);
+					cur = cur->left;
+				}
+			}
+			augment_type right = Augment::identity();		// split의 오른쪽 서브트리 중 hi 미만
+			for (node* cur = split->right; cur != NULL; ) {
+				if (!_comp(_key(cur), hi))
+					cur = cur->left;
+				else {		// 왼쪽 서브트리 전체와 cur가 구간 안. 이미 모은 것보다 뒤에 온다
+					right = Augment::combine(right, Augment::combine(_summary(cur->left), Augment::measure(cur->value)));
+					cur = cur->right;
+				}
+			}
+			return Augment::combine(Augment::combine(left, Augment::measure(split->value)), right);
+		}
+
+		/* n 앞에 있는 원소의 수. tree end는 size */
+		size_t index_of(node* n) const {
+			if (n == _end)
+				return _size;
+			size_t r = _subtree_size(n->left);
+			for (; n->parent() != _end; n = n->parent()) {
+				if (n == n->parent()->right)
+					r += _subtree_size(n->parent()->left) + 1;
+			}
+			return r;
+		}
+
 		size_t getMaxHeight(node* node) const {
 			if (node == NULL)
 				return 1;
@@ -350,16 +850,16 @@ class RB_Tree : public TreeInterface<ValueType, Compare, Alloc> {
 		}
 
 		bool isRootBlack() const {
-			return (_root == NULL || _root->color == BLACK);
+			return (_root == NULL || _root->color() == BLACK);
 		}
 		bool isRedDup(node* node) const {
 			if (node == NULL)
 				return false;
-			if (node->color == BLACK)
+			if (node->color() == BLACK)
 				return ( isRedDup(node->left) || isRedDup(node->right));
-			if (node->left && node->left->color == RED)
+			if (node->left && node->left->color() == RED)
 				return true;
-			if (node->right && node->right->color == RED)
+			if (node->right && node->right->color() == RED)
 				return true;
 			return false;
 		}
@@ -0,0 +1,141 @@
+#ifndef AUGMENT_HPP
+# define AUGMENT_HPP
+
+# include <cstddef> // size_t
+# include <limits> // numeric_limits
+# include "node.hpp"
+# include "pair.hpp"
+
+/* RB_Tree의 augmentation policy.
+ * 각 node에 자신을 root로 하는 서브트리에 대한 값(aug)을 하나 더 저장하고,
+ * 서브트리의 구성이 바뀔 때(연결, 삭제, 회전) 자식의 aug와 자신의 value로부터 다시 계산한다.
+ * 회전 한 번에 두 node만 다시 계산하면 되므로 삽입, 삭제는 여전히 O(log n)이다.
+ *
+ * struct Augment {
+ *     static const bool enabled;                     // false면 tree가 갱신 경로를 아예 건너뛴다
+ *     typedef ... data_type;                         // node마다 저장할 값
+ *     template <typename Node>
+ *     static void update(Node* n);                   // n->aug 를 n->value, 자식의 aug로부터 계산
+ * };
+ */
+
+namespace ft {
+
+/* augmentation 값을 갖는 node. 연결은 nodeBase* 로 하므로 aug를 읽을 땐 of()로 변환한다. */
+template <typename ValueType, typename Augment>
+struct augNode : public nodeBase<ValueType> {
+	typedef nodeBase<ValueType>		base;
+	typename Augment::data_type		aug;
+
+	augNode() : base(), aug() { }
+	augNode(const ValueType& value, base* parent = NULL) : base(value, parent), aug() { }
+
+	static augNode*			of(base* n)			{ return static_cast<augNode*>(n); }
+	static const augNode*	of(const base* n)	{ return static_cast<const augNode*>(n); }
+
+	private:
+	augNode(const augNode& other);
+	augNode& operator=(const augNode& rhs);
+};
+
+/* 기본값. 추가로 저장하는 값이 없고 node도 nodeBase 그대로 쓴다. */
+struct no_augment {
+	static const bool enabled = false;
+	typedef void	data_type;
+
+	template <typename Node>
+	static void update(Node* n) { (void)n; }
+};
+
+template <typename ValueType, typename Augment>
+struct augment_node {
+	typedef augNode<ValueType, Augment>	type;
+};
+
+template <typename ValueType>
+struct augment_node<ValueType, no_augment> {
+	typedef nodeBase<ValueType>	type;
+};
+
+/* 서브트리의 node 수. k번째 원소(nth), key보다 작은 원소의 수(rank)를 O(log n)에 구할 수 있다. */
+struct subtree_size {
+	static const bool enabled = true;
+	typedef size_t	data_type;
+
+	template <typename Node>
+	static size_t size(const Node* n) { return (n == NULL) ? 0 : n->aug; }
+
+	template <typename Node>
+	static void update(Node* n) {
+		n->aug = 1 + size(Node::of(n->left)) + size(Node::of(n->right));
+	}
+};
+
+
+/* 원소 하나가 aggregate에 기여하는 값. map의 원소(pair<const Key, T>)는 mapped value, set의 원소는 자기 자신. */
+template <typename ValueType>
+struct mapped_part {
+	typedef ValueType	type;
+	static const type&	get(const ValueType& value) { return value; }
+};
+
+template <typename Key, typename T>
+struct mapped_part<ft::pair<const Key, T> > {
+	typedef T	type;
+	static const type&	get(const ft::pair<const Key, T>& value) { return value.second; }
+};
+
+/* Monoid로 서브트리의 원소들을 (key 순서대로) 합친 값. RB_Tree::aggregate(lo, hi)가 key 구간의 합을 O(log n)에 구한다.
+ *
+ * struct Monoid {
+ *     typedef ... value_type;                                                 // mapped value(set은 원소)에서 변환 가능해야 한다
+ *     value_type identity() const;                                             // op(identity(), x) == op(x, identity()) == x
+ *     value_type operator()(const value_type& a, const value_type& b) const;   // 결합법칙을 만족. 교환법칙은 필요 없다
+ * };
+ *
+ * map의 mapped value를 operator[]나 iterator로 바꾸면 tree가 알 수 없으므로, insert_or_assign으로 바꿔야 합이 갱신된다.
+ */
+template <typename Monoid>
+struct monoid_augment {
+	static const bool enabled = true;
+	typedef typename Monoid::value_type	data_type;
+
+	static data_type	identity() { return Monoid().identity(); }
+	static data_type	combine(const data_type& a, const data_type& b) { return Monoid()(a, b); }
+
+	template <typename ValueType>
+	static data_type	measure(const ValueType& value) { return data_type(mapped_part<ValueType>::get(value)); }
+
+	template <typename Node>
+	static data_type	summary(const Node* n) { return (n == NULL) ? identity() : n->aug; }
+
+	template <typename Node>
+	static void update(Node* n) {
+		n->aug = combine(combine(summary(Node::of(n->left)), measure(n->value)), summary(Node::of(n->right)));
+	}
+};
+
+template <typename T>
+struct sum_monoid {
+	typedef T	value_type;
+	T	identity() const { return T(); }
+	T	operator()(const T& a, const T& b) const { return a + b; }
+};
+
+template <typename T>
+struct min_monoid {
+	typedef T	value_type;
+	T	identity() const { return std::numeric_limits<T>::max(); }
+	T	operator()(const T& a, const T& b) const { return (b < a) ? b : a; }
+};
+
+template <typename T>
+struct max_monoid {
+	typedef T	value_type;
+	T	identity() const { return std::numeric_limits<T>::is_integer ? std::numeric_limits<T>::min() : -std::numeric_limits<T>::max(); }
+	T	operator()(const T& a, const T& b) const { return (a < b) ? b : a; }
+};
+
+
+}
+#endif
@@ -0,0 +1,915 @@
+#ifndef BTREE_HPP
+# define BTREE_HPP
+
+# include <cstddef> // size_t, ptrdiff_t
+# include <cstring> // memmove
+# include <algorithm> // swap
+# include <iterator> // bidirectional_iterator_tag
+# include <memory> // allocator
+# include <new> // placement new
+# include "../vector.hpp"
+# include "pair.hpp"
+# include "is_trivially_relocatable.hpp"
+
+/* btree_map, btree_set 이 쓰는 B+ tree.
+ *
+ * RB_Tree는 원소 하나가 node 하나라 찾을 때 level마다 cache line 하나를 새로 읽는다. (10M개면 24 level 정도)
+ * 여기서는 node 하나를 node_bytes(256 byte, cache line 4개) 안에 맞추고 key를 수십 개씩 넣는다.
+ *   - leaf : 원소(value)를 key 순서로 담고, 양 옆 leaf와 prev / next로 이어져 있다. 순회는 leaf 배열을 차례로 읽는 것이다.
+ *   - internal : key k개와 자식 k+1개. keys[i]는 children[i+1] 서브트리의 가장 작은 key 이하이고 children[i]의 모든 key보다 크다.
+ * 그래서 높이가 log_(fanout) n 으로 낮고(int 두 개짜리 원소 10M개에서 5 level 정도), node 안에서는 이분 탐색을 분기 없이 한다.
+ * 원소마다 포인터 3개와 색을 따로 두지 않으므로 원소당 메모리도 줄어든다. (node가 평균 3/4 정도 차 있다고 보면 원소 크기의 1.4배 정도)
+ *
+ * 모든 leaf는 같은 깊이에 있다. 꽉 찬 node에 넣으면 반으로 나누고 가운데 key를 부모로 올리며, 반 아래로 줄면 형제에게서 빌리거나 합친다.
+ * 원소는 node 안에서 자리를 옮기고 node 사이로도 옮겨 다니므로, insert와 erase는 모든 iterator를 무효화한다.
+ * node 배열은 원래 크기보다 한 칸 크게 잡아서, 먼저 넣은 뒤 넘치면 나눈다.
+ */
+
+namespace ft {
+
+struct btreeNodeBase {
+	bool		leaf;
+	unsigned	count;		// leaf는 원소 수, internal은 key 수
+
+	explicit btreeNodeBase(bool is_leaf) : leaf(is_leaf), count(0) { }
+};
+
+/* 생성자를 부르지 않는 배열 공간. (원소 타입에 기본 생성자가 없어도 되고, 쓰는 칸만 construct 한다) */
+template <typename T, size_t N>
+union btree_storage {
+	char		raw[N * sizeof(T)];
+	long double	align_ld;
+	long long	align_ll;
+	void*		align_p;
+
+	T*			get()		{ return reinterpret_cast<T*>(raw); }
+	const T*	get() const	{ return reinterpret_cast<const T*>(raw); }
+};
+
+static const size_t	btree_node_bytes = 256;
+
+template <typename V>
+struct btreeLeaf : public btreeNodeBase {
+	static const size_t	fit = (btree_node_bytes - sizeof(btreeNodeBase) - 2 * sizeof(void*)) / sizeof(V);
+	static const size_t	capacity = (fit < 5) ? 4 : fit - 1;		// 한 칸은 나누기 전에 잠깐 넘치는 자리
+	static const size_t	min_count = capacity / 2;
+
+	btreeLeaf*						prev;
+	btreeLeaf*						next;
+	btree_storage<V, capacity + 1>	storage;
+
+	btreeLeaf() : btreeNodeBase(true), prev(NULL), next(NULL) { }
+
+	V*			slots()			{ return storage.get(); }
+	const V*	slots() const	{ return storage.get(); }
+};
+
+template <typename Key>
+struct btreeInternal : public btreeNodeBase {
+	static const size_t	fit = (btree_node_bytes - sizeof(btreeNodeBase) - 2 * sizeof(void*)) / (sizeof(Key) + sizeof(void*));
+	static const size_t	capacity = (fit < 5) ? 4 : fit - 1;
+	static const size_t	min_count = capacity / 2;
+
+	btreeNodeBase*					children[capacity + 2];
+	btree_storage<Key, capacity + 1>	storage;
+
+	btreeInternal() : btreeNodeBase(false) { }
+
+	Key*		keys()			{ return storage.get(); }
+	const Key*	keys() const	{ return storage.get(); }
+};
+
+
+/* leaf와 그 안의 위치. end()는 마지막 leaf의 count 위치다. (tree가 비어 있으면 leaf가 NULL) */
+template <typename T>
+class btree_iterator {
+	public:
+		typedef T									value_type;
+		typedef T*									pointer;
+		typedef T&									reference;
+		typedef ptrdiff_t							difference_type;
+		typedef std::bidirectional_iterator_tag		iterator_category;
+		btreeLeaf<T>*	_leaf;
+		size_t			_pos;
+
+		btree_iterator() : _leaf(NULL), _pos(0) { }
+		btree_iterator(btreeLeaf<T>* leaf, size_t pos) : _leaf(leaf), _pos(pos) { }
+		btree_iterator(const btree_iterator& other) : _leaf(other._leaf), _pos(other._pos) { }
+		btree_iterator& operator=(const btree_iterator& rhs) {
+			_leaf = rhs._leaf;
+			_pos = rhs._pos;
+			return *this;
+		}
+		~btree_iterator() { }
+
+		reference operator*() const { return _leaf->slots()[_pos]; }
+		pointer operator->() const { return _leaf->slots() + _pos; }
+
+		btree_iterator& operator++() {
+			if (++_pos == _leaf->count && _leaf->next) {
+				_leaf = _leaf->next;
+				_pos = 0;
+			}
+			return *this;
+		}
+
+		btree_iterator operator++(int) {
+			btree_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		btree_iterator& operator--() {
+			if (_pos == 0) {
+				_leaf = _leaf->prev;
+				_pos = _leaf->count;
+			}
+			--_pos;
+			return *this;
+		}
+
+		btree_iterator operator--(int) {
+			btree_iterator tmp(*this);
+			--*this;
+			return tmp;
+		}
+
+		bool operator==(const btree_iterator& rhs) const { return _leaf == rhs._leaf && _pos == rhs._pos; }
+		bool operator!=(const btree_iterator& rhs) const { return !(*this == rhs); }
+};
+
+
+template <typename T>
+class btree_const_iterator {
+	public:
+		typedef T									value_type;
+		typedef const T*							pointer;
+		typedef const T&							reference;
+		typedef ptrdiff_t							difference_type;
+		typedef std::bidirectional_iterator_tag		iterator_category;
+		const btreeLeaf<T>*	_leaf;
+		size_t				_pos;
+
+		btree_const_iterator() : _leaf(NULL), _pos(0) { }
+		btree_const_iterator(const btreeLeaf<T>* leaf, size_t pos) : _leaf(leaf), _pos(pos) { }
+		btree_const_iterator(const btree_const_iterator& other) : _leaf(other._leaf), _pos(other._pos) { }
+		btree_const_iterator(const btree_iterator<T>& other) : _leaf(other._leaf), _pos(other._pos) { }
+		btree_const_iterator& operator=(const btree_const_iterator& rhs) {
+			_leaf = rhs._leaf;
+			_pos = rhs._pos;
+			return *this;
+		}
+		~btree_const_iterator() { }
+
+		reference operator*() const { return _leaf->slots()[_pos]; }
+		pointer operator->() const { return _leaf->slots() + _pos; }
+
+		btree_const_iterator& operator++() {
+			if (++_pos == _leaf->count && _leaf->next) {
+				_leaf = _leaf->next;
+				_pos = 0;
+			}
+			return *this;
+		}
+
+		btree_const_iterator operator++(int) {
+			btree_const_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		btree_const_iterator& operator--() {
+			if (_pos == 0) {
+				_leaf = _leaf->prev;
+				_pos = _leaf->count;
+			}
+			--_pos;
+			return *this;
+		}
+
+		btree_const_iterator operator--(int) {
+			btree_const_iterator tmp(*this);
+			--*this;
+			return tmp;
+		}
+
+		bool operator==(const btree_const_iterator& rhs) const { return _leaf == rhs._leaf && _pos == rhs._pos; }
+		bool operator!=(const btree_const_iterator& rhs) const { return !(*this == rhs); }
+};
+
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Compare, typename Alloc>
+class BTree {
+	public:
+		typedef btreeNodeBase						node;
+		typedef btreeLeaf<ValueType>				leaf;
+		typedef btreeInternal<Key>					internal;
+		typedef btree_iterator<ValueType>			iterator;
+		typedef btree_const_iterator<ValueType>		const_iterator;
+
+		static const int	max_depth = 32;		// fanout이 3 이상이므로 3^32 > 2^50 개까지
+
+		/* locate()의 결과. 찾아 내려온 internal node와 그 안에서 고른 자식 번호를 root부터 들고 있어서
+		 * insert_at, erase가 부모를 다시 찾지 않는다. found가 아니면 (leaf, index)가 key를 넣을 자리다. */
+		struct position {
+			leaf*		node;
+			size_t		index;
+			bool		found;
+			int			depth;
+			internal*	path[max_depth];
+			size_t		slot[max_depth];
+		};
+
+	private:
+		typedef typename Alloc::template rebind<ValueType>::other	value_allocator;
+		typedef typename Alloc::template rebind<Key>::other			key_allocator;
+		typedef typename Alloc::template rebind<leaf>::other		leaf_allocator;
+		typedef typename Alloc::template rebind<internal>::other	internal_allocator;
+
+		node*				_root;
+		leaf*				_leftmost;
+		leaf*				_rightmost;
+		size_t				_size;
+		Compare				_comp;
+		KeyOfValue			_kov;
+		value_allocator		_alloc;
+		key_allocator		_key_alloc;
+		leaf_allocator		_leaf_alloc;
+		internal_allocator	_internal_alloc;
+
+		BTree& operator=(const BTree& rhs);
+
+		const Key&	_key(const ValueType& v) const { return _kov(v); }
+
+		leaf*	_new_leaf() {
+			leaf* l = _leaf_alloc.allocate(1);
+			::new (static_cast<void*>(l)) leaf();
+			return l;
+		}
+		internal*	_new_internal() {
+			internal* n = _internal_alloc.allocate(1);
+			::new (static_cast<void*>(n)) internal();
+			return n;
+		}
+		void	_free_leaf(leaf* l)			{ _leaf_alloc.deallocate(l, 1); }
+		void	_free_internal(internal* n)	{ _internal_alloc.deallocate(n, 1); }
+
+		/* n개를 src에서 dst로 옮긴다. 두 구간이 겹쳐도 된다. dst는 비어 있는 칸이 되고 src는 비워진다. */
+		template <typename U, typename A>
+		static void	_relocate(A& a, U* dst, U* src, size_t n) {
+			if (n == 0 || dst == src)
+				return;
+			if (is_trivially_relocatable<U>::value) {
+				std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(U));
+				return;
+			}
+			if (dst < src) {
+				for (size_t i = 0; i < n; i++) {
+					a.construct(dst + i, src[i]);
+					a.destroy(src + i);
+				}
+			} else {
+				for (size_t i = n; i-- > 0; ) {
+					a.construct(dst + i, src[i]);
+					a.destroy(src + i);
+				}
+			}
+		}
+
+		void	_set_key(internal* n, size_t i, const Key& k) {
+			Key tmp(k);		// k가 같은 배열 안의 key일 수도 있다
+			_key_alloc.destroy(n->keys() + i);
+			_key_alloc.construct(n->keys() + i, tmp);
+		}
+
+		/* k보다 작지 않은 첫 원소의 위치. 범위를 반씩 줄이며 조건부 대입으로 고른다. (분기 예측이 실패할 일이 없다) */
+		size_t	_lower(const leaf* l, const Key& k) const {
+			size_t n = l->count;
+			if (n == 0)
+				return 0;
+			const ValueType* s = l->slots();
+			size_t lo = 0;
+			while (n > 1) {
+				size_t half = n / 2;
+				lo = _comp(_key(s[lo + half]), k) ? lo + half : lo;
+				n -= half;
+			}
+			return lo + _comp(_key(s[lo]), k);
+		}
+
+		/* k보다 큰 첫 원소의 위치 */
+		size_t	_upper(const leaf* l, const Key& k) const {
+			size_t n = l->count;
+			if (n == 0)
+				return 0;
+			const ValueType* s = l->slots();
+			size_t lo = 0;
+			while (n > 1) {
+				size_t half = n / 2;
+				lo = !_comp(k, _key(s[lo + half])) ? lo + half : lo;
+				n -= half;
+			}
+			return lo + !_comp(k, _key(s[lo]));
+		}
+
+		/* k가 들어 있을 자식의 번호. (k 이하인 key의 수) */
+		size_t	_child(const internal* in, const Key& k) const {
+			size_t n = in->count;
+			const Key* keys = in->keys();
+			size_t lo = 0;
+			while (n > 1) {
+				size_t half = n / 2;
+				lo = !_comp(k, keys[lo + half]) ? lo + half : lo;
+				n -= half;
+			}
+			return lo + !_comp(k, keys[lo]);
+		}
+
+		leaf*	_find_leaf(const Key& k) const {
+			node* n = _root;
+			while (!n->leaf) {
+				const internal* in = static_cast<const internal*>(n);
+				n = in->children[_child(in, k)];
+			}
+			return static_cast<leaf*>(n);
+		}
+
+		/* p의 children[c] 뒤에 (sep, right)를 넣는다. p는 capacity + 1 개까지 들어간다. */
+		void	_insert_child(internal* p, size_t c, const Key& sep, node* right) {
+			_relocate(_key_alloc, p->keys() + c + 1, p->keys() + c, p->count - c);
+			try {
+				_key_alloc.construct(p->keys() + c, sep);
+			} catch (...) {
+				_relocate(_key_alloc, p->keys() + c, p->keys() + c + 1, p->count - c);
+				throw;
+			}
+			for (size_t i = p->count + 1; i > c + 1; i--)
+				p->children[i] = p->children[i - 1];
+			p->children[c + 1] = right;
+			p->count++;
+		}
+
+		/* p의 keys[k]와 children[k + 1]을 뺀다. */
+		void	_erase_child(internal* p, size_t k) {
+			_key_alloc.destroy(p->keys() + k);
+			_relocate(_key_alloc, p->keys() + k, p->keys() + k + 1, p->count - k - 1);
+			for (size_t i = k + 1; i < p->count; i++)
+				p->children[i] = p->children[i + 1];
+			p->count--;
+		}
+
+		/* left가 나뉘어 right가 생겼다. 부모들에게 올리면서 넘치는 internal node를 나눈다. root가 나뉘면 높이가 하나 는다.
+		 * 새 internal node는 insert_at이 미리 잡아 둔 spare에서 꺼낸다. */
+		void	_insert_parent(position& pos, node* left, const Key& first_sep, node* right, internal** spare) {
+			Key sep(first_sep);
+			for (int d = pos.depth - 1; d >= 0; d--) {
+				internal* p = pos.path[d];
+				_insert_child(p, pos.slot[d], sep, right);
+				if (p->count <= internal::capacity)
+					return;
+				internal* q = *spare++;
+				size_t mid = p->count / 2;
+				_assign_key(sep, p->keys()[mid]);
+				_key_alloc.destroy(p->keys() + mid);
+				size_t moved = p->count - mid - 1;
+				_relocate(_key_alloc, q->keys(), p->keys() + mid + 1, moved);
+				for (size_t i = 0; i <= moved; i++)
+					q->children[i] = p->children[mid + 1 + i];
+				q->count = moved;
+				p->count = mid;
+				left = p;
+				right = q;
+			}
+			internal* root = *spare;
+			root->children[0] = left;
+			_key_alloc.construct(root->keys(), sep);
+			root->children[1] = right;
+			root->count = 1;
+			_root = root;
+		}
+
+		/* Key는 복사 생성만 된다고 본다. (대입 연산자를 요구하지 않는다) */
+		void	_assign_key(Key& dst, const Key& k) {
+			_key_alloc.destroy(&dst);
+			_key_alloc.construct(&dst, k);
+		}
+
+		/* 합칠 때 : b의 원소를 a 뒤에 붙이고 b를 목록에서 뺀다. */
+		void	_merge_leaves(leaf* a, leaf* b) {
+			_relocate(_alloc, a->slots() + a->count, b->slots(), b->count);
+			a->count += b->count;
+			a->next = b->next;
+			if (b->next)
+				b->next->prev = a;
+			else
+				_rightmost = a;
+			_free_leaf(b);
+		}
+
+		/* p->keys[k]를 사이에 두고 b를 a 뒤에 붙인다. */
+		void	_merge_internal(internal* a, internal* p, size_t k, internal* b) {
+			_key_alloc.construct(a->keys() + a->count, p->keys()[k]);
+			_relocate(_key_alloc, a->keys() + a->count + 1, b->keys(), b->count);
+			for (size_t i = 0; i <= b->count; i++)
+				a->children[a->count + 1 + i] = b->children[i];
+			a->count += b->count + 1;
+			_free_internal(b);
+		}
+
+		/* erase 뒤 leaf가 반 아래로 줄었으면 형제에게서 하나 빌리고, 형제도 여유가 없으면 합친다. 합쳐서 부모가 줄면 위로 올라가며 반복. */
+		void	_rebalance(position& pos) {
+			leaf* l = pos.node;
+			if (pos.depth == 0) {
+				if (l->count == 0) {
+					_free_leaf(l);
+					_root = NULL;
+					_leftmost = _rightmost = NULL;
+				}
+				return;
+			}
+			if (l->count >= leaf::min_count)
+				return;
+			internal* p = pos.path[pos.depth - 1];
+			size_t c = pos.slot[pos.depth - 1];
+			leaf* left = (c > 0) ? static_cast<leaf*>(p->children[c - 1]) : NULL;
+			leaf* right = (c < p->count) ? static_cast<leaf*>(p->children[c + 1]) : NULL;
+			if (left && left->count > leaf::min_count) {
+				_relocate(_alloc, l->slots() + 1, l->slots(), l->count);
+				_relocate(_alloc, l->slots(), left->slots() + left->count - 1, 1);
+				left->count--;
+				l->count++;
+				_set_key(p, c - 1, _key(l->slots()[0]));
+				return;
+			}
+			if (right && right->count > leaf::min_count) {
+				_relocate(_alloc, l->slots() + l->count, right->slots(), 1);
+				_relocate(_alloc, right->slots(), right->slots() + 1, right->count - 1);
+				right->count--;
+				l->count++;
+				_set_key(p, c, _key(right->slots()[0]));
+				return;
+			}
+			if (left) {
+				_merge_leaves(left, l);
+				_erase_child(p, c - 1);
+			} else {
+				_merge_leaves(l, right);
+				_erase_child(p, c);
+			}
+			_rebalance_internal(pos, pos.depth - 1);
+		}
+
+		void	_rebalance_internal(position& pos, int d) {
+			for (; ; d--) {
+				internal* n = pos.path[d];
+				if (d == 0) {
+					if (n->count == 0) {
+						_root = n->children[0];
+						_free_internal(n);
+					}
+					return;
+				}
+				if (n->count >= internal::min_count)
+					return;
+				internal* p = pos.path[d - 1];
+				size_t c = pos.slot[d - 1];
+				internal* left = (c > 0) ? static_cast<internal*>(p->children[c - 1]) : NULL;
+				internal* right = (c < p->count) ? static_cast<internal*>(p->children[c + 1]) : NULL;
+				if (left && left->count > internal::min_count) {
+					// 부모의 key가 n의 맨 앞으로 내려오고, left의 마지막 key가 부모로 올라간다.
+					_relocate(_key_alloc, n->keys() + 1, n->keys(), n->count);
+					_key_alloc.construct(n->keys(), p->keys()[c - 1]);
+					for (size_t i = n->count + 1; i > 0; i--)
+						n->children[i] = n->children[i - 1];
+					n->children[0] = left->children[left->count];
+					n->count++;
+					_set_key(p, c - 1, left->keys()[left->count - 1]);
+					_key_alloc.destroy(left->keys() + left->count - 1);
+					left->count--;
+					return;
+				}
+				if (right && right->count > internal::min_count) {
+					_key_alloc.construct(n->keys() + n->count, p->keys()[c]);
+					n->children[n->count + 1] = right->children[0];
+					n->count++;
+					_set_key(p, c, right->keys()[0]);
+					_key_alloc.destroy(right->keys());
+					_relocate(_key_alloc, right->keys(), right->keys() + 1, right->count - 1);
+					for (size_t i = 0; i < right->count; i++)
+						right->children[i] = right->children[i + 1];
+					right->count--;
+					return;
+				}
+				if (left) {
+					_merge_internal(left, p, c - 1, n);
+					_erase_child(p, c - 1);
+				} else {
+					_merge_internal(n, p, c, right);
+					_erase_child(p, c);
+				}
+			}
+		}
+
+		void	_destroy(node* n) {
+			if (n->leaf) {
+				leaf* l = static_cast<leaf*>(n);
+				if (!is_trivially_relocatable<ValueType>::value)
+					for (size_t i = 0; i < l->count; i++)
+						_alloc.destroy(l->slots() + i);
+				_free_leaf(l);
+				return;
+			}
+			internal* in = static_cast<internal*>(n);
+			for (size_t i = 0; i <= in->count; i++)
+				_destroy(in->children[i]);
+			for (size_t i = 0; i < in->count; i++)
+				_key_alloc.destroy(in->keys() + i);
+			_free_internal(in);
+		}
+
+		// 검사용 : n 아래 key가 모두 [lo, hi) 안에 있고 leaf 깊이가 같은지
+		int		_check(const node* n, const Key* lo, const Key* hi, bool is_root) const {
+			if (n->leaf) {
+				const leaf* l = static_cast<const leaf*>(n);
+				if (l->count == 0 || l->count > leaf::capacity || (!is_root && l->count < leaf::min_count))
+					return -1;
+				for (size_t i = 0; i < l->count; i++) {
+					const Key& k = _key(l->slots()[i]);
+					if ((i > 0 && !_comp(_key(l->slots()[i - 1]), k)) || (lo && _comp(k, *lo)) || (hi && !_comp(k, *hi)))
+						return -1;
+				}
+				return 1;
+			}
+			const internal* in = static_cast<const internal*>(n);
+			if (in->count == 0 || in->count > internal::capacity || (!is_root && in->count < internal::min_count))
+				return -1;
+			int height = -1;
+			for (size_t i = 0; i <= in->count; i++) {
+				const Key* clo = (i == 0) ? lo : in->keys() + i - 1;
+				const Key* chi = (i == in->count) ? hi : in->keys() + i;
+				int h = _check(in->children[i], clo, chi, false);
+				if (h < 0 || (height >= 0 && h != height))
+					return -1;
+				height = h;
+			}
+			return height + 1;
+		}
+
+	public:
+		BTree(const Compare& comp, const Alloc& alloc)
+			: _root(NULL), _leftmost(NULL), _rightmost(NULL), _size(0), _comp(comp), _kov(),
+				_alloc(alloc), _key_alloc(alloc), _leaf_alloc(alloc), _internal_alloc(alloc) { }
+
+		// 원소를 순서대로 읽어 한 번에 쌓는다. O(n)
+		BTree(const BTree& other)
+			: _root(NULL), _leftmost(NULL), _rightmost(NULL), _size(0), _comp(other._comp), _kov(),
+				_alloc(other._alloc), _key_alloc(other._key_alloc), _leaf_alloc(other._leaf_alloc), _internal_alloc(other._internal_alloc) {
+				build_sorted(other.begin(), other.end(), other._size);
+		}
+
+		~BTree() { clear(); }
+
+		size_t	getSize() const		{ return _size; }
+		size_t	max_size() const	{ return _alloc.max_size(); }
+
+		iterator		begin()			{ return iterator(_leftmost, 0); }
+		const_iterator	begin() const	{ return const_iterator(_leftmost, 0); }
+		iterator		end()			{ return iterator(_rightmost, _rightmost ? _rightmost->count : 0); }
+		const_iterator	end() const		{ return const_iterator(_rightmost, _rightmost ? _rightmost->count : 0); }
+
+		/* leaf 끝 위치(count)는 다음 leaf의 처음으로 바꾼다. 마지막 leaf면 그대로 end() */
+		iterator	make_iterator(leaf* l, size_t i) {
+			if (l && i == l->count && l->next)
+				return iterator(l->next, 0);
+			return iterator(l, i);
+		}
+		const_iterator	make_iterator(const leaf* l, size_t i) const {
+			if (l && i == l->count && l->next)
+				return const_iterator(l->next, 0);
+			return const_iterator(l, i);
+		}
+
+		position	locate(const Key& k) const {
+			position pos;
+			pos.depth = 0;
+			pos.found = false;
+			pos.index = 0;
+			pos.node = NULL;
+			if (_root == NULL)
+				return pos;
+			node* n = _root;
+			while (!n->leaf) {
+				internal* in = static_cast<internal*>(n);
+				size_t c = _child(in, k);
+				pos.path[pos.depth] = in;
+				pos.slot[pos.depth++] = c;
+				n = in->children[c];
+			}
+			pos.node = static_cast<leaf*>(n);
+			pos.index = _lower(pos.node, k);
+			pos.found = (pos.index < pos.node->count && !_comp(k, _key(pos.node->slots()[pos.index])));
+			return pos;
+		}
+
+		/* locate가 찾지 못한 자리에 v를 넣는다. leaf가 넘치면 반으로 나눈다.
+		 * 나누면서 필요한 node(leaf 하나와 위로 이어서 꽉 찬 internal node 수만큼, root까지 차 있으면 새 root)를 먼저 모두 할당하므로
+		 * 할당이나 v의 복사가 실패하면 tree는 그대로다. (원소와 key를 옮기는 복사 생성자는 ft::vector처럼 던지지 않는다고 본다) */
+		iterator	insert_at(position& pos, const ValueType& v) {
+			if (_root == NULL) {
+				leaf* l = _new_leaf();
+				_root = _leftmost = _rightmost = l;
+				pos.node = l;
+				pos.index = 0;
+				pos.depth = 0;
+			}
+			leaf* l = pos.node;
+			size_t i = pos.index;
+			leaf* r = NULL;
+			internal* spare[max_depth + 1];
+			int nspare = 0;
+			try {
+				if (l->count == leaf::capacity) {
+					r = _new_leaf();
+					int d = pos.depth - 1;
+					while (d >= 0 && pos.path[d]->count == internal::capacity) {
+						spare[nspare] = _new_internal();
+						nspare++;
+						d--;
+					}
+					if (d < 0) {
+						spare[nspare] = _new_internal();
+						nspare++;
+					}
+				}
+				_relocate(_alloc, l->slots() + i + 1, l->slots() + i, l->count - i);
+				try {
+					_alloc.construct(l->slots() + i, v);
+				} catch (...) {
+					_relocate(_alloc, l->slots() + i, l->slots() + i + 1, l->count - i);
+					throw;
+				}
+			} catch (...) {
+				if (r)
+					_free_leaf(r);
+				while (nspare > 0)
+					_free_internal(spare[--nspare]);
+				if (_size == 0) {
+					_free_leaf(l);
+					_root = _leftmost = _rightmost = NULL;
+				}
+				throw;
+			}
+			l->count++;
+			_size++;
+			if (r == NULL)
+				return iterator(l, i);
+
+			size_t half = l->count / 2;
+			_relocate(_alloc, r->slots(), l->slots() + half, l->count - half);
+			r->count = l->count - half;
+			l->count = half;
+			r->prev = l;
+			r->next = l->next;
+			if (l->next)
+				l->next->prev = r;
+			else
+				_rightmost = r;
+			l->next = r;
+			iterator it = (i < half) ? iterator(l, i) : iterator(r, i - half);
+			_insert_parent(pos, l, _key(r->slots()[0]), r, spare);
+			return it;
+		}
+
+		ft::pair<iterator, bool>	insert(const ValueType& v) {
+			position pos = locate(_key(v));
+			if (pos.found)
+				return ft::make_pair(iterator(pos.node, pos.index), false);
+			return ft::make_pair(insert_at(pos, v), true);
+		}
+
+		iterator		find(const Key& k) {
+			if (_root == NULL)
+				return end();
+			leaf* l = _find_leaf(k);
+			size_t i = _lower(l, k);
+			if (i < l->count && !_comp(k, _key(l->slots()[i])))
+				return iterator(l, i);
+			return end();
+		}
+		const_iterator	find(const Key& k) const {
+			if (_root == NULL)
+				return end();
+			const leaf* l = _find_leaf(k);
+			size_t i = _lower(l, k);
+			if (i < l->count && !_comp(k, _key(l->slots()[i])))
+				return const_iterator(l, i);
+			return end();
+		}
+
+		bool	contains(const Key& k) const { return find(k) != end(); }
+
+		iterator		lower_bound(const Key& k) {
+			if (_root == NULL)
+				return end();
+			leaf* l = _find_leaf(k);
+			return make_iterator(l, _lower(l, k));
+		}
+		const_iterator	lower_bound(const Key& k) const {
+			if (_root == NULL)
+				return end();
+			const leaf* l = _find_leaf(k);
+			return make_iterator(l, _lower(l, k));
+		}
+		iterator		upper_bound(const Key& k) {
+			if (_root == NULL)
+				return end();
+			leaf* l = _find_leaf(k);
+			return make_iterator(l, _upper(l, k));
+		}
+		const_iterator	upper_bound(const Key& k) const {
+			if (_root == NULL)
+				return end();
+			const leaf* l = _find_leaf(k);
+			return make_iterator(l, _upper(l, k));
+		}
+
+		size_t	erase(const Key& k) {
+			position pos = locate(k);
+			if (!pos.found)
+				return 0;
+			leaf* l = pos.node;
+			_alloc.destroy(l->slots() + pos.index);
+			_relocate(_alloc, l->slots() + pos.index, l->slots() + pos.index + 1, l->count - pos.index - 1);
+			l->count--;
+			_size--;
+			_rebalance(pos);
+			return 1;
+		}
+
+		void	erase(const_iterator pos) {
+			erase(_key(*pos));
+		}
+
+		/* 지울 때마다 원소가 옮겨지므로 iterator 대신 다음 key로 이어 간다. O(m log n) (전부면 clear) */
+		size_t	erase(const_iterator first, const_iterator last) {
+			size_t n = 0;
+			for (const_iterator it = first; it != last; ++it)
+				n++;
+			if (n == _size) {
+				clear();
+				return n;
+			}
+			if (n == 0)
+				return 0;
+			Key k(_key(*first));
+			for (size_t i = 0; ; ) {
+				erase(k);
+				if (++i == n)
+					break;
+				_assign_key(k, _key(*lower_bound(k)));
+			}
+			return n;
+		}
+
+		void	clear() {
+			if (_root)
+				_destroy(_root);
+			_root = NULL;
+			_leftmost = _rightmost = NULL;
+			_size = 0;
+		}
+
+		void	swap(BTree& other) {
+			std::swap(_root, other._root);
+			std::swap(_leftmost, other._leftmost);
+			std::swap(_rightmost, other._rightmost);
+			std::swap(_size, other._size);
+			std::swap(_comp, other._comp);
+			std::swap(_alloc, other._alloc);
+			std::swap(_key_alloc, other._key_alloc);
+			std::swap(_leaf_alloc, other._leaf_alloc);
+			std::swap(_internal_alloc, other._internal_alloc);
+		}
+
+		/* tree를 key 순서로 정렬된 [first, last)로 바꾼다. 같은 key는 처음 것만 남는다. n은 서로 다른 key의 수.
+		 * leaf를 고르게 꽉 채워 왼쪽부터 만들고, 그 위로 internal level을 한 층씩 쌓는다. 자리를 찾지 않으므로 O(n) */
+		template <typename ForwardIt>
+		void	build_sorted(ForwardIt first, ForwardIt last, size_t n) {
+			(void)last;
+			clear();
+			if (n == 0)
+				return;
+			size_t nleaves = (n + leaf::capacity - 1) / leaf::capacity;
+			ft::vector<node*> level;
+			ft::vector<node*> next;
+			ft::vector<const Key*> mins;
+			ft::vector<const Key*> next_mins;
+			ft::vector<internal*> built;	// 실패하면 풀어야 할 internal node. push_back이 던지지 않도록 미리 잡아 둔다
+			level.reserve(nleaves);
+			next.reserve(nleaves);
+			mins.reserve(nleaves);
+			next_mins.reserve(nleaves);
+			built.reserve(nleaves);
+			try {
+				const Key* prev = NULL;
+				for (size_t li = 0; li < nleaves; li++) {
+					size_t cnt = n / nleaves + (li < n % nleaves);
+					leaf* l = _new_leaf();
+					l->prev = _rightmost;
+					if (_rightmost)
+						_rightmost->next = l;
+					else
+						_leftmost = l;
+					_rightmost = l;
+					level.push_back(l);
+					for (; l->count < cnt; ++first) {
+						if (prev && !_comp(*prev, _key(*first)))
+							continue;
+						_alloc.construct(l->slots() + l->count, *first);
+						prev = &_key(l->slots()[l->count++]);
+						_size++;
+					}
+					mins.push_back(&_key(l->slots()[0]));
+				}
+				while (level.size() > 1) {
+					size_t m = level.size();
+					size_t groups = (m + internal::capacity) / (internal::capacity + 1);
+					size_t at = 0;
+					for (size_t g = 0; g < groups; g++) {
+						size_t cnt = m / groups + (g < m % groups);
+						internal* in = _new_internal();
+						built.push_back(in);
+						next.push_back(in);
+						next_mins.push_back(mins[at]);
+						in->children[0] = level[at];
+						for (size_t j = 1; j < cnt; j++) {
+							_key_alloc.construct(in->keys() + j - 1, *mins[at + j]);
+							in->children[j] = level[at + j];
+							in->count++;
+						}
+						at += cnt;
+					}
+					level.swap(next);
+					mins.swap(next_mins);
+					next.clear();
+					next_mins.clear();
+				}
+				_root = level[0];
+			} catch (...) {
+				// 아직 root가 없으므로 만든 것을 직접 푼다. internal은 built로, leaf는 prev / next 목록으로
+				for (size_t i = 0; i < built.size(); i++) {
+					for (size_t j = 0; j < built[i]->count; j++)
+						_key_alloc.destroy(built[i]->keys() + j);
+					_free_internal(built[i]);
+				}
+				while (_leftmost) {
+					leaf* l = _leftmost;
+					_leftmost = l->next;
+					for (size_t i = 0; i < l->count; i++)
+						_alloc.destroy(l->slots() + i);
+					_free_leaf(l);
+				}
+				_rightmost = NULL;
+				_size = 0;
+				throw;
+			}
+		}
+
+		/* [first, last)가 key 순서로 정렬되어 있으면 O(n)에 쌓고 true. 아니면 tree를 건드리지 않고 false */
+		template <typename ForwardIt>
+		bool	build_if_sorted(ForwardIt first, ForwardIt last) {
+			size_t n = 0;
+			if (first != last) {
+				n = 1;
+				ForwardIt prev = first;
+				for (ForwardIt it = prev; ++it != last; prev = it) {
+					if (_comp(_key(*it), _key(*prev)))
+						return false;
+					if (_comp(_key(*prev), _key(*it)))
+						n++;
+				}
+			}
+			build_sorted(first, last, n);
+			return true;
+		}
+
+		/* 모든 leaf가 같은 깊이이고, node의 원소 수와 key 순서가 맞는지 */
+		bool	isValid() const {
+			if (_root == NULL)
+				return _size == 0 && _leftmost == NULL && _rightmost == NULL;
+			if (_check(_root, NULL, NULL, true) < 0)
+				return false;
+			size_t n = 0;
+			const leaf* prev = NULL;
+			for (const leaf* l = _leftmost; l; prev = l, l = l->next) {
+				if (l->prev != prev)
+					return false;
+				n += l->count;
+			}
+			return prev == _rightmost && n == _size;
+		}
+};
+
+
+}
+#endif
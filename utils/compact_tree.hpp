@@ -0,0 +1,739 @@
+#ifndef COMPACT_TREE_HPP
+# define COMPACT_TREE_HPP
+
+# include <cstddef> // size_t, ptrdiff_t
+# include <new> // placement new
+# include <stdexcept> // length_error
+# include <iterator> // bidirectional_iterator_tag
+# include <algorithm> // swap
+# include "../vector.hpp"
+# include "pair.hpp"
+# include "node.hpp" // RB_Color
+# include "pool_allocator.hpp" // alignment_of_helper
+# include "is_trivially_relocatable.hpp"
+
+/* compact_map, compact_set 이 쓰는 Red-Black Tree.
+ *
+ * RB_Tree와 같은 규칙으로 균형을 맞추지만, node를 하나씩 할당하지 않고 ft::vector 하나(arena)에 모아 두고
+ * 포인터 대신 32 bit index로 잇는다. node마다 붙는 것은 index 3개(left, right, parent)뿐이고 색은 parent의 가장 높은 bit에 넣는다.
+ * 64 bit에서 포인터 3개(24 byte)이던 것이 12 byte가 되고, malloc이 chunk마다 붙이는 머리와 정렬 padding도 없다.
+ *   set<int>     : node 32 byte (malloc으로는 48) -> 16 byte
+ *   map<int,int> : node 32 byte (malloc으로는 48) -> 20 byte
+ *
+ * - 지운 node의 자리는 free list(left로 이어진다)에 넣었다가 다음 insert가 다시 쓴다. arena는 줄어들지 않는다.
+ * - node가 옮겨 다니지 않으므로(지울 때도 값을 옮기지 않고 연결만 바꾼다) index가 곧 원소의 주소다.
+ *   iterator는 (tree, index)라서 arena가 재할당되어도 유효하다. 지운 원소의 iterator만 무효화되고, swap은 모든 iterator를 무효화한다.
+ * - 복사는 arena를 통째로 복사한다. 원소가 is_trivially_relocatable이면 memcpy 한 번이다.
+ * - 원소는 2^31 - 1 개까지 넣을 수 있다.
+ */
+
+namespace ft {
+
+typedef unsigned int	compact_index;
+
+static const compact_index	compact_nil = 0x7FFFFFFFu;		// NULL 대신
+static const compact_index	compact_red = 0x80000000u;		// parent의 가장 높은 bit
+static const compact_index	compact_free = 0xFFFFFFFFu;		// 빈 자리의 right
+
+/* T와 같은 정렬을 갖는 타입. (c++98에는 alignas가 없다) */
+template <size_t Align>
+struct compact_align			{ typedef long double	type; };
+template <>
+struct compact_align<1>			{ typedef char			type; };
+template <>
+struct compact_align<2>			{ typedef short			type; };
+template <>
+struct compact_align<4>			{ typedef int			type; };
+template <>
+struct compact_align<8>			{ typedef double		type; };
+
+/* 원소를 담을 수 있는 크기와 정렬의 빈 공간. 빈 자리(free)에는 원소가 없으므로 node가 직접 생성, 소멸을 관리한다. */
+template <typename T>
+union compact_storage {
+	char	raw[sizeof(T)];
+	typename compact_align<sizeof(alignment_of_helper<T>) - sizeof(T)>::type	align;
+};
+
+template <typename ValueType>
+struct compactNode {
+	compact_storage<ValueType>	storage;
+	compact_index				left;
+	compact_index				right;			// 빈 자리면 compact_free
+	compact_index				parent_color;
+
+	// 빈 자리
+	compactNode() : left(compact_nil), right(compact_free), parent_color(compact_nil) { }
+	compactNode(const compactNode& other) : left(other.left), right(other.right), parent_color(other.parent_color) {
+		if (other.live())
+			::new (static_cast<void*>(storage.raw)) ValueType(other.value());
+	}
+	~compactNode() {
+		if (live())
+			value().~ValueType();
+	}
+
+	bool				live() const	{ return right != compact_free; }
+	ValueType&			value()			{ return *reinterpret_cast<ValueType*>(storage.raw); }
+	const ValueType&	value() const	{ return *reinterpret_cast<const ValueType*>(storage.raw); }
+
+	compact_index	parent() const				{ return parent_color & ~compact_red; }
+	void			set_parent(compact_index p)	{ parent_color = p | (parent_color & compact_red); }
+	bool			red() const					{ return (parent_color & compact_red) != 0; }
+	void			set_color(bool c)			{ parent_color = (parent_color & ~compact_red) | (c == RED ? compact_red : 0); }
+
+	private:
+	compactNode& operator=(const compactNode& rhs);
+};
+
+/* 원소가 memcpy로 옮겨도 되면 node도 그렇다. (빈 자리에는 원소가 없다) */
+template <typename ValueType>
+struct is_trivially_relocatable< compactNode<ValueType> > : public is_trivially_relocatable<ValueType> { };
+
+
+/* (tree, index). end()는 compact_nil이고, --end()는 가장 큰 원소다. */
+template <typename T, typename Tree>
+class compact_iterator {
+	public:
+		typedef T									value_type;
+		typedef T*									pointer;
+		typedef T&									reference;
+		typedef ptrdiff_t							difference_type;
+		typedef std::bidirectional_iterator_tag		iterator_category;
+		Tree*			_tree;
+		compact_index	_index;
+
+		compact_iterator() : _tree(NULL), _index(compact_nil) { }
+		compact_iterator(Tree* tree, compact_index index) : _tree(tree), _index(index) { }
+		compact_iterator(const compact_iterator& other) : _tree(other._tree), _index(other._index) { }
+		compact_iterator& operator=(const compact_iterator& rhs) {
+			_tree = rhs._tree;
+			_index = rhs._index;
+			return *this;
+		}
+		~compact_iterator() { }
+
+		reference operator*() const { return _tree->value_at(_index); }
+		pointer operator->() const { return &_tree->value_at(_index); }
+
+		compact_iterator& operator++() {
+			_index = _tree->next(_index);
+			return *this;
+		}
+
+		compact_iterator operator++(int) {
+			compact_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		compact_iterator& operator--() {
+			_index = _tree->prev(_index);
+			return *this;
+		}
+
+		compact_iterator operator--(int) {
+			compact_iterator tmp(*this);
+			--*this;
+			return tmp;
+		}
+
+		bool operator==(const compact_iterator& rhs) const { return _index == rhs._index; }
+		bool operator!=(const compact_iterator& rhs) const { return _index != rhs._index; }
+};
+
+
+template <typename T, typename Tree>
+class compact_const_iterator {
+	public:
+		typedef T									value_type;
+		typedef const T*							pointer;
+		typedef const T&							reference;
+		typedef ptrdiff_t							difference_type;
+		typedef std::bidirectional_iterator_tag		iterator_category;
+		const Tree*		_tree;
+		compact_index	_index;
+
+		compact_const_iterator() : _tree(NULL), _index(compact_nil) { }
+		compact_const_iterator(const Tree* tree, compact_index index) : _tree(tree), _index(index) { }
+		compact_const_iterator(const compact_const_iterator& other) : _tree(other._tree), _index(other._index) { }
+		compact_const_iterator(const compact_iterator<T, Tree>& other) : _tree(other._tree), _index(other._index) { }
+		compact_const_iterator& operator=(const compact_const_iterator& rhs) {
+			_tree = rhs._tree;
+			_index = rhs._index;
+			return *this;
+		}
+		~compact_const_iterator() { }
+
+		reference operator*() const { return _tree->value_at(_index); }
+		pointer operator->() const { return &_tree->value_at(_index); }
+
+		compact_const_iterator& operator++() {
+			_index = _tree->next(_index);
+			return *this;
+		}
+
+		compact_const_iterator operator++(int) {
+			compact_const_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		compact_const_iterator& operator--() {
+			_index = _tree->prev(_index);
+			return *this;
+		}
+
+		compact_const_iterator operator--(int) {
+			compact_const_iterator tmp(*this);
+			--*this;
+			return tmp;
+		}
+
+		bool operator==(const compact_const_iterator& rhs) const { return _index == rhs._index; }
+		bool operator!=(const compact_const_iterator& rhs) const { return _index != rhs._index; }
+};
+
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Compare, typename Alloc>
+class CompactTree {
+	public:
+		typedef compactNode<ValueType>									node;
+		typedef compact_iterator<ValueType, CompactTree>				iterator;
+		typedef compact_const_iterator<ValueType, CompactTree>			const_iterator;
+
+		/* locate()의 결과. found가 nil이 아니면 key가 있는 자리, 아니면 parent의 (left면 왼쪽) 자식으로 이을 자리다. */
+		struct position {
+			compact_index	found;
+			compact_index	parent;
+			bool			left;
+		};
+
+	private:
+		typedef typename Alloc::template rebind<node>::other	node_allocator;
+		typedef ft::vector<node, node_allocator>				arena_type;
+
+		arena_type		_nodes;
+		compact_index	_root;
+		compact_index	_leftmost;
+		compact_index	_rightmost;
+		compact_index	_free;			// 빈 자리 목록의 처음
+		size_t			_size;
+		Compare			_comp;
+		KeyOfValue		_kov;
+
+		CompactTree& operator=(const CompactTree& rhs);
+
+		node&			_n(compact_index i)			{ return _nodes[i]; }
+		const node&		_n(compact_index i) const	{ return _nodes[i]; }
+		const Key&		_key(compact_index i) const	{ return _kov(_nodes[i].value()); }
+		bool			_is_red(compact_index i) const	{ return i != compact_nil && _nodes[i].red(); }
+
+		compact_index	_min(compact_index i) const {
+			while (_n(i).left != compact_nil)
+				i = _n(i).left;
+			return i;
+		}
+		compact_index	_max(compact_index i) const {
+			while (_n(i).right != compact_nil)
+				i = _n(i).right;
+			return i;
+		}
+
+		/* 빈 자리가 있으면 쓰고, 없으면 arena 끝에 하나 붙인다. 그 자리에 v를 바로 생성한다. */
+		compact_index	_new_node(const ValueType& v, compact_index parent) {
+			compact_index i = _free;
+			if (i == compact_nil) {
+				if (_nodes.size() >= compact_nil)
+					throw std::length_error("compact tree");
+				_nodes.push_back(node());
+				i = static_cast<compact_index>(_nodes.size() - 1);
+			} else {
+				_free = _n(i).left;
+			}
+			try {
+				::new (static_cast<void*>(_n(i).storage.raw)) ValueType(v);
+			} catch (...) {
+				_n(i).left = _free;
+				_free = i;
+				throw;
+			}
+			node& n = _n(i);
+			n.left = n.right = compact_nil;
+			n.parent_color = parent | compact_red;
+			return i;
+		}
+
+		void	_free_node(compact_index i) {
+			node& n = _n(i);
+			n.value().~ValueType();
+			n.right = compact_free;
+			n.left = _free;
+			_free = i;
+		}
+
+		/* p의 자리(p의 부모에서 p를 가리키던 곳, 또는 root)를 c로 바꾼다. */
+		void	_replace_child(compact_index p, compact_index c) {
+			compact_index pp = _n(p).parent();
+			if (pp == compact_nil)
+				_root = c;
+			else if (_n(pp).left == p)
+				_n(pp).left = c;
+			else
+				_n(pp).right = c;
+		}
+
+		void	_rotate_left(compact_index x) {
+			compact_index y = _n(x).right;
+			_n(x).right = _n(y).left;
+			if (_n(y).left != compact_nil)
+				_n(_n(y).left).set_parent(x);
+			_n(y).set_parent(_n(x).parent());
+			_replace_child(x, y);
+			_n(y).left = x;
+			_n(x).set_parent(y);
+		}
+
+		void	_rotate_right(compact_index x) {
+			compact_index y = _n(x).left;
+			_n(x).left = _n(y).right;
+			if (_n(y).right != compact_nil)
+				_n(_n(y).right).set_parent(x);
+			_n(y).set_parent(_n(x).parent());
+			_replace_child(x, y);
+			_n(y).right = x;
+			_n(x).set_parent(y);
+		}
+
+		/* 새로 이은 red node x부터 위로 올라가며 red가 연달아 오지 않도록 고친다. */
+		void	_insert_fixup(compact_index x) {
+			while (x != _root && _is_red(_n(x).parent())) {
+				compact_index p = _n(x).parent();
+				compact_index g = _n(p).parent();
+				if (p == _n(g).left) {
+					compact_index u = _n(g).right;
+					if (_is_red(u)) {				// 부모와 삼촌이 red : 둘을 black, 할아버지를 red로 하고 위에서 다시
+						_n(p).set_color(BLACK);
+						_n(u).set_color(BLACK);
+						_n(g).set_color(RED);
+						x = g;
+						continue;
+					}
+					if (x == _n(p).right) {			// 꺾인 모양은 한 번 돌려서 펴고
+						x = p;
+						_rotate_left(x);
+						p = _n(x).parent();
+					}
+					_n(p).set_color(BLACK);			// 할아버지를 기준으로 돌린다
+					_n(g).set_color(RED);
+					_rotate_right(g);
+				} else {
+					compact_index u = _n(g).left;
+					if (_is_red(u)) {
+						_n(p).set_color(BLACK);
+						_n(u).set_color(BLACK);
+						_n(g).set_color(RED);
+						x = g;
+						continue;
+					}
+					if (x == _n(p).left) {
+						x = p;
+						_rotate_right(x);
+						p = _n(x).parent();
+					}
+					_n(p).set_color(BLACK);
+					_n(g).set_color(RED);
+					_rotate_left(g);
+				}
+			}
+			_n(_root).set_color(BLACK);
+		}
+
+		/* z를 tree에서 떼어내고 균형을 고친다. 자식이 둘이면 값을 옮기지 않고 successor를 z의 자리에 잇는다. (index가 바뀌지 않는다)
+		 * x는 떼어낸 자리를 채운 node(nil일 수 있다)이고, x에서 black이 하나 모자라면 형제 쪽에서 빌리거나 위로 넘긴다. */
+		void	_erase_node(compact_index z) {
+			compact_index y = z;
+			compact_index x;
+			compact_index x_parent;
+			if (_n(z).left == compact_nil)
+				x = _n(z).right;
+			else if (_n(z).right == compact_nil)
+				x = _n(z).left;
+			else {
+				y = _min(_n(z).right);
+				x = _n(y).right;
+			}
+			bool removed_red;
+			if (y != z) {
+				_n(_n(z).left).set_parent(y);
+				_n(y).left = _n(z).left;
+				if (y != _n(z).right) {
+					x_parent = _n(y).parent();
+					if (x != compact_nil)
+						_n(x).set_parent(x_parent);
+					_n(x_parent).left = x;
+					_n(y).right = _n(z).right;
+					_n(_n(z).right).set_parent(y);
+				} else {
+					x_parent = y;
+				}
+				_replace_child(z, y);
+				_n(y).set_parent(_n(z).parent());
+				removed_red = _n(y).red();
+				_n(y).set_color(_n(z).red() ? RED : BLACK);
+			} else {
+				x_parent = _n(z).parent();
+				if (x != compact_nil)
+					_n(x).set_parent(x_parent);
+				_replace_child(z, x);
+				removed_red = _n(z).red();
+				if (_leftmost == z)
+					_leftmost = (x == compact_nil) ? x_parent : _min(x);
+				if (_rightmost == z)
+					_rightmost = (x == compact_nil) ? x_parent : _max(x);
+			}
+			if (!removed_red) {
+				while (x != _root && !_is_red(x)) {
+					if (x == _n(x_parent).left) {
+						compact_index w = _n(x_parent).right;
+						if (_is_red(w)) {
+							_n(w).set_color(BLACK);
+							_n(x_parent).set_color(RED);
+							_rotate_left(x_parent);
+							w = _n(x_parent).right;
+						}
+						if (!_is_red(_n(w).left) && !_is_red(_n(w).right)) {
+							_n(w).set_color(RED);
+							x = x_parent;
+							x_parent = _n(x_parent).parent();
+						} else {
+							if (!_is_red(_n(w).right)) {
+								_n(_n(w).left).set_color(BLACK);
+								_n(w).set_color(RED);
+								_rotate_right(w);
+								w = _n(x_parent).right;
+							}
+							_n(w).set_color(_n(x_parent).red() ? RED : BLACK);
+							_n(x_parent).set_color(BLACK);
+							if (_n(w).right != compact_nil)
+								_n(_n(w).right).set_color(BLACK);
+							_rotate_left(x_parent);
+							break;
+						}
+					} else {
+						compact_index w = _n(x_parent).left;
+						if (_is_red(w)) {
+							_n(w).set_color(BLACK);
+							_n(x_parent).set_color(RED);
+							_rotate_right(x_parent);
+							w = _n(x_parent).left;
+						}
+						if (!_is_red(_n(w).right) && !_is_red(_n(w).left)) {
+							_n(w).set_color(RED);
+							x = x_parent;
+							x_parent = _n(x_parent).parent();
+						} else {
+							if (!_is_red(_n(w).left)) {
+								_n(_n(w).right).set_color(BLACK);
+								_n(w).set_color(RED);
+								_rotate_left(w);
+								w = _n(x_parent).left;
+							}
+							_n(w).set_color(_n(x_parent).red() ? RED : BLACK);
+							_n(x_parent).set_color(BLACK);
+							if (_n(w).left != compact_nil)
+								_n(_n(w).left).set_color(BLACK);
+							_rotate_right(x_parent);
+							break;
+						}
+					}
+				}
+				if (x != compact_nil)
+					_n(x).set_color(BLACK);
+			}
+			_free_node(z);
+			_size--;
+		}
+
+		/* tree_interface.hpp의 _build_sorted와 같다. node를 in-order 순서로 arena에 붙이므로 순회가 arena를 차례로 읽는다. */
+		template <typename ForwardIt>
+		compact_index	_build_sorted(ForwardIt& first, ForwardIt last, size_t n, compact_index parent, size_t depth, size_t red_depth) {
+			if (n == 0)
+				return compact_nil;
+			size_t left_n = (n - 1) / 2;
+			compact_index left = _build_sorted(first, last, left_n, compact_nil, depth + 1, red_depth);
+			compact_index cur = _new_node(*first, parent);
+			_n(cur).set_color((depth == red_depth) ? RED : BLACK);
+			_n(cur).left = left;
+			if (left != compact_nil)
+				_n(left).set_parent(cur);
+			ForwardIt prev = first;
+			while (++first != last && !_comp(_kov(*prev), _kov(*first)))
+				;
+			compact_index right = _build_sorted(first, last, n - 1 - left_n, cur, depth + 1, red_depth);
+			_n(cur).right = right;
+			return cur;
+		}
+
+		// 검사용 : black height, 규칙이 깨졌으면 -1
+		int		_check(compact_index i, compact_index parent) const {
+			if (i == compact_nil)
+				return 1;
+			const node& n = _n(i);
+			if (!n.live() || n.parent() != parent || (n.red() && (_is_red(n.left) || _is_red(n.right))))
+				return -1;
+			if ((n.left != compact_nil && !_comp(_key(n.left), _key(i))) || (n.right != compact_nil && !_comp(_key(i), _key(n.right))))
+				return -1;
+			int l = _check(n.left, i);
+			int r = _check(n.right, i);
+			if (l < 0 || l != r)
+				return -1;
+			return l + !n.red();
+		}
+
+	public:
+		CompactTree(const Compare& comp, const Alloc& alloc)
+			: _nodes(node_allocator(alloc)), _root(compact_nil), _leftmost(compact_nil), _rightmost(compact_nil),
+				_free(compact_nil), _size(0), _comp(comp), _kov() { }
+
+		// arena를 통째로 복사한다. index가 그대로이므로 다시 잇지 않는다.
+		CompactTree(const CompactTree& other)
+			: _nodes(other._nodes), _root(other._root), _leftmost(other._leftmost), _rightmost(other._rightmost),
+				_free(other._free), _size(other._size), _comp(other._comp), _kov() { }
+
+		~CompactTree() { }
+
+		size_t	getSize() const		{ return _size; }
+		size_t	max_size() const	{ return compact_nil; }
+		size_t	capacity() const	{ return _nodes.capacity(); }
+		void	reserve(size_t n)	{ _nodes.reserve(n); }
+
+		iterator		begin()			{ return iterator(this, _leftmost); }
+		const_iterator	begin() const	{ return const_iterator(this, _leftmost); }
+		iterator		end()			{ return iterator(this, compact_nil); }
+		const_iterator	end() const		{ return const_iterator(this, compact_nil); }
+
+		ValueType&			value_at(compact_index i)		{ return _nodes[i].value(); }
+		const ValueType&	value_at(compact_index i) const	{ return _nodes[i].value(); }
+
+		// in-order 다음. 마지막 다음은 nil(end)
+		compact_index	next(compact_index i) const {
+			if (_n(i).right != compact_nil)
+				return _min(_n(i).right);
+			compact_index p = _n(i).parent();
+			while (p != compact_nil && i == _n(p).right) {
+				i = p;
+				p = _n(p).parent();
+			}
+			return p;
+		}
+
+		// in-order 이전. end(nil)의 이전은 가장 큰 원소
+		compact_index	prev(compact_index i) const {
+			if (i == compact_nil)
+				return _rightmost;
+			if (_n(i).left != compact_nil)
+				return _max(_n(i).left);
+			compact_index p = _n(i).parent();
+			while (p != compact_nil && i == _n(p).left) {
+				i = p;
+				p = _n(p).parent();
+			}
+			return p;
+		}
+
+		position	locate(const Key& k) const {
+			position pos;
+			pos.found = compact_nil;
+			pos.parent = compact_nil;
+			pos.left = true;
+			compact_index cur = _root;
+			while (cur != compact_nil) {
+				pos.parent = cur;
+				if (_comp(k, _key(cur))) {
+					pos.left = true;
+					cur = _n(cur).left;
+				} else if (_comp(_key(cur), k)) {
+					pos.left = false;
+					cur = _n(cur).right;
+				} else {
+					pos.found = cur;
+					return pos;
+				}
+			}
+			return pos;
+		}
+
+		iterator	insert_at(const position& pos, const ValueType& v) {
+			compact_index i = _new_node(v, pos.parent);
+			if (pos.parent == compact_nil) {
+				_root = _leftmost = _rightmost = i;
+			} else if (pos.left) {
+				_n(pos.parent).left = i;
+				if (pos.parent == _leftmost)
+					_leftmost = i;
+			} else {
+				_n(pos.parent).right = i;
+				if (pos.parent == _rightmost)
+					_rightmost = i;
+			}
+			_size++;
+			_insert_fixup(i);
+			return iterator(this, i);
+		}
+
+		ft::pair<iterator, bool>	insert(const ValueType& v) {
+			position pos = locate(_kov(v));
+			if (pos.found != compact_nil)
+				return ft::make_pair(iterator(this, pos.found), false);
+			return ft::make_pair(insert_at(pos, v), true);
+		}
+
+		/* hint가 end()이고 v가 가장 큰 원소보다 크면 내려가지 않고 가장 오른쪽에 붙인다. (정렬된 입력) */
+		iterator	insert(const_iterator hint, const ValueType& v) {
+			if (hint._index == compact_nil && _rightmost != compact_nil && _comp(_key(_rightmost), _kov(v))) {
+				position pos;
+				pos.found = compact_nil;
+				pos.parent = _rightmost;
+				pos.left = false;
+				return insert_at(pos, v);
+			}
+			return insert(v).first;
+		}
+
+		iterator		find(const Key& k) {
+			position pos = locate(k);
+			return iterator(this, pos.found);
+		}
+		const_iterator	find(const Key& k) const {
+			position pos = locate(k);
+			return const_iterator(this, pos.found);
+		}
+
+		compact_index	lower_bound(const Key& k) const {
+			compact_index cur = _root;
+			compact_index ret = compact_nil;
+			while (cur != compact_nil) {
+				if (_comp(_key(cur), k))
+					cur = _n(cur).right;
+				else {
+					ret = cur;
+					cur = _n(cur).left;
+				}
+			}
+			return ret;
+		}
+
+		compact_index	upper_bound(const Key& k) const {
+			compact_index cur = _root;
+			compact_index ret = compact_nil;
+			while (cur != compact_nil) {
+				if (_comp(k, _key(cur))) {
+					ret = cur;
+					cur = _n(cur).left;
+				} else
+					cur = _n(cur).right;
+			}
+			return ret;
+		}
+
+		void	erase(const_iterator pos) {
+			_erase_node(pos._index);
+		}
+
+		size_t	erase(const Key& k) {
+			position pos = locate(k);
+			if (pos.found == compact_nil)
+				return 0;
+			_erase_node(pos.found);
+			return 1;
+		}
+
+		// 지워도 다른 원소의 index는 그대로이므로 차례로 지운다.
+		void	erase(const_iterator first, const_iterator last) {
+			if (first._index == _leftmost && last._index == compact_nil) {
+				clear();
+				return;
+			}
+			while (first != last)
+				erase(first++);
+		}
+
+		// arena의 용량은 남겨 둔다.
+		void	clear() {
+			_nodes.clear();
+			_root = _leftmost = _rightmost = _free = compact_nil;
+			_size = 0;
+		}
+
+		void	swap(CompactTree& other) {
+			_nodes.swap(other._nodes);
+			std::swap(_root, other._root);
+			std::swap(_leftmost, other._leftmost);
+			std::swap(_rightmost, other._rightmost);
+			std::swap(_free, other._free);
+			std::swap(_size, other._size);
+			std::swap(_comp, other._comp);
+		}
+
+		/* (비어 있는) tree를 key 순서로 정렬된 [first, last)의 서로 다른 n개로 채운다. O(n) */
+		template <typename ForwardIt>
+		void	build_sorted(ForwardIt first, ForwardIt last, size_t n) {
+			clear();
+			if (n >= compact_nil)
+				throw std::length_error("compact tree");
+			_nodes.reserve(n);
+			size_t full_levels = 0;
+			while (((size_t)2 << full_levels) - 1 <= n)
+				full_levels++;
+			try {
+				_root = _build_sorted(first, last, n, compact_nil, 0, full_levels);
+			} catch (...) {
+				clear();
+				throw;
+			}
+			_size = n;
+			if (n) {
+				_leftmost = _min(_root);
+				_rightmost = _max(_root);
+			}
+		}
+
+		/* [first, last)가 key 순서로 정렬되어 있으면 O(n)에 쌓고 true. 아니면 tree를 건드리지 않고 false */
+		template <typename ForwardIt>
+		bool	build_if_sorted(ForwardIt first, ForwardIt last) {
+			size_t n = 0;
+			if (first != last) {
+				n = 1;
+				ForwardIt prev = first;
+				for (ForwardIt it = prev; ++it != last; prev = it) {
+					if (_comp(_kov(*it), _kov(*prev)))
+						return false;
+					if (_comp(_kov(*prev), _kov(*it)))
+						n++;
+				}
+			}
+			build_sorted(first, last, n);
+			return true;
+		}
+
+		/* RB 규칙, key 순서, parent 연결, 원소 수와 빈 자리 수가 맞는지 */
+		bool	isValid() const {
+			if (_root == compact_nil)
+				return _size == 0 && _leftmost == compact_nil && _rightmost == compact_nil;
+			if (_is_red(_root) || _n(_root).parent() != compact_nil || _check(_root, compact_nil) < 0)
+				return false;
+			if (_leftmost != _min(_root) || _rightmost != _max(_root))
+				return false;
+			size_t free_count = 0;
+			for (compact_index i = _free; i != compact_nil; i = _n(i).left) {
+				if (_n(i).live())
+					return false;
+				free_count++;
+			}
+			return _size + free_count == _nodes.size();
+		}
+};
+
+
+}
+#endif
@@ -0,0 +1,159 @@
+#ifndef EPOCH_HPP
+# define EPOCH_HPP
+
+# include <cstddef> // size_t
+# include "hash.hpp"
+
+/* epoch 기반 메모리 회수 (epoch-based reclamation).
+ *
+ * lock 없이 연결을 끊은 node는 바로 해제할 수 없다. 다른 thread가 끊기 전에 읽은 포인터로 아직 그 node를 보고 있을 수 있다.
+ * 그래서 node를 읽는 구간을 guard로 감싸고, 끊은 node는 retire()로 넘겨둔다.
+ *
+ *   - 전역 epoch e. guard는 들어올 때의 epoch에 자신을 센다. (active[e % 3])
+ *   - retire된 node는 그때의 epoch의 목록(limbo[e % 3])에 들어간다.
+ *   - epoch e-1 에 남은 guard가 없으면 e+1로 넘어간다. 이때 e-2 에 retire된 목록은
+ *     그 node를 볼 수 있었던 guard(e-2 이전에 들어온)가 모두 나갔으므로 해제한다.
+ *
+ * guard 수를 하나의 counter로 세면 모든 연산이 같은 cache line을 두고 다투므로 stripes 개로 나눠 센다. (thread의 stack 주소로 고름)
+ * guard를 오래 잡고 있으면 그동안 retire된 node는 해제되지 않는다. (잘못되지는 않고 메모리만 늦게 돌아온다)
+ */
+
+namespace ft {
+
+/* retire 할 객체가 상속받는 연결 고리. */
+struct epoch_entry {
+	epoch_entry*	retired_next;
+
+	epoch_entry() : retired_next(NULL) { }
+};
+
+class epoch_domain {
+	public:
+		typedef void	(*reclaim_fn)(epoch_entry* e, void* ctx);
+
+		static const int	stripes = 16;
+		static const int	advance_every = 64;		// retire 몇 번마다 epoch를 넘겨보는지
+
+	private:
+		struct counter {
+			size_t	n;
+			char	pad[64 - sizeof(size_t)];
+		};
+
+		counter			_active[3][stripes];
+		size_t			_epoch;
+		epoch_entry*	_limbo[3];
+		int				_advancing;
+		size_t			_retired;
+		reclaim_fn		_reclaim;
+		void*			_ctx;
+
+		epoch_domain(const epoch_domain&);
+		epoch_domain& operator=(const epoch_domain&);
+
+		static int	_stripe() {
+			int local;
+			size_t sp = reinterpret_cast<size_t>(&local) >> 16;		// thread마다 stack이 다르다
+			return static_cast<int>(ft::hash_mix(sp) >> (sizeof(size_t) * 8 - 4)) % stripes;
+		}
+
+		void	_free_list(epoch_entry* e) {
+			while (e) {
+				epoch_entry* next = e->retired_next;
+				_reclaim(e, _ctx);
+				e = next;
+			}
+		}
+
+	public:
+		epoch_domain(reclaim_fn reclaim, void* ctx) : _epoch(0), _advancing(0), _retired(0), _reclaim(reclaim), _ctx(ctx) {
+			for (int i = 0; i < 3; i++) {
+				_limbo[i] = NULL;
+				for (int s = 0; s < stripes; s++)
+					_active[i][s].n = 0;
+			}
+		}
+
+		// no guard may be alive.
+		~epoch_domain() { drain(); }
+
+		/* 읽는 구간. 살아있는 동안 이 domain에 retire된 node는 해제되지 않는다. */
+		class guard {
+			epoch_domain*	_domain;
+			size_t*			_count;
+
+			void	_enter() {
+				if (_domain == NULL)
+					return;
+				int s = _stripe();
+				for (;;) {
+					size_t e = __atomic_load_n(&_domain->_epoch, __ATOMIC_SEQ_CST);
+					_count = &_domain->_active[e % 3][s].n;
+					__atomic_add_fetch(_count, 1, __ATOMIC_SEQ_CST);
+					if (__atomic_load_n(&_domain->_epoch, __ATOMIC_SEQ_CST) == e)
+						return;
+					__atomic_sub_fetch(_count, 1, __ATOMIC_SEQ_CST);		// 그 사이에 epoch가 넘어갔으면 다시
+				}
+			}
+			void	_exit() {
+				if (_count)
+					__atomic_sub_fetch(_count, 1, __ATOMIC_SEQ_CST);
+				_count = NULL;
+			}
+
+			public:
+				guard() : _domain(NULL), _count(NULL) { }
+				explicit guard(epoch_domain& domain) : _domain(&domain), _count(NULL) { _enter(); }
+				guard(const guard& other) : _domain(other._domain), _count(NULL) { _enter(); }
+				// 같은 domain이면 먼저 들어온 쪽이 더 오래된 epoch라 그대로 두어도 rhs가 보는 node를 지킨다.
+				guard& operator=(const guard& rhs) {
+					if (_domain != rhs._domain) {
+						_exit();
+						_domain = rhs._domain;
+						_enter();
+					}
+					return *this;
+				}
+				~guard() { _exit(); }
+		};
+
+		/* 모든 level에서 연결을 끊은 e를 넘긴다. guard 안에서 부를 것. 아무도 볼 수 없게 되면 reclaim(e, ctx)가 불린다. */
+		void	retire(epoch_entry* e) {
+			epoch_entry** head = &_limbo[__atomic_load_n(&_epoch, __ATOMIC_SEQ_CST) % 3];
+			e->retired_next = __atomic_load_n(head, __ATOMIC_RELAXED);
+			while (!__atomic_compare_exchange_n(head, &e->retired_next, e, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+				;
+			if (__atomic_add_fetch(&_retired, 1, __ATOMIC_RELAXED) % advance_every == 0)
+				try_advance();
+		}
+
+		/* epoch e-1 에 남은 guard가 없으면 e+1로 넘기고, e-2 에 retire된 것을 해제한다. 다른 thread가 넘기는 중이면 그냥 돌아간다. */
+		void	try_advance() {
+			if (__atomic_exchange_n(&_advancing, 1, __ATOMIC_ACQUIRE))
+				return;
+			size_t e = __atomic_load_n(&_epoch, __ATOMIC_SEQ_CST);
+			size_t active = 0;
+			for (int s = 0; s < stripes; s++)
+				active += __atomic_load_n(&_active[(e + 2) % 3][s].n, __ATOMIC_SEQ_CST);
+			epoch_entry* old = NULL;
+			if (active == 0) {
+				// epoch가 e인 동안은 (e+1) % 3 목록에 새로 들어오는 것이 없다.
+				old = __atomic_exchange_n(&_limbo[(e + 1) % 3], (epoch_entry*)NULL, __ATOMIC_ACQUIRE);
+				__atomic_store_n(&_epoch, e + 1, __ATOMIC_SEQ_CST);
+			}
+			__atomic_store_n(&_advancing, 0, __ATOMIC_RELEASE);
+			_free_list(old);
+		}
+
+		/* 다른 thread가 쓰고 있지 않을 때만. retire된 것을 모두 해제한다. */
+		void	drain() {
+			for (int i = 0; i < 3; i++) {
+				_free_list(_limbo[i]);
+				_limbo[i] = NULL;
+			}
+		}
+};
+
+
+}
+#endif
@@ -0,0 +1,65 @@
+#ifndef HASH_HPP
+# define HASH_HPP
+
+# include <cstddef> // size_t
+# include <string>
+
+/* c++11의 std::hash 대신 쓰는 hash 함수객체. (c++98에는 없다)
+ * 정수는 std::hash처럼 값을 그대로 돌려준다. 값이 몰려 있어도 골고루 나눠야 하는 쪽(shard, bucket 선택)에서 hash_mix로 섞어 쓴다.
+ * 다른 타입은 ft::hash를 특수화하거나, 컨테이너의 Hash 인자로 직접 넘긴다.
+ */
+
+namespace ft {
+
+template <typename T>
+struct hash;
+
+# define FT_INTEGRAL_HASH(T) \
+	template <> \
+	struct hash<T> { \
+		size_t	operator()(T x) const { return static_cast<size_t>(x); } \
+	};
+
+FT_INTEGRAL_HASH(bool)
+FT_INTEGRAL_HASH(char)
+FT_INTEGRAL_HASH(signed char)
+FT_INTEGRAL_HASH(unsigned char)
+FT_INTEGRAL_HASH(wchar_t)
+FT_INTEGRAL_HASH(short)
+FT_INTEGRAL_HASH(unsigned short)
+FT_INTEGRAL_HASH(int)
+FT_INTEGRAL_HASH(unsigned int)
+FT_INTEGRAL_HASH(long)
+FT_INTEGRAL_HASH(unsigned long)
+FT_INTEGRAL_HASH(long long)
+FT_INTEGRAL_HASH(unsigned long long)
+
+# undef FT_INTEGRAL_HASH
+
+template <typename T>
+struct hash<T*> {
+	size_t	operator()(T* p) const { return reinterpret_cast<size_t>(p); }
+};
+
+/* FNV-1a */
+template <>
+struct hash<std::string> {
+	size_t	operator()(const std::string& s) const {
+		size_t h = static_cast<size_t>(14695981039346656037ULL);
+		for (std::string::size_type i = 0; i < s.size(); i++) {
+			h ^= static_cast<unsigned char>(s[i]);
+			h *= static_cast<size_t>(1099511628211ULL);
+		}
+		return h;
+	}
+};
+
+/* 모든 bit가 위쪽 bit에 영향을 주도록 섞는다. (2^64 / 황금비를 곱하는 Fibonacci hashing)
+ * 결과의 위쪽 bit를 쓸 것. 연속된 정수 key도 고르게 퍼진다. */
+inline size_t	hash_mix(size_t h) {
+	return h * static_cast<size_t>(0x9E3779B97F4A7C15ULL);
+}
+
+
+}
+#endif
@@ -0,0 +1,52 @@
+#ifndef IS_TRIVIALLY_RELOCATABLE_HPP
+# define IS_TRIVIALLY_RELOCATABLE_HPP
+
+# include "is_integral.hpp"
+# include "pair.hpp"
+
+/* is_trivially_relocatable<T>는 T를 memcpy/memmove로 옮겨도 되고, 소멸자가 아무 일도 하지 않는 타입인지를 나타낸다.
+ * vector는 이 값이 true인 타입에 대해 원소 하나씩 construct/destroy 하는 대신 메모리 블록을 통째로 옮긴다.
+ *
+ * c++98에는 POD 여부를 판별할 방법이 없으므로 정수형, 실수형, 포인터와 그들로 이루어진 ft::pair만 true가 된다.
+ * 그 외의 POD 구조체는 사용자가 직접 특수화해서 켤 수 있다.
+ *   namespace ft { template <> struct is_trivially_relocatable<Packet> : public true_type { }; }
+ */
+
+namespace ft {
+
+template <typename T>
+struct is_floating_point_helper : public false_type { };
+
+template <>
+struct is_floating_point_helper<float> : public true_type { };
+
+template <>
+struct is_floating_point_helper<double> : public true_type { };
+
+template <>
+struct is_floating_point_helper<long double> : public true_type { };
+
+
+template <typename T>
+struct is_trivially_relocatable;
+
+template <typename T>
+struct is_trivially_relocatable_helper {
+	static const bool value = is_integral_helper<T>::value || is_floating_point_helper<T>::value;
+};
+
+template <typename T>
+struct is_trivially_relocatable_helper<T*> : public true_type { };
+
+template <typename T1, typename T2>
+struct is_trivially_relocatable_helper< ft::pair<T1, T2> > {
+	static const bool value = is_trivially_relocatable<T1>::value && is_trivially_relocatable<T2>::value;
+};
+
+
+template <typename T>
+struct is_trivially_relocatable : public is_trivially_relocatable_helper< typename remove_cv<T>::type > { };
+
+
+}
+#endif
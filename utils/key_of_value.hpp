@@ -0,0 +1,23 @@
+#ifndef KEY_OF_VALUE_HPP
+# define KEY_OF_VALUE_HPP
+
+/* tree는 원소(value) 전체가 아니라 key끼리 비교한다. KeyOfValue는 value에서 key를 꺼내는 함수객체.
+ * set은 value 자체가 key이고(identity), map은 pair의 first가 key다(select1st).
+ * 덕분에 find(key) 같은 조회에서 key만으로 비교할 수 있고, value_type 임시객체를 만들 필요가 없다.
+ */
+
+namespace ft {
+
+template <typename T>
+struct identity {
+	const T&	operator()(const T& x) const { return x; }
+};
+
+template <typename Pair>
+struct select1st {
+	const typename Pair::first_type&	operator()(const Pair& x) const { return x.first; }
+};
+
+
+}
+#endif
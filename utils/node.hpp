@@ -1,6 +1,8 @@
 #ifndef NODE_HPP
 # define NODE_HPP
 
+# include <cstddef> // size_t
+
 namespace ft {
 
 enum RB_Color {
@@ -8,22 +10,33 @@ enum RB_Color {
 	BLACK
 };
 
+/* 색은 parent 포인터의 가장 낮은 bit에 넣는다. node는 포인터 크기로 정렬되어 할당되므로 그 bit는 항상 0이다.
+ * bool color를 따로 두면 포인터 3개 뒤에 8 byte가 padding으로 붙으므로, node 하나가 포인터 하나만큼 작아진다.
+ * parent와 color는 접근자로만 읽고 쓴다. */
 template <typename ValueType>
 struct nodeBase {
 	ValueType value;
 	nodeBase* left;
 	nodeBase* right;
-	nodeBase* parent;
-	bool color;
 
-	nodeBase() : value(), left(NULL), right(NULL), parent(NULL) { }
-	nodeBase(const ValueType value, nodeBase* parent = NULL)
-		: value(value), left(NULL), right(NULL), parent(parent), color(RED) { }
-	~nodeBase() { left = right = parent = NULL; }
-	nodeBase(const nodeBase& other) : value(other.value), left(other.left), right(other.right), parent(other.parent), color(other.color) { }
+	private:
+	size_t	_parent_color;
+
+	public:
+	// sentinel(end)
+	nodeBase() : value(), left(NULL), right(NULL), _parent_color(BLACK) { }
+	// value는 node 안에 바로 복사 생성된다.
+	explicit nodeBase(const ValueType& value, nodeBase* parent = NULL)
+		: value(value), left(NULL), right(NULL), _parent_color(reinterpret_cast<size_t>(parent) | RED) { }
+	~nodeBase() { left = right = NULL; _parent_color = 0; }
+
+	nodeBase*	parent() const		{ return reinterpret_cast<nodeBase*>(_parent_color & ~static_cast<size_t>(1)); }
+	void		set_parent(nodeBase* p)	{ _parent_color = reinterpret_cast<size_t>(p) | (_parent_color & 1); }
+	bool		color() const		{ return _parent_color & 1; }
+	void		set_color(bool c)	{ _parent_color = (_parent_color & ~static_cast<size_t>(1)) | c; }
 
 	nodeBase* next() {
-		if (this->parent == NULL)
+		if (this->parent() == NULL)
 			return max(this->right);
 		nodeBase* next;
 		if (this->right)
@@ -35,17 +48,17 @@ struct nodeBase {
 		else
 		{
 			next = this;
-			while (next->parent && next->parent->right == next)
-				next = next->parent;
-			if (next->parent)
-				next = next->parent;
+			while (next->parent() && next->parent()->right == next)
+				next = next->parent();
+			if (next->parent())
+				next = next->parent();
 		}
 		return next;
 	}
 
 	nodeBase* prev() {
-		if (this->parent == NULL)
-			return max(this->right);
+		if (this->parent() == NULL)		// sentinel(end)의 left는 가장 큰 node를 가리킨다.
+			return this->left;
 		nodeBase* prev;
 		if (this->left)
 		{
@@ -56,9 +69,9 @@ struct nodeBase {
 		else
 		{
 			prev = this;
-			while (prev->parent && prev->parent->left == prev)
-				prev = prev->parent;
-			prev =prev->parent;
+			while (prev->parent() && prev->parent()->left == prev)
+				prev = prev->parent();
+			prev = prev->parent();
 		}
 		return prev;
 	}
@@ -70,7 +83,8 @@ struct nodeBase {
 	}
 
 	private:
-	nodeBase& operator=(const nodeBase& rhs) { (void)rhs; }
+	nodeBase(const nodeBase& other);
+	nodeBase& operator=(const nodeBase& rhs);
 };
 
 
@@ -0,0 +1,451 @@
+#ifndef PERSISTENT_TREE_HPP
+# define PERSISTENT_TREE_HPP
+
+# include <cstddef> // size_t, ptrdiff_t
+# include <algorithm> // swap
+# include <new> // placement new
+# include <iterator> // bidirectional_iterator_tag
+# include <memory> // allocator
+# include "pair.hpp"
+
+/* persistent_map 이 쓰는 path-copying AVL tree.
+ *
+ * node는 parent 포인터 없이 자식만 가리키고, 참조 횟수(refs)를 갖는다. 여러 tree(snapshot)가 같은 서브트리를 공유할 수 있고,
+ * 참조하는 부모 node나 tree가 하나도 없어지면 해제된다. 그래서 tree를 복사(snapshot)하는 것은 root의 refs 하나만 올리는 O(1)이다.
+ *
+ * 삽입, 삭제는 root부터 바뀌는 node까지의 경로(O(log n)개)만 새로 만들고 나머지는 그대로 공유한다.
+ * 경로의 node가 이 tree만의 것(refs == 1)이면 복사하지 않고 제자리에서 고친다. snapshot이 없을 때는 보통의 AVL tree와 같다.
+ * RB tree의 회전은 부모를 따라 올라가면서 고치므로 parent 없이 경로를 복사하는 데는 재귀로 내려갔다 올라오며 고치는 AVL이 맞다.
+ *
+ * refs는 atomic 연산으로 바꾸므로, 서로 다른 tree 객체(같은 node를 공유하는 snapshot들)는 서로 다른 thread에서 읽고, 고치고, 소멸시켜도 된다.
+ * 하나의 tree 객체를 여러 thread가 동시에 쓰는 것은 보통의 container처럼 안 된다. node를 여러 thread에서 해제하므로 allocator는 thread-safe 해야 한다.
+ */
+
+namespace ft {
+
+template <typename ValueType>
+struct persistentNode {
+	ValueType		value;
+	persistentNode*	left;
+	persistentNode*	right;
+	int				height;
+	size_t			refs;
+
+	persistentNode(const ValueType& value) : value(value), left(NULL), right(NULL), height(1), refs(1) { }
+
+	private:
+	persistentNode(const persistentNode& other);
+	persistentNode& operator=(const persistentNode& rhs);
+};
+
+
+/* node에 parent가 없으므로 root부터 현재 node까지의 경로를 들고 다닌다.
+ * AVL tree의 높이는 1.44 log2(n)보다 작으므로 주소 공간에 들어가는 어떤 크기의 tree도 max_depth 안에 들어간다. */
+template <typename T>
+class persistent_iterator {
+	public:
+		typedef T									value_type;
+		typedef const T*							pointer;
+		typedef const T&							reference;
+		typedef ptrdiff_t							difference_type;
+		typedef std::bidirectional_iterator_tag		iterator_category;
+		typedef persistentNode<T>					node;
+
+		static const int	max_depth = 64;
+
+	private:
+		const node*	_root;
+		const node*	_path[max_depth];
+		int			_depth;		// 0이면 end()
+
+		void	_push_min(const node* n) {
+			for (; n; n = n->left)
+				_path[_depth++] = n;
+		}
+		void	_push_max(const node* n) {
+			for (; n; n = n->right)
+				_path[_depth++] = n;
+		}
+
+	public:
+		persistent_iterator() : _root(NULL), _depth(0) { }
+		persistent_iterator(const node* root) : _root(root), _depth(0) { }
+		persistent_iterator(const persistent_iterator& other) : _root(other._root), _depth(other._depth) {
+			for (int i = 0; i < _depth; i++)
+				_path[i] = other._path[i];
+		}
+		persistent_iterator& operator=(const persistent_iterator& rhs) {
+			_root = rhs._root;
+			_depth = rhs._depth;
+			for (int i = 0; i < _depth; i++)
+				_path[i] = rhs._path[i];
+			return *this;
+		}
+		~persistent_iterator() { }
+
+		/* tree가 만드는 iterator. root에서 시작해 경로를 쌓는다. */
+		static persistent_iterator	first(const node* root) {
+			persistent_iterator it(root);
+			it._push_min(root);
+			return it;
+		}
+		void	push(const node* n)	{ _path[_depth++] = n; }
+		void	pop()				{ --_depth; }
+		const node*	get() const		{ return _depth ? _path[_depth - 1] : NULL; }
+
+		reference operator*() const { return _path[_depth - 1]->value; }
+		pointer operator->() const { return &(_path[_depth - 1]->value); }
+
+		persistent_iterator& operator++() {
+			const node* cur = _path[_depth - 1];
+			if (cur->right) {
+				_push_min(cur->right);
+				return *this;
+			}
+			// 왼쪽 자식에서 올라온 부모가 다음 원소. 없으면 end()
+			for (--_depth; _depth > 0 && _path[_depth - 1]->right == cur; --_depth)
+				cur = _path[_depth - 1];
+			return *this;
+		}
+
+		persistent_iterator operator++(int) {
+			persistent_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		persistent_iterator& operator--() {
+			if (_depth == 0) {
+				_push_max(_root);
+				return *this;
+			}
+			const node* cur = _path[_depth - 1];
+			if (cur->left) {
+				_push_max(cur->left);
+				return *this;
+			}
+			for (--_depth; _depth > 0 && _path[_depth - 1]->left == cur; --_depth)
+				cur = _path[_depth - 1];
+			return *this;
+		}
+
+		persistent_iterator operator--(int) {
+			persistent_iterator tmp(*this);
+			--*this;
+			return tmp;
+		}
+
+		bool operator==(const persistent_iterator& rhs) const { return get() == rhs.get(); }
+		bool operator!=(const persistent_iterator& rhs) const { return get() != rhs.get(); }
+};
+
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Compare, typename Alloc = std::allocator<ValueType> >
+class PersistentTree {
+	public:
+		typedef persistentNode<ValueType>				node;
+		typedef persistent_iterator<ValueType>			iterator;
+		typedef typename Alloc::template rebind<node>::other	NodeAlloc;
+
+	private:
+		node*		_root;
+		size_t		_size;
+		Compare		_comp;
+		NodeAlloc	_alloc;
+
+		const Key&	_key(const node* n) const { return KeyOfValue()(n->value); }
+
+		node*	_create(const ValueType& value) {
+			node* n = _alloc.allocate(1);
+			try {
+				::new (static_cast<void*>(n)) node(value);
+			} catch (...) {
+				_alloc.deallocate(n, 1);
+				throw;
+			}
+			return n;
+		}
+
+		static node*	_retain(node* n) {
+			if (n)
+				__atomic_add_fetch(&n->refs, 1, __ATOMIC_RELAXED);
+			return n;
+		}
+
+		/* 참조 하나를 놓는다. 마지막 참조였으면 node를 해제하고 자식의 참조도 놓는다. */
+		void	_release(node* n) {
+			while (n && __atomic_sub_fetch(&n->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+				node* l = n->left;
+				node* r = n->right;
+				n->~node();
+				_alloc.deallocate(n, 1);
+				_release(l);
+				n = r;			// 오른쪽은 반복으로 (재귀 깊이는 높이 이하)
+			}
+		}
+
+		/* n의 참조 하나를 넘겨받아서, 이 tree만 참조하는(고쳐도 되는) node를 돌려준다.
+		 * 다른 tree와 공유하고 있으면 복사본을 만든다. 복사본은 n의 자식을 공유한다. */
+		node*	_own(node* n) {
+			if (__atomic_load_n(&n->refs, __ATOMIC_ACQUIRE) == 1)
+				return n;
+			node* c = _create(n->value);
+			c->left = _retain(n->left);
+			c->right = _retain(n->right);
+			c->height = n->height;
+			_release(n);
+			return c;
+		}
+
+		static int	_height(const node* n) { return n ? n->height : 0; }
+		static void	_fix_height(node* n) {
+			int l = _height(n->left);
+			int r = _height(n->right);
+			n->height = 1 + (l > r ? l : r);
+		}
+
+		/* 회전하는 n은 이미 이 tree만의 것이어야 한다. 위로 올라오는 자식은 여기서 _own 한다. */
+		node*	_rotate_right(node* n) {
+			node* l = _own(n->left);
+			n->left = l->right;
+			l->right = n;
+			_fix_height(n);
+			_fix_height(l);
+			return l;
+		}
+
+		node*	_rotate_left(node* n) {
+			node* r = _own(n->right);
+			n->right = r->left;
+			r->left = n;
+			_fix_height(n);
+			_fix_height(r);
+			return r;
+		}
+
+		node*	_balance(node* n) {
+			int diff = _height(n->left) - _height(n->right);
+			if (diff > 1) {
+				if (_height(n->left->left) < _height(n->left->right))
+					n->left = _rotate_left(_own(n->left));
+				return _rotate_right(n);
+			}
+			if (diff < -1) {
+				if (_height(n->right->right) < _height(n->right->left))
+					n->right = _rotate_right(_own(n->right));
+				return _rotate_left(n);
+			}
+			_fix_height(n);
+			return n;
+		}
+
+		/* n의 참조를 넘겨받아, value를 넣은 서브트리를 돌려준다. key가 이미 있으면 그 node의 value를 바꾼다.
+		 * (key가 있는데 바꾸지 않는 경우는 호출하기 전에 걸러낸다. 경로를 쓸데없이 복사하지 않도록) */
+		node*	_insert(node* n, const ValueType& value) {
+			if (n == NULL) {
+				++_size;
+				return _create(value);
+			}
+			n = _own(n);
+			const Key& k = KeyOfValue()(value);
+			// 자식의 높이가 그대로면 n의 균형도 그대로다. 형제 node를 읽지 않고 바로 올라간다.
+			if (_comp(k, _key(n))) {
+				int before = _height(n->left);
+				n->left = _insert(n->left, value);
+				if (n->left->height == before)
+					return n;
+			} else if (_comp(_key(n), k)) {
+				int before = _height(n->right);
+				n->right = _insert(n->right, value);
+				if (n->right->height == before)
+					return n;
+			} else {
+				// value의 key는 const라 대입할 수 없으므로 node를 바꿔 끼운다.
+				node* c = _create(value);
+				c->left = n->left;
+				c->right = n->right;
+				c->height = n->height;
+				n->left = n->right = NULL;
+				_release(n);
+				return c;
+			}
+			return _balance(n);
+		}
+
+		/* n의 가장 작은 node를 떼어내서 min으로 돌려준다. min은 이 tree만의 것이고 자식이 없다. */
+		node*	_erase_min(node* n, node*& min) {
+			n = _own(n);
+			if (n->left == NULL) {
+				node* r = n->right;
+				n->right = NULL;
+				min = n;
+				return r;
+			}
+			n->left = _erase_min(n->left, min);
+			return _balance(n);
+		}
+
+		/* k가 n 안에 있을 때만 부른다. */
+		node*	_erase(node* n, const Key& k) {
+			n = _own(n);
+			if (_comp(k, _key(n))) {
+				int before = n->left->height;
+				n->left = _erase(n->left, k);
+				if (_height(n->left) == before)
+					return n;
+			} else if (_comp(_key(n), k)) {
+				int before = n->right->height;
+				n->right = _erase(n->right, k);
+				if (_height(n->right) == before)
+					return n;
+			} else {
+				node* l = n->left;
+				node* r = n->right;
+				n->left = n->right = NULL;
+				_release(n);
+				--_size;
+				if (l == NULL || r == NULL)
+					return l ? l : r;
+				node* min;
+				r = _erase_min(r, min);
+				min->left = l;
+				min->right = r;
+				n = min;
+			}
+			return _balance(n);
+		}
+
+		const node*	_find(const Key& k) const {
+			const node* n = _root;
+			while (n) {
+				if (_comp(k, _key(n)))
+					n = n->left;
+				else if (_comp(_key(n), k))
+					n = n->right;
+				else
+					return n;
+			}
+			return NULL;
+		}
+
+	public:
+		PersistentTree(const Compare& comp = Compare(), const Alloc& alloc = Alloc())
+			: _root(NULL), _size(0), _comp(comp), _alloc(alloc) { }
+
+		// O(1). node는 둘 중 한쪽이 고칠 때 필요한 경로만 복사된다.
+		PersistentTree(const PersistentTree& other)
+			: _root(_retain(other._root)), _size(other._size), _comp(other._comp), _alloc(other._alloc) { }
+
+		PersistentTree& operator=(const PersistentTree& rhs) {
+			node* old = _root;
+			_root = _retain(rhs._root);
+			_size = rhs._size;
+			_comp = rhs._comp;
+			_release(old);
+			return *this;
+		}
+
+		~PersistentTree() { _release(_root); }
+
+		size_t		getSize() const { return _size; }
+
+		iterator	begin() const	{ return iterator::first(_root); }
+		iterator	end() const		{ return iterator(_root); }
+
+		/* key가 없으면 value를 넣고 true. 있으면 assign일 때만 value로 바꾸고 false.
+		 * assign이면 어느 쪽이든 경로가 바뀌므로 미리 찾아보지 않고 한 번만 내려간다. */
+		bool	insert(const ValueType& value, bool assign) {
+			size_t before = _size;
+			if (assign) {
+				_root = _insert(_root, value);
+				return _size != before;
+			}
+			if (_find(KeyOfValue()(value)) != NULL)
+				return false;
+			_root = _insert(_root, value);
+			return true;
+		}
+
+		size_t	erase(const Key& k) {
+			if (_find(k) == NULL)
+				return 0;
+			_root = _erase(_root, k);
+			return 1;
+		}
+
+		void	clear() {
+			_release(_root);
+			_root = NULL;
+			_size = 0;
+		}
+
+		void	swap(PersistentTree& other) {
+			std::swap(_root, other._root);
+			std::swap(_size, other._size);
+			std::swap(_comp, other._comp);
+			std::swap(_alloc, other._alloc);
+		}
+
+		/* 경로를 쌓으면서 내려간다. 찾는 node가 없으면 end() */
+		iterator	find(const Key& k) const {
+			iterator it(_root);
+			const node* n = _root;
+			while (n) {
+				it.push(n);
+				if (_comp(k, _key(n)))
+					n = n->left;
+				else if (_comp(_key(n), k))
+					n = n->right;
+				else
+					return it;
+			}
+			return end();
+		}
+
+		bool	contains(const Key& k) const { return _find(k) != NULL; }
+
+		/* 내려간 경로에서 k 이상인(upper면 k 초과인) 마지막 node까지 경로를 되돌린다. */
+		iterator	bound(const Key& k, bool upper) const {
+			iterator it(_root);
+			int depth = 0;
+			int found = 0;
+			for (const node* n = _root; n; ) {
+				it.push(n);
+				++depth;
+				bool go_left = upper ? _comp(k, _key(n)) : !_comp(_key(n), k);
+				if (go_left) {
+					found = depth;
+					n = n->left;
+				} else
+					n = n->right;
+			}
+			while (depth-- > found)
+				it.pop();
+			return it;
+		}
+
+		/* 높이 차가 1 이하인지, 저장된 높이가 맞는지, key 순서가 맞는지. (테스트용) */
+		bool	isBalanced() const {
+			int h;
+			return _check(_root, NULL, NULL, h);
+		}
+
+	private:
+		bool	_check(const node* n, const node* lo, const node* hi, int& h) const {
+			if (n == NULL) {
+				h = 0;
+				return true;
+			}
+			if ((lo && !_comp(_key(lo), _key(n))) || (hi && !_comp(_key(n), _key(hi))))
+				return false;
+			int lh, rh;
+			if (!_check(n->left, lo, n, lh) || !_check(n->right, n, hi, rh))
+				return false;
+			h = 1 + (lh > rh ? lh : rh);
+			return (lh - rh <= 1 && rh - lh <= 1 && h == n->height);
+		}
+};
+
+
+}
+#endif
@@ -0,0 +1,215 @@
+#ifndef POOL_ALLOCATOR_HPP
+# define POOL_ALLOCATOR_HPP
+
+# include <cstddef> // size_t, ptrdiff_t
+# include <new> // operator new, bad_alloc
+# include <limits> // numeric_limits
+
+/* pool_allocator<T, ChunksPerSlab>
+ * map, set의 node처럼 같은 크기의 객체를 하나씩 자주 할당/해제하는 경우를 위한 allocator.
+ *   ft::set<int, std::less<int>, ft::pool_allocator<int> > s;
+ *
+ * - ChunksPerSlab 개의 chunk를 담는 slab을 한 번에 할당하고, 그 안에서 앞에서부터 차례로 잘라준다.
+ *   (연속으로 삽입한 node들이 메모리상에서도 붙어있게 되어 in-order 순회가 빨라진다)
+ * - 해제된 chunk는 chunk 자체를 next 포인터로 쓰는 intrusive free list에 넣었다가 재사용한다.
+ * - release()는 모든 chunk를 한 번에 반환한다. slab은 다음 할당을 위해 남겨두고, 마지막 사본이 소멸할 때 해제된다.
+ * - 복사본은 같은 pool을 공유한다. (한 사본이 할당한 메모리를 다른 사본이 해제할 수 있어야 하므로)
+ *   rebind로 다른 타입이 되면 chunk 크기가 달라지므로 새 pool을 만든다.
+ * - n != 1 인 할당은 pool을 거치지 않고 operator new로 처리한다.
+ */
+
+namespace ft {
+
+template <typename T>
+struct alignment_of_helper {
+	char	c;
+	T		t;
+};
+
+template <typename T, size_t ChunksPerSlab = 1024>
+class pool_allocator {
+	public:
+		typedef T				value_type;
+		typedef T*				pointer;
+		typedef const T*		const_pointer;
+		typedef T&				reference;
+		typedef const T&		const_reference;
+		typedef size_t			size_type;
+		typedef ptrdiff_t		difference_type;
+
+		template <typename U>
+		struct rebind {
+			typedef pool_allocator<U, ChunksPerSlab>	other;
+		};
+
+	private:
+		template <typename U, size_t N> friend class pool_allocator;
+
+		struct chunk {
+			chunk*	next;
+		};
+
+		struct slab {
+			slab*	next;
+		};
+
+		struct pool {
+			size_t	refcount;
+			chunk*	free_list;
+			slab*	slabs;		// 할당받은 slab 전체 (먼저 받은 것이 앞)
+			slab*	current;	// 지금 잘라주고 있는 slab
+			char*	cursor;		// current 안에서 다음에 잘라줄 위치
+			char*	limit;
+		};
+
+		static const size_t	_align = sizeof(alignment_of_helper<T>) - sizeof(T);
+		static const size_t	_raw_size = (sizeof(T) > sizeof(chunk)) ? sizeof(T) : sizeof(chunk);
+		static const size_t	_chunk_size = (_raw_size + _align - 1) / _align * _align;
+		static const size_t	_header_size = (sizeof(slab) + _align - 1) / _align * _align;
+
+		pool*	_pool;
+
+		static pool*	_new_pool() {
+			pool* p = static_cast<pool*>(::operator new(sizeof(pool)));
+			p->refcount = 1;
+			p->free_list = NULL;
+			p->slabs = p->current = NULL;
+			p->cursor = p->limit = NULL;
+			return p;
+		}
+
+		static void		_unref(pool* p) {
+			if (--p->refcount)
+				return;
+			slab* s = p->slabs;
+			while (s) {
+				slab* next = s->next;
+				::operator delete(s);
+				s = next;
+			}
+			::operator delete(p);
+		}
+
+		void	_set_cursor(slab* s) {
+			_pool->current = s;
+			_pool->cursor = reinterpret_cast<char*>(s) + _header_size;
+			_pool->limit = _pool->cursor + _chunk_size * ChunksPerSlab;
+		}
+
+		// 남은 slab이 있으면 그걸 쓰고, 없으면 새로 할당해서 목록 끝에 붙인다.
+		void	_next_slab() {
+			slab* s = (_pool->current) ? _pool->current->next : _pool->slabs;
+			if (s == NULL) {
+				s = static_cast<slab*>(::operator new(_header_size + _chunk_size * ChunksPerSlab));
+				s->next = NULL;
+				if (_pool->current)
+					_pool->current->next = s;
+				else
+					_pool->slabs = s;
+			}
+			_set_cursor(s);
+		}
+
+	public:
+		pool_allocator() : _pool(_new_pool()) { }
+
+		pool_allocator(const pool_allocator& other) : _pool(other._pool) {
+			_pool->refcount++;
+		}
+
+		template <typename U>
+		pool_allocator(const pool_allocator<U, ChunksPerSlab>&) : _pool(_new_pool()) { }
+
+		pool_allocator& operator=(const pool_allocator& rhs) {
+			pool_allocator tmp(rhs);
+			pool* p = _pool;
+			_pool = tmp._pool;
+			tmp._pool = p;
+			return *this;
+		}
+
+		~pool_allocator() {
+			_unref(_pool);
+		}
+
+		pointer			address(reference x) const				{ return &x; }
+		const_pointer	address(const_reference x) const		{ return &x; }
+
+		size_type		max_size() const {
+			return std::numeric_limits<size_type>::max() / sizeof(T);
+		}
+
+		pointer			allocate(size_type n, const void* hint = 0) {
+			(void)hint;
+			if (n != 1)
+				return static_cast<pointer>(::operator new(n * sizeof(T)));
+			if (_pool->free_list) {
+				chunk* c = _pool->free_list;
+				_pool->free_list = c->next;
+				return reinterpret_cast<pointer>(c);
+			}
+			if (_pool->cursor == _pool->limit)
+				_next_slab();
+			pointer p = reinterpret_cast<pointer>(_pool->cursor);
+			_pool->cursor += _chunk_size;
+			return p;
+		}
+
+		void			deallocate(pointer p, size_type n) {
+			if (n != 1) {
+				::operator delete(p);
+				return;
+			}
+			chunk* c = reinterpret_cast<chunk*>(p);
+			c->next = _pool->free_list;
+			_pool->free_list = c;
+		}
+
+		void			construct(pointer p, const_reference val)	{ new (static_cast<void*>(p)) T(val); }
+		void			destroy(pointer p)							{ p->~T(); }
+
+		/* pool에서 할당한 모든 chunk를 소멸자 호출 없이 한꺼번에 반환한다. slab 수와 무관하게 O(1).
+		 * 다른 사본과 pool을 공유하고 있다면 그 사본의 chunk까지 사라지므로 아무것도 하지 않고 false를 반환한다. */
+		bool			release() {
+			if (_pool->refcount != 1)
+				return false;
+			_pool->free_list = NULL;
+			_pool->current = NULL;
+			_pool->cursor = _pool->limit = NULL;
+			return true;
+		}
+
+		bool	operator==(const pool_allocator& rhs) const { return _pool == rhs._pool; }
+		bool	operator!=(const pool_allocator& rhs) const { return _pool != rhs._pool; }
+};
+
+
+/* allocator_release<Alloc>::release(alloc)
+ * 컨테이너가 원소를 하나씩 해제하는 대신 allocator에 한꺼번에 반환을 요청할 때 쓴다.
+ * 지원하지 않는 allocator는 false를 반환하고, 컨테이너는 원래대로 하나씩 해제한다. */
+template <typename Alloc>
+struct allocator_release {
+	static bool release(Alloc&) { return false; }
+};
+
+template <typename T, size_t ChunksPerSlab>
+struct allocator_release< pool_allocator<T, ChunksPerSlab> > {
+	static bool release(pool_allocator<T, ChunksPerSlab>& alloc) { return alloc.release(); }
+};
+
+/* allocator_thread_safe<Alloc>::value
+ * 여러 thread가 같은 allocator의 사본으로 동시에 할당, 해제해도 되는가. 병렬 set 연산이 확인한다.
+ * pool_allocator는 사본끼리 pool을 공유하고 잠그지 않으므로 false. */
+template <typename Alloc>
+struct allocator_thread_safe {
+	static const bool value = true;
+};
+
+template <typename T, size_t ChunksPerSlab>
+struct allocator_thread_safe< pool_allocator<T, ChunksPerSlab> > {
+	static const bool value = false;
+};
+
+
+}
+#endif
@@ -37,7 +37,11 @@ class reverse_iterator {
 		~reverse_iterator() {}
 
 		iterator_type		base() const { return _base_iterator; }
-		reference			operator*() const { return *(_base_iterator - 1); }
+		// bidirectional iterator(map, set)는 operator- 가 없으므로 사본을 감소시켜서 참조한다.
+		reference			operator*() const {
+			iterator_type tmp = _base_iterator;
+			return *(--tmp);
+		}
 		pointer				operator->() const { return &(operator*()); }
 		reference			operator[](difference_type n) const { return base()[-n-1]; }
 		
@@ -0,0 +1,480 @@
+#ifndef SKIPLIST_HPP
+# define SKIPLIST_HPP
+
+# include <cstddef> // size_t, ptrdiff_t
+# include <iterator> // bidirectional_iterator_tag
+# include <memory> // allocator
+# include <new> // placement new
+# include "pair.hpp"
+# include "epoch.hpp"
+# include "compact_tree.hpp" // compact_storage
+
+/* skiplist_map 이 쓰는 lock-free skip list. (Herlihy & Shavit, The Art of Multiprocessor Programming 14.4)
+ *
+ * node마다 level개의 next 포인터(tower)를 갖고, level 0의 목록이 모든 원소를 key 순서로 잇는다.
+ * 위 level로 갈수록 node가 1/4씩 줄어서 위에서부터 내려가며 찾으면 O(log n)이다.
+ *
+ *   - 모든 연결은 CAS로 바꾼다. 삭제할 node는 먼저 next 포인터의 최하위 bit를 세워(mark) 논리적으로 지우고,
+ *     그 다음에 찾기(_find)가 지나가면서 mark 된 node를 앞 node의 next에서 CAS로 떼어낸다.
+ *     level 0에 mark를 성공시킨 thread가 삭제한 것이다.
+ *   - 조회(lower_bound, find, iterator)는 mark 된 node를 건너뛰기만 하고 고치지 않는다. (wait-free)
+ *   - 떼어낸 node는 epoch_domain으로 넘겨서, 그 node를 보고 있을 수 있는 guard가 모두 나간 뒤 해제한다.
+ *     삽입하던 thread가 아직 위 level을 잇는 중에 삭제될 수도 있으므로, 삽입한 쪽과 삭제한 쪽이 모두 끝나야(refs 2 -> 0) retire한다.
+ *
+ * 원소는 연결된 뒤 바뀌지 않는다. (다른 thread가 lock 없이 읽고 있으므로)
+ * node는 tower 크기만큼 Alloc을 char로 rebind해서 할당한다. allocator는 thread-safe 하고, 어떤 타입에도 맞는 정렬로 돌려줘야 한다. (std::allocator)
+ */
+
+namespace ft {
+
+/* 원소는 storage에 직접 생성, 소멸한다. head는 원소 없이 tower만 쓰는 node다. */
+template <typename ValueType>
+struct skipNode : public epoch_entry {
+	compact_storage<ValueType>	storage;
+	int							level;
+	int							refs;
+	skipNode*					next[1];		// 실제로는 level 개
+
+	static size_t	bytes(int level) { return sizeof(skipNode) + (level - 1) * sizeof(skipNode*); }
+
+	skipNode(const ValueType& value, int level) : epoch_entry(), level(level), refs(2) {
+		::new (static_cast<void*>(storage.raw)) ValueType(value);
+		for (int i = 0; i < level; i++)
+			next[i] = NULL;
+	}
+	// head
+	explicit skipNode(int level) : epoch_entry(), level(level), refs(0) {
+		for (int i = 0; i < level; i++)
+			next[i] = NULL;
+	}
+
+	ValueType&			value()			{ return *reinterpret_cast<ValueType*>(storage.raw); }
+	const ValueType&	value() const	{ return *reinterpret_cast<const ValueType*>(storage.raw); }
+
+	static bool			marked(skipNode* p)	{ return reinterpret_cast<size_t>(p) & 1; }
+	static skipNode*	mark(skipNode* p)	{ return reinterpret_cast<skipNode*>(reinterpret_cast<size_t>(p) | 1); }
+	static skipNode*	unmark(skipNode* p)	{ return reinterpret_cast<skipNode*>(reinterpret_cast<size_t>(p) & ~(size_t)1); }
+
+	skipNode*	load(int l) const { return __atomic_load_n(&next[l], __ATOMIC_ACQUIRE); }
+	bool		cas(int l, skipNode* expected, skipNode* desired) {
+		return __atomic_compare_exchange_n(&next[l], &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+	}
+
+	private:
+	skipNode(const skipNode& other);
+	skipNode& operator=(const skipNode& rhs);
+};
+
+
+/* thread마다 따로 도는 xorshift. tower 높이를 정한다. */
+inline unsigned	skiplist_random() {
+	static __thread unsigned x = 0;
+	if (x == 0) {
+		int local;
+		x = static_cast<unsigned>(ft::hash_mix(reinterpret_cast<size_t>(&local)) >> 32) | 1;
+	}
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return x;
+}
+
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Compare, typename Alloc>
+class LockFreeSkipList;
+
+/* 원소를 읽기만 하는 iterator. 살아있는 동안 epoch guard를 잡고 있으므로, 가리키는 원소가 다른 thread에서 지워져도 읽을 수 있고
+ * ++로 계속 나아갈 수 있다. (지워진 원소는 건너뛴다) 대신 iterator가 살아있는 동안 지워진 node는 해제되지 않는다.
+ * --는 앞 node를 가리키는 포인터가 없으므로 key로 다시 찾는다. O(log n) */
+template <typename ValueType, typename List>
+class skiplist_iterator {
+	public:
+		typedef ValueType							value_type;
+		typedef const ValueType*					pointer;
+		typedef const ValueType&					reference;
+		typedef ptrdiff_t							difference_type;
+		typedef std::bidirectional_iterator_tag		iterator_category;
+		typedef skipNode<ValueType>					node;
+
+	private:
+		const List*					_list;
+		node*						_node;		// NULL이면 end()
+		epoch_domain::guard			_guard;
+
+	public:
+		skiplist_iterator() : _list(NULL), _node(NULL), _guard() { }
+		skiplist_iterator(const List* list, node* n) : _list(list), _node(n), _guard(list->domain()) { }
+		// end()는 가리키는 node가 없으므로 guard 없이 만든다. --로 node를 가리키게 될 때 들어간다.
+		explicit skiplist_iterator(const List* list) : _list(list), _node(NULL), _guard() { }
+		skiplist_iterator(const skiplist_iterator& other) : _list(other._list), _node(other._node), _guard(other._guard) { }
+		skiplist_iterator& operator=(const skiplist_iterator& rhs) {
+			_guard = rhs._guard;
+			_list = rhs._list;
+			_node = rhs._node;
+			return *this;
+		}
+		~skiplist_iterator() { }
+
+		node*	get() const { return _node; }
+		void	set(node* n) { _node = n; }
+
+		reference operator*() const { return _node->value(); }
+		pointer operator->() const { return &(_node->value()); }
+
+		skiplist_iterator& operator++() {
+			_node = _list->next_live(_node);
+			return *this;
+		}
+
+		skiplist_iterator operator++(int) {
+			skiplist_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		skiplist_iterator& operator--() {
+			if (_node == NULL) {
+				_guard = epoch_domain::guard(_list->domain());
+				_node = _list->last();
+			}
+			else
+				_node = _list->before(_list->key_of(_node));
+			return *this;
+		}
+
+		skiplist_iterator operator--(int) {
+			skiplist_iterator tmp(*this);
+			--*this;
+			return tmp;
+		}
+
+		bool operator==(const skiplist_iterator& rhs) const { return _node == rhs._node; }
+		bool operator!=(const skiplist_iterator& rhs) const { return _node != rhs._node; }
+};
+
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Compare, typename Alloc>
+class LockFreeSkipList {
+	public:
+		typedef Key												key_type;
+		typedef skipNode<ValueType>								node;
+		typedef skiplist_iterator<ValueType, LockFreeSkipList>	iterator;
+		typedef typename Alloc::template rebind<char>::other	ByteAlloc;
+
+		static const int	max_level = 16;		// 4^16 개까지 O(log n)
+
+	private:
+		node*					_head;			// 원소가 없는 시작 node. max_level 칸의 tower
+		int						_levels;		// 지금까지 쓰인 가장 높은 tower. 늘어나기만 한다
+		size_t					_size;
+		Compare					_comp;
+		ByteAlloc				_alloc;
+		mutable epoch_domain	_domain;
+
+		LockFreeSkipList(const LockFreeSkipList&);
+		LockFreeSkipList& operator=(const LockFreeSkipList&);
+
+		static void	_reclaim(epoch_entry* e, void* ctx) {
+			static_cast<LockFreeSkipList*>(ctx)->_destroy(static_cast<node*>(e));
+		}
+
+		node*	_create(const ValueType& value, int level) {
+			char* p = _alloc.allocate(node::bytes(level));
+			try {
+				return ::new (static_cast<void*>(p)) node(value, level);
+			} catch (...) {
+				_alloc.deallocate(p, node::bytes(level));
+				throw;
+			}
+		}
+
+		void	_destroy(node* n) {
+			size_t bytes = node::bytes(n->level);
+			n->value().~ValueType();
+			n->~node();
+			_alloc.deallocate(reinterpret_cast<char*>(n), bytes);
+		}
+
+		node*	_create_head() {
+			return ::new (static_cast<void*>(_alloc.allocate(node::bytes(max_level)))) node(max_level);
+		}
+
+		int		_random_level() const {
+			unsigned r = skiplist_random();
+			int level = 1;
+			while ((r & 3) == 0 && level < max_level) {		// 1/4 확률로 한 칸씩
+				r >>= 2;
+				level++;
+			}
+			return level;
+		}
+
+		int		_top() const { return __atomic_load_n(&_levels, __ATOMIC_ACQUIRE); }
+
+		/* 내려가면서 level마다 key보다 작은 마지막 node(preds)와 그 다음(succs)을 채운다.
+		 * 지나가는 길의 mark된 node는 떼어낸다. level 0의 succ가 key이면 true.
+		 * levels 보다 높은 level은 건드리지 않는다. */
+		bool	_find(const Key& key, node** preds, node** succs, int levels) {
+		retry:
+			node* pred = _head;
+			node* curr = NULL;
+			for (int l = levels - 1; l >= 0; l--) {
+				curr = node::unmark(pred->load(l));
+				while (curr) {
+					node* succ = curr->load(l);
+					while (node::marked(succ)) {
+						if (!pred->cas(l, curr, node::unmark(succ)))
+							goto retry;			// pred가 바뀌었거나 지워지는 중
+						curr = node::unmark(succ);
+						if (curr == NULL)
+							break;
+						succ = curr->load(l);
+					}
+					if (curr && _comp(key_of(curr), key)) {
+						pred = curr;
+						curr = node::unmark(succ);
+					}
+					else
+						break;
+				}
+				preds[l] = pred;
+				succs[l] = curr;
+			}
+			return (curr && !_comp(key, key_of(curr)));
+		}
+
+		/* victim을 위에서부터 mark 하고, level 0의 mark에 성공한 thread가 모든 level에서 떼어낸 뒤 놓는다. */
+		size_t	_erase(node* victim, node** preds, node** succs) {
+			for (int l = victim->level - 1; l >= 1; l--) {
+				node* succ = victim->load(l);
+				while (!node::marked(succ)) {
+					victim->cas(l, succ, node::mark(succ));
+					succ = victim->load(l);
+				}
+			}
+			node* succ = victim->load(0);
+			for (;;) {
+				if (node::marked(succ))
+					return 0;				// 다른 thread가 먼저 지웠다
+				if (victim->cas(0, succ, node::mark(succ)))
+					break;
+				succ = victim->load(0);
+			}
+			__atomic_sub_fetch(&_size, 1, __ATOMIC_RELAXED);
+			// 모든 level에서 떼어낸다. 처음 찾은 뒤 다른 thread가 _levels를 올렸을 수 있으므로 victim의 높이까지 내려간다.
+			int top = _top();
+			_find(key_of(victim), preds, succs, (victim->level > top) ? victim->level : top);
+			_release(victim);
+			return 1;
+		}
+
+		/* 삽입한 쪽, 삭제한 쪽 둘 다 끝나면 retire */
+		void	_release(node* n) {
+			if (__atomic_sub_fetch(&n->refs, 1, __ATOMIC_ACQ_REL) == 0)
+				_domain.retire(n);
+		}
+
+		/* mark되지 않은 첫 node부터. upper면 key보다 큰, 아니면 key 이상인 첫 원소 */
+		node*	_bound(const Key& key, bool upper) const {
+			node* pred = _head;
+			node* curr = NULL;
+			for (int l = _top() - 1; l >= 0; l--) {
+				curr = node::unmark(pred->load(l));
+				while (curr) {
+					node* succ = curr->load(l);
+					if (node::marked(succ)) {
+						curr = node::unmark(succ);
+						continue;
+					}
+					if (upper ? !_comp(key, key_of(curr)) : _comp(key_of(curr), key)) {
+						pred = curr;
+						curr = node::unmark(succ);
+					}
+					else
+						break;
+				}
+			}
+			return curr;
+		}
+
+	public:
+		LockFreeSkipList(const Compare& comp, const Alloc& alloc)
+			: _head(NULL), _levels(1), _size(0), _comp(comp), _alloc(alloc), _domain(&_reclaim, this) {
+				_head = _create_head();
+		}
+
+		// no other thread may be using the list.
+		~LockFreeSkipList() {
+			clear();
+			_head->~node();
+			_alloc.deallocate(reinterpret_cast<char*>(_head), node::bytes(max_level));
+		}
+
+		epoch_domain&	domain() const { return _domain; }
+		const Key&		key_of(const node* n) const { return KeyOfValue()(n->value()); }
+
+		// other threads may change it at any moment.
+		size_t	getSize() const { return __atomic_load_n(&_size, __ATOMIC_RELAXED); }
+
+		// iterator의 guard에 들어간 뒤에 node를 찾는다. (찾은 node가 guard 전에 해제되지 않도록)
+		iterator	begin() const {
+			iterator it(this, NULL);
+			it.set(next_live(_head));
+			return it;
+		}
+		iterator	end() const		{ return iterator(this); }
+
+		/* n 다음의 지워지지 않은 node. (n이 지워졌어도 next는 지울 때의 다음 node를 가리킨다) */
+		node*	next_live(node* n) const {
+			node* curr = node::unmark(n->load(0));
+			while (curr && node::marked(curr->load(0)))
+				curr = node::unmark(curr->load(0));
+			return curr;
+		}
+
+		/* key보다 작은 마지막 원소. 없으면 NULL */
+		node*	before(const Key& key) const {
+			node* pred = _head;
+			for (int l = _top() - 1; l >= 0; l--) {
+				node* curr = node::unmark(pred->load(l));
+				while (curr) {
+					node* succ = curr->load(l);
+					if (!node::marked(succ)) {
+						if (!_comp(key_of(curr), key))
+							break;
+						pred = curr;
+					}
+					curr = node::unmark(succ);
+				}
+			}
+			return (pred == _head) ? NULL : pred;
+		}
+
+		/* 마지막 원소. 비었으면 NULL */
+		node*	last() const {
+			node* pred = _head;
+			for (int l = _top() - 1; l >= 0; l--) {
+				for (node* curr = node::unmark(pred->load(l)); curr; ) {
+					node* succ = curr->load(l);
+					if (!node::marked(succ))
+						pred = curr;
+					curr = node::unmark(succ);
+				}
+			}
+			return (pred == _head) ? NULL : pred;
+		}
+
+		iterator	lower_bound(const Key& key) const {
+			iterator it(this, NULL);
+			it.set(_bound(key, false));
+			return it;
+		}
+		iterator	upper_bound(const Key& key) const {
+			iterator it(this, NULL);
+			it.set(_bound(key, true));
+			return it;
+		}
+
+		iterator	find(const Key& key) const {
+			iterator it = lower_bound(key);
+			if (it.get() && _comp(key, key_of(it.get())))
+				it.set(NULL);
+			return it;
+		}
+
+		bool		contains(const Key& key) const {
+			epoch_domain::guard guard(_domain);
+			node* n = _bound(key, false);
+			return (n && !_comp(key, key_of(n)));
+		}
+
+		/* (새 원소, true) 또는 (이미 있던 같은 key의 원소, false) */
+		ft::pair<iterator, bool>	insert(const ValueType& value) {
+			epoch_domain::guard guard(_domain);
+			const Key& key = KeyOfValue()(value);
+			int level = _random_level();
+			int top = _top();
+			while (top < level && !__atomic_compare_exchange_n(&_levels, &top, level, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+				;
+			if (top < level)
+				top = level;		// 아래의 _find는 모두 n의 높이 이상에서 시작하므로 n을 모든 level에서 떼어낼 수 있다
+			node* preds[max_level];
+			node* succs[max_level];
+			node* n = NULL;
+			for (;;) {
+				if (_find(key, preds, succs, top)) {
+					if (n)
+						_destroy(n);		// 아직 아무도 못 본 node
+					return ft::make_pair(iterator(this, succs[0]), false);
+				}
+				if (n == NULL)
+					n = _create(value, level);
+				for (int l = 0; l < level; l++)
+					n->next[l] = succs[l];
+				if (preds[0]->cas(0, succs[0], n))
+					break;
+			}
+			__atomic_add_fetch(&_size, 1, __ATOMIC_RELAXED);
+			iterator result(this, n);
+			// 위 level들을 잇는다. 그 사이에 삭제되기 시작하면(mark) 멈춘다.
+			bool deleted = false;
+			for (int l = 1; l < level && !deleted; l++) {
+				for (;;) {
+					node* succ = n->load(l);
+					if (node::marked(succ)) {
+						deleted = true;
+						break;
+					}
+					if (succ != succs[l] && !n->cas(l, succ, succs[l])) {
+						deleted = true;			// mark 때문에만 실패한다
+						break;
+					}
+					if (preds[l]->cas(l, succs[l], n))
+						break;
+					_find(key, preds, succs, top);
+				}
+			}
+			// 이으면서 삭제된 경우, 이은 level에서 떼어낸다.
+			if (deleted || node::marked(n->load(level - 1)))
+				_find(key, preds, succs, top);
+			_release(n);
+			return ft::make_pair(result, true);
+		}
+
+		/* 지운 원소 수(0 또는 1). 다른 thread가 같은 원소를 동시에 지우면 한쪽만 1을 돌려받는다. */
+		size_t	erase(const Key& key) {
+			epoch_domain::guard guard(_domain);
+			node* preds[max_level];
+			node* succs[max_level];
+			if (!_find(key, preds, succs, _top()))
+				return 0;
+			return _erase(succs[0], preds, succs);
+		}
+
+		/* victim 그 node를 지운다. (같은 key로 새로 들어온 다른 node는 건드리지 않는다)
+		 * victim은 iterator처럼 guard 안에서 얻은 것이어야 한다. 이미 지워졌으면 0. */
+		size_t	erase_node(node* victim) {
+			epoch_domain::guard guard(_domain);
+			node* preds[max_level];
+			node* succs[max_level];
+			return _erase(victim, preds, succs);
+		}
+
+		/* no other thread may be using the list. */
+		void	clear() {
+			node* n = node::unmark(_head->next[0]);
+			while (n) {
+				node* next = node::unmark(n->next[0]);
+				_destroy(n);
+				n = next;
+			}
+			for (int i = 0; i < max_level; i++)
+				_head->next[i] = NULL;
+			_size = 0;
+			_domain.drain();
+		}
+};
+
+
+}
+#endif
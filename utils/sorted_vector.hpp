@@ -0,0 +1,222 @@
+#ifndef SORTED_VECTOR_HPP
+# define SORTED_VECTOR_HPP
+
+# include <cstddef> // size_t
+# include <algorithm> // stable_sort
+# include "../vector.hpp"
+# include "pair.hpp"
+
+/* flat_map, flat_set 이 쓰는 정렬된 ft::vector.
+ *
+ * 원소를 key 순서로 배열 하나에 붙여 둔다. node마다 있던 포인터 3개와 색이 없으므로 메모리가 원소 크기만큼만 들고,
+ * 찾는 것은 이분 탐색이라 포인터를 따라가지 않는다. 순회도 배열을 차례로 읽는 것이다.
+ * 대신 insert, erase 한 번에 뒤의 원소를 모두 한 칸씩 옮기므로 O(n)이다. (원소가 is_trivially_relocatable이면 memmove 한 번)
+ * 그래서 한꺼번에 넣을 것은 insert_range로 넣는다. 새 원소를 따로 모아 정렬한 뒤 기존 원소와 한 번에 merge한다. O(n + m log m)
+ *
+ * iterator는 vector의 iterator라 insert, erase 뒤에는 그 위치 이후의 iterator가 (재할당되면 모두) 무효화된다.
+ * ft::vector는 원소를 옮길 때 대입 대신 복사 생성을 하므로 pair<const Key, T>를 그대로 담을 수 있다.
+ */
+
+namespace ft {
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Compare, typename Alloc>
+class SortedVector {
+	public:
+		typedef ft::vector<ValueType, Alloc>				container_type;
+		typedef typename container_type::iterator			iterator;
+		typedef typename container_type::const_iterator		const_iterator;
+
+		/* locate()의 결과. found면 index의 원소가 key, 아니면 index가 key를 넣을 자리다. */
+		struct position {
+			size_t	index;
+			bool	found;
+		};
+
+	private:
+		typedef typename Alloc::template rebind<const ValueType*>::other	ptr_allocator;
+
+		container_type	_v;
+		Compare			_comp;
+		KeyOfValue		_kov;
+
+		const Key&	_key(size_t i) const { return _kov(_v[i]); }
+
+		/* 정렬할 때 원소 대신 포인터를 옮긴다. (key가 const라 원소끼리는 대입할 수 없다) */
+		struct ptr_less {
+			Compare		comp;
+			KeyOfValue	kov;
+			ptr_less(const Compare& c) : comp(c), kov() { }
+			bool operator()(const ValueType* a, const ValueType* b) const { return comp(kov(*a), kov(*b)); }
+		};
+
+	public:
+		SortedVector(const Compare& comp, const Alloc& alloc) : _v(alloc), _comp(comp), _kov() { }
+
+		iterator		begin()			{ return _v.begin(); }
+		const_iterator	begin() const	{ return _v.begin(); }
+		iterator		end()			{ return _v.end(); }
+		const_iterator	end() const		{ return _v.end(); }
+
+		size_t	getSize() const		{ return _v.size(); }
+		size_t	max_size() const	{ return _v.max_size(); }
+		size_t	capacity() const	{ return _v.capacity(); }
+		void	reserve(size_t n)	{ _v.reserve(n); }
+
+		/* key보다 작지 않은 첫 원소의 index.
+		 * 범위를 반씩 줄이되 분기 대신 조건부 대입으로 lo를 고른다. 비교 결과를 예측할 수 없는 이분 탐색에서는 분기 예측 실패가 비교보다 비싸다. */
+		size_t	lower_index(const Key& k) const {
+			size_t n = _v.size();
+			if (n == 0)
+				return 0;
+			size_t lo = 0;
+			while (n > 1) {
+				size_t half = n / 2;
+				lo = _comp(_key(lo + half), k) ? lo + half : lo;
+				n -= half;
+			}
+			return lo + _comp(_key(lo), k);
+		}
+
+		/* key보다 큰 첫 원소의 index */
+		size_t	upper_index(const Key& k) const {
+			size_t n = _v.size();
+			if (n == 0)
+				return 0;
+			size_t lo = 0;
+			while (n > 1) {
+				size_t half = n / 2;
+				lo = !_comp(k, _key(lo + half)) ? lo + half : lo;
+				n -= half;
+			}
+			return lo + !_comp(k, _key(lo));
+		}
+
+		position	locate(const Key& k) const {
+			position pos;
+			pos.index = lower_index(k);
+			pos.found = (pos.index < _v.size() && !_comp(k, _key(pos.index)));
+			return pos;
+		}
+
+		/* hint 바로 앞에 k가 들어갈 자리면 비교 두 번으로 끝난다. 아니면 이분 탐색. */
+		position	locate_hint(const_iterator hint, const Key& k) const {
+			size_t i = hint - _v.begin();
+			if ((i == _v.size() || _comp(k, _key(i))) && (i == 0 || _comp(_key(i - 1), k))) {
+				position pos;
+				pos.index = i;
+				pos.found = false;
+				return pos;
+			}
+			return locate(k);
+		}
+
+		iterator	insert_at(const position& pos, const ValueType& v) {
+			return _v.insert(_v.begin() + pos.index, v);
+		}
+
+		ft::pair<iterator, bool>	insert(const ValueType& v) {
+			position pos = locate(_kov(v));
+			if (pos.found)
+				return ft::make_pair(_v.begin() + pos.index, false);
+			return ft::make_pair(insert_at(pos, v), true);
+		}
+
+		iterator	insert(const_iterator hint, const ValueType& v) {
+			position pos = locate_hint(hint, _kov(v));
+			if (pos.found)
+				return _v.begin() + pos.index;
+			return insert_at(pos, v);
+		}
+
+		/* [first, last)를 모아 key 순서로 (같은 key는 먼저 온 것이 앞에) 정렬하고, 이미 있는 key와 뒤에 나온 같은 key는 버리며 merge한다.
+		 * 새 원소가 모두 마지막 원소보다 크면 뒤에 붙이기만 한다. */
+		template <typename InputIterator>
+		void	insert_range(InputIterator first, InputIterator last) {
+			container_type staged(_v.get_allocator());
+			while (first != last)
+				staged.push_back(*first++);
+			size_t m = staged.size();
+			if (m == 0)
+				return;
+			ft::vector<const ValueType*, ptr_allocator> order;
+			order.reserve(m);
+			bool sorted = true;
+			for (size_t j = 0; j < m; j++) {
+				if (j > 0 && !_comp(_kov(staged[j - 1]), _kov(staged[j])))
+					sorted = false;
+				order.push_back(&staged[j]);
+			}
+			if (!sorted)
+				std::stable_sort(&order[0], &order[0] + m, ptr_less(_comp));
+
+			size_t n = _v.size();
+			if (n == 0 || _comp(_key(n - 1), _kov(*order[0]))) {
+				_v.reserve(n + m);
+				for (size_t j = 0; j < m; j++)
+					if (j == 0 || _comp(_kov(*order[j - 1]), _kov(*order[j])))
+						_v.push_back(*order[j]);
+				return;
+			}
+
+			container_type out(_v.get_allocator());
+			out.reserve(n + m);
+			size_t i = 0;
+			for (size_t j = 0; j < m; j++) {
+				const Key& k = _kov(*order[j]);
+				while (i < n && _comp(_key(i), k))
+					out.push_back(_v[i++]);
+				bool dup = (i < n && !_comp(k, _key(i))) || (j > 0 && !_comp(_kov(*order[j - 1]), k));
+				if (!dup)
+					out.push_back(*order[j]);
+			}
+			while (i < n)
+				out.push_back(_v[i++]);
+			_v.swap(out);
+		}
+
+		/* 정렬되어 있고 key가 겹치지 않는 [first, last)로 바꾼다. */
+		template <typename InputIterator>
+		void	assign_sorted(InputIterator first, InputIterator last) {
+			_v.clear();
+			while (first != last)
+				_v.push_back(*first++);
+		}
+
+		iterator	erase(const_iterator pos) {
+			return _v.erase(_v.begin() + (pos - _v.begin()));
+		}
+
+		iterator	erase(const_iterator first, const_iterator last) {
+			return _v.erase(_v.begin() + (first - _v.begin()), _v.begin() + (last - _v.begin()));
+		}
+
+		size_t	erase(const Key& k) {
+			position pos = locate(k);
+			if (!pos.found)
+				return 0;
+			_v.erase(_v.begin() + pos.index);
+			return 1;
+		}
+
+		iterator		at_index(size_t i)			{ return _v.begin() + i; }
+		const_iterator	at_index(size_t i) const	{ return _v.begin() + i; }
+
+		iterator		find(const Key& k) {
+			position pos = locate(k);
+			return pos.found ? _v.begin() + pos.index : _v.end();
+		}
+		const_iterator	find(const Key& k) const {
+			position pos = locate(k);
+			return pos.found ? _v.begin() + pos.index : _v.end();
+		}
+
+		void	clear()					{ _v.clear(); }
+		void	swap(SortedVector& x) {
+			_v.swap(x._v);
+			std::swap(_comp, x._comp);
+		}
+};
+
+
+}
+#endif
@@ -0,0 +1,192 @@
+#ifndef STATIC_INDEX_HPP
+# define STATIC_INDEX_HPP
+
+# include <cstddef> // size_t
+# include <functional> // less
+# include <algorithm> // swap
+# ifdef __SSE2__
+#  include <emmintrin.h>
+# endif
+# include "../vector.hpp"
+# include "is_integral.hpp"
+
+/* static_map, static_set 이 쓰는 한 번 만들고 바꾸지 않는 정렬된 key 배열의 index.
+ *
+ * 이분 탐색은 level마다 배열의 먼 곳을 하나씩 읽고, Eytzinger(BFS) 순서로 늘어놓은 이진 tree도 level마다 key 하나를 비교한다.
+ * 여기서는 Eytzinger 순서를 B-ary로 넓혀서 key width개(cache line 하나, int면 16개)를 node 하나로 묶는다.
+ *   - leaf layer : 정렬된 key 전부. width개씩 node가 되고, 마지막 node는 가장 큰 key로 채운다.
+ *   - 그 위의 layer : node마다 key width개, 자식 width + 1개. layer 안에서 node는 왼쪽부터 (BFS 순서) 놓이고,
+ *     node j의 자식은 아래 layer의 j * (width + 1) + c 번째 node 라서 포인터가 필요 없다.
+ *     keys[i]는 자식 i + 1 서브트리의 가장 작은 key다. 없는 자식 자리는 가장 큰 key로 채운다.
+ * 찾을 때는 node에서 x보다 작은 key의 수를 세어 그 번호의 자식으로 내려간다. 세는 것은 분기가 없고,
+ * 32 bit 정수 key를 std::less로 비교하면 SSE2로 16개를 한 번에 비교한다. level마다 cache line 하나만 읽는다. (int 1M개면 5 level)
+ * leaf layer에서 센 위치가 곧 정렬 순서의 index(rank)다.
+ * node가 cache line에 맞게 놓이도록 배열 앞쪽을 조금 비워 두므로, 복사할 때는 새로 만든다.
+ */
+
+namespace ft {
+
+/* node의 key width개 중 x보다 작은 것의 수. 분기 없이 다 비교한다. */
+template <typename Key, typename Compare, bool Simd = (ft::is_integral<Key>::value && sizeof(Key) == 4)>
+struct static_node_search {
+	static size_t	count_less(const Key* node, size_t width, const Key& x, const Compare& comp) {
+		size_t count = 0;
+		for (size_t i = 0; i < width; i++)
+			count += comp(node[i], x);
+		return count;
+	}
+};
+
+# ifdef __SSE2__
+/* 32 bit 정수 key 16개를 SSE2로 한 번에 비교한다. unsigned는 부호 bit를 뒤집어 signed 비교로 바꾼다. */
+template <typename Key>
+struct static_node_search<Key, std::less<Key>, true> {
+	static size_t	count_less(const Key* node, size_t, const Key& x, const std::less<Key>&) {
+		const __m128i	bias = _mm_set1_epi32((Key(-1) < Key(0)) ? 0 : -2147483647 - 1);
+		const __m128i	v = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(x)), bias);
+		const __m128i*	p = reinterpret_cast<const __m128i*>(node);
+		__m128i	c0 = _mm_cmpgt_epi32(v, _mm_xor_si128(_mm_loadu_si128(p), bias));
+		__m128i	c1 = _mm_cmpgt_epi32(v, _mm_xor_si128(_mm_loadu_si128(p + 1), bias));
+		__m128i	c2 = _mm_cmpgt_epi32(v, _mm_xor_si128(_mm_loadu_si128(p + 2), bias));
+		__m128i	c3 = _mm_cmpgt_epi32(v, _mm_xor_si128(_mm_loadu_si128(p + 3), bias));
+		// 작은 칸은 -1이다. 16칸을 더하면 -(작은 key의 수)
+		__m128i	sum = _mm_add_epi32(_mm_add_epi32(c0, c1), _mm_add_epi32(c2, c3));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+		return static_cast<size_t>(-_mm_cvtsi128_si32(sum));
+	}
+};
+# endif
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Compare, typename Alloc>
+class StaticIndex {
+	public:
+		typedef typename Alloc::template rebind<Key>::other		key_allocator;
+		typedef ft::vector<Key, key_allocator>					container_type;
+		typedef typename container_type::const_iterator			const_iterator;
+
+		// node 하나의 key 수. cache line 하나(64 byte)에 들어가는 만큼, 적어도 2개
+		enum { width = (64 / sizeof(Key) < 2) ? 2 : 64 / sizeof(Key) };
+		enum { max_height = 48 };
+
+	private:
+		typedef static_node_search<Key, Compare>	search;
+
+		container_type	_keys;
+		size_t			_size;
+		size_t			_height;				// layer 수. leaf layer가 0, root가 _height - 1
+		size_t			_offset[max_height];	// layer마다 첫 key의 위치
+		Compare			_comp;
+
+		StaticIndex& operator=(const StaticIndex& rhs);
+
+		const Key*	_layer(size_t h) const { return &_keys[_offset[h]]; }
+
+		/* [first, first + n)의 key를 proj로 꺼내 layer를 쌓는다. */
+		template <typename ForwardIt, typename Project>
+		void	_build(ForwardIt first, size_t n, Project proj) {
+			_keys.clear();
+			_size = n;
+			_height = 0;
+			if (n == 0)
+				return;
+			size_t nodes[max_height];
+			size_t total = 0;
+			for (size_t c = (n + width - 1) / width; ; c = (c + width) / (width + 1)) {
+				nodes[_height++] = c;
+				total += c;
+				if (c == 1)
+					break;
+			}
+			// node가 딱 cache line 하나일 때만 줄을 맞춘다. (key 크기가 할당 단위의 정렬보다 크면 맞출 수 없다)
+			bool aligned = (width * sizeof(Key) == 64 && sizeof(Key) <= 16);
+			Key first_key = proj(*first);
+			_keys.assign(total * width + (aligned ? width - 1 : 0), first_key);
+			size_t base = 0;
+			if (aligned)
+				base = ((64 - reinterpret_cast<size_t>(&_keys[0]) % 64) % 64) / sizeof(Key);
+			_offset[0] = base;
+			for (size_t h = 1; h < _height; h++)
+				_offset[h] = _offset[h - 1] + nodes[h - 1] * width;
+
+			Key* leaves = &_keys[base];
+			for (size_t i = 0; i < n; i++, ++first)
+				leaves[i] = proj(*first);
+			for (size_t i = n; i < nodes[0] * width; i++)
+				leaves[i] = leaves[n - 1];
+			size_t span = width;		// 아래 layer의 node 하나가 덮는 rank 수
+			for (size_t h = 1; h < _height; h++) {
+				Key* layer = &_keys[_offset[h]];
+				for (size_t j = 0; j < nodes[h]; j++)
+					for (size_t i = 0; i < width; i++) {
+						size_t child = j * (width + 1) + i + 1;
+						layer[j * width + i] = (child < nodes[h - 1] && child * span < n) ? leaves[child * span] : leaves[n - 1];
+					}
+				span *= width + 1;
+			}
+		}
+
+		struct key_of_key {
+			const Key&	operator()(const Key& k) const { return k; }
+		};
+
+	public:
+		StaticIndex(const Compare& comp, const Alloc& alloc) : _keys(key_allocator(alloc)), _size(0), _height(0), _comp(comp) { }
+
+		// 줄 맞춤은 주소에 따라 다르므로 배열을 그대로 복사하지 않고 새로 쌓는다. O(n)
+		StaticIndex(const StaticIndex& other) : _keys(other._keys.get_allocator()), _size(0), _height(0), _comp(other._comp) {
+			_build(other.begin(), other.size(), key_of_key());
+		}
+
+		/* [first, first + n)은 key 순서로 정렬되어 있고 중복이 없어야 한다. */
+		template <typename ForwardIt>
+		void	build(ForwardIt first, size_t n) {
+			_build(first, n, KeyOfValue());
+		}
+
+		size_t	size() const { return _size; }
+		size_t	max_size() const { return _keys.max_size() / 2; }
+
+		// 정렬된 key. static_set은 이것을 그대로 원소로 쓴다.
+		const_iterator	begin() const	{ return _keys.begin() + (_height ? _offset[0] : 0); }
+		const_iterator	end() const		{ return begin() + _size; }
+
+		/* key보다 작지 않은 첫 key의 rank. 없으면 size(). */
+		size_t	lower_index(const Key& key) const {
+			if (_size == 0 || _comp(_layer(0)[_size - 1], key))
+				return _size;
+			size_t k = 0;
+			for (size_t h = _height - 1; h > 0; h--)
+				k = k * (width + 1) + search::count_less(_layer(h) + k * width, width, key, _comp);
+			return k * width + search::count_less(_layer(0) + k * width, width, key, _comp);
+		}
+
+		/* key의 rank. 없으면 size(). */
+		size_t	find_index(const Key& key) const {
+			size_t i = lower_index(key);
+			if (i != _size && _comp(key, _layer(0)[i]))
+				return _size;
+			return i;
+		}
+
+		/* key보다 큰 첫 key의 rank. 없으면 size(). */
+		size_t	upper_index(const Key& key) const {
+			size_t i = lower_index(key);
+			if (i != _size && !_comp(key, _layer(0)[i]))
+				i++;
+			return i;
+		}
+
+		void	swap(StaticIndex& other) {
+			_keys.swap(other._keys);
+			std::swap(_size, other._size);
+			std::swap(_height, other._height);
+			for (size_t h = 0; h < max_height; h++)
+				std::swap(_offset[h], other._offset[h]);
+			std::swap(_comp, other._comp);
+		}
+};
+
+
+}
+#endif
@@ -0,0 +1,553 @@
+#ifndef SWISS_TABLE_HPP
+# define SWISS_TABLE_HPP
+
+# include <cstddef> // size_t, ptrdiff_t
+# include <cstring> // memset, memcpy
+# include <algorithm> // swap
+# include <iterator> // forward_iterator_tag
+# include <memory> // allocator
+# ifdef __SSE2__
+#  include <emmintrin.h>
+# endif
+# include "pair.hpp"
+# include "hash.hpp"
+# include "is_trivially_relocatable.hpp"
+
+/* unordered_map, unordered_set 이 쓰는 open addressing hash table. (Swiss table)
+ *
+ * 원소는 node 없이 slot 배열 하나에 바로 들어가고, slot마다 1 byte 짜리 control byte를 따로 배열로 둔다.
+ *   - empty(0x80), deleted(0xFE, 지운 자리), sentinel(0xFF, 배열 끝) 이거나
+ *   - 원소가 있으면 그 hash의 아래 7 bit (H2)
+ * 나머지 bit (H1)로 시작 위치를 정하고, control byte 16개(group)를 한 번에 읽어 H2가 같은 slot만 key를 비교한다.
+ * SSE2가 있으면 group 비교는 명령 몇 개로 끝난다. 찾는 key가 없을 때도 보통 control byte의 cache line 하나만 읽고 끝난다.
+ * group에 empty가 하나라도 있으면 그 뒤로는 찾을 필요가 없다. (넣을 때 거기서 멈췄을 것이므로)
+ *
+ * capacity는 2^k - 1 이고 control 배열은 capacity + 16 byte다. ctrl[capacity]는 sentinel이고 그 뒤 15 byte는 ctrl[0..14]의 복사본이라
+ * 어느 위치에서 group을 읽어도 배열 밖으로 나가지 않고 끝에서 처음으로 이어진다.
+ * 원소 수가 capacity의 7/8 (deleted 포함)을 넘으려 하면 두 배로 늘린다. deleted가 많으면 같은 크기로 다시 만들어 치운다.
+ * 다시 만들 때(rehash) 원소의 위치가 바뀌므로 insert는 모든 iterator를 무효화할 수 있다. erase는 지운 원소의 iterator만 무효화한다.
+ */
+
+namespace ft {
+
+typedef signed char	ctrl_t;
+
+struct swiss_ctrl {
+	static const ctrl_t	empty = -128;
+	static const ctrl_t	deleted = -2;
+	static const ctrl_t	sentinel = -1;
+};
+
+/* capacity가 0인 table의 control 배열. 쓰지 않고 읽기만 한다. (begin() == end(), 찾으면 바로 empty를 만남) */
+inline ctrl_t*	swiss_empty_group() {
+	static ctrl_t group[16] = { swiss_ctrl::sentinel,
+		swiss_ctrl::empty, swiss_ctrl::empty, swiss_ctrl::empty, swiss_ctrl::empty, swiss_ctrl::empty,
+		swiss_ctrl::empty, swiss_ctrl::empty, swiss_ctrl::empty, swiss_ctrl::empty, swiss_ctrl::empty,
+		swiss_ctrl::empty, swiss_ctrl::empty, swiss_ctrl::empty, swiss_ctrl::empty, swiss_ctrl::empty };
+	return group;
+}
+
+/* control byte 16개. match* 는 조건에 맞는 byte의 위치를 bit mask로 돌려준다. (bit i == ctrl[i]) */
+struct swiss_group {
+	static const size_t	width = 16;
+
+# ifdef __SSE2__
+	__m128i	ctrl;
+
+	explicit swiss_group(const ctrl_t* p) : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) { }
+
+	unsigned	match(ctrl_t h2) const {
+		return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+	}
+	unsigned	match_empty() const {
+		return match(swiss_ctrl::empty);
+	}
+	// empty, deleted 만 sentinel(-1)보다 작다
+	unsigned	match_empty_or_deleted() const {
+		return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(swiss_ctrl::sentinel), ctrl)));
+	}
+# else
+	const ctrl_t*	ctrl;
+
+	explicit swiss_group(const ctrl_t* p) : ctrl(p) { }
+
+	unsigned	match(ctrl_t h2) const {
+		unsigned mask = 0;
+		for (size_t i = 0; i < width; i++)
+			if (ctrl[i] == h2)
+				mask |= 1u << i;
+		return mask;
+	}
+	unsigned	match_empty() const {
+		return match(swiss_ctrl::empty);
+	}
+	unsigned	match_empty_or_deleted() const {
+		unsigned mask = 0;
+		for (size_t i = 0; i < width; i++)
+			if (ctrl[i] < swiss_ctrl::sentinel)
+				mask |= 1u << i;
+		return mask;
+	}
+# endif
+
+	// 앞에서부터 연속된 empty, deleted의 수
+	size_t	count_leading_empty_or_deleted() const {
+		return __builtin_ctz(~match_empty_or_deleted());
+	}
+};
+
+
+/* control byte와 slot을 나란히 가리킨다. end()는 sentinel 위치. */
+template <typename T>
+class hash_iterator {
+	public:
+		typedef T									value_type;
+		typedef T*									pointer;
+		typedef T&									reference;
+		typedef ptrdiff_t							difference_type;
+		typedef std::forward_iterator_tag			iterator_category;
+		ctrl_t*	_ctrl;
+		T*		_slot;
+
+		hash_iterator() : _ctrl(NULL), _slot(NULL) { }
+		hash_iterator(ctrl_t* ctrl, T* slot) : _ctrl(ctrl), _slot(slot) { }
+		hash_iterator(const hash_iterator& other) : _ctrl(other._ctrl), _slot(other._slot) { }
+		hash_iterator& operator=(const hash_iterator& rhs) {
+			_ctrl = rhs._ctrl;
+			_slot = rhs._slot;
+			return *this;
+		}
+		~hash_iterator() { }
+
+		/* 원소가 있는 slot이나 sentinel까지 group 단위로 건너뛴다. */
+		void	skip_empty() {
+			while (*_ctrl < swiss_ctrl::sentinel) {
+				size_t n = swiss_group(_ctrl).count_leading_empty_or_deleted();
+				_ctrl += n;
+				_slot += n;
+			}
+		}
+
+		reference operator*() const { return *_slot; }
+		pointer operator->() const { return _slot; }
+
+		hash_iterator& operator++() {
+			++_ctrl;
+			++_slot;
+			skip_empty();
+			return *this;
+		}
+
+		hash_iterator operator++(int) {
+			hash_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		bool operator==(const hash_iterator& rhs) const { return _ctrl == rhs._ctrl; }
+		bool operator!=(const hash_iterator& rhs) const { return _ctrl != rhs._ctrl; }
+};
+
+
+template <typename T>
+class hash_const_iterator {
+	public:
+		typedef T									value_type;
+		typedef const T*							pointer;
+		typedef const T&							reference;
+		typedef ptrdiff_t							difference_type;
+		typedef std::forward_iterator_tag			iterator_category;
+		const ctrl_t*	_ctrl;
+		const T*		_slot;
+
+		hash_const_iterator() : _ctrl(NULL), _slot(NULL) { }
+		hash_const_iterator(const ctrl_t* ctrl, const T* slot) : _ctrl(ctrl), _slot(slot) { }
+		hash_const_iterator(const hash_const_iterator& other) : _ctrl(other._ctrl), _slot(other._slot) { }
+		hash_const_iterator(const hash_iterator<T>& other) : _ctrl(other._ctrl), _slot(other._slot) { }
+		hash_const_iterator& operator=(const hash_const_iterator& rhs) {
+			_ctrl = rhs._ctrl;
+			_slot = rhs._slot;
+			return *this;
+		}
+		~hash_const_iterator() { }
+
+		void	skip_empty() {
+			while (*_ctrl < swiss_ctrl::sentinel) {
+				size_t n = swiss_group(_ctrl).count_leading_empty_or_deleted();
+				_ctrl += n;
+				_slot += n;
+			}
+		}
+
+		reference operator*() const { return *_slot; }
+		pointer operator->() const { return _slot; }
+
+		hash_const_iterator& operator++() {
+			++_ctrl;
+			++_slot;
+			skip_empty();
+			return *this;
+		}
+
+		hash_const_iterator operator++(int) {
+			hash_const_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		bool operator==(const hash_const_iterator& rhs) const { return _ctrl == rhs._ctrl; }
+		bool operator!=(const hash_const_iterator& rhs) const { return _ctrl != rhs._ctrl; }
+};
+
+
+template <typename Key, typename ValueType, typename KeyOfValue, typename Hash, typename KeyEqual, typename Alloc>
+class SwissTable {
+	public:
+		typedef ValueType							value_type;
+		typedef hash_iterator<ValueType>			iterator;
+		typedef hash_const_iterator<ValueType>		const_iterator;
+
+		static const size_t	npos = static_cast<size_t>(-1);
+		static const size_t	min_capacity = 15;
+
+		/* locate()의 결과. found면 index는 그 원소의 위치, 아니면 insert_at에 넘겨 hash를 다시 구하지 않는다. */
+		struct position {
+			size_t	index;
+			size_t	hash;
+			bool	found;
+		};
+
+	private:
+		typedef typename Alloc::template rebind<ValueType>::other	slot_allocator;
+		typedef typename Alloc::template rebind<ctrl_t>::other		ctrl_allocator;
+
+		static const size_t	width = swiss_group::width;
+
+		ctrl_t*			_ctrl;
+		ValueType*		_slots;
+		size_t			_capacity;
+		size_t			_size;
+		size_t			_growth_left;		// rehash 없이 더 쓸 수 있는 empty slot 수
+		Hash			_hash;
+		KeyEqual		_eq;
+		KeyOfValue		_kov;
+		slot_allocator	_alloc;
+		ctrl_allocator	_ctrl_alloc;
+
+		static size_t	_growth(size_t capacity) { return capacity - capacity / 8; }
+
+		/* 정수 key의 hash는 값 그대로라 hash_mix로 섞고, 위쪽 절반을 아래로 접어 H1, H2가 모든 bit에 영향받게 한다. */
+		size_t	_hash_of(const Key& k) const {
+			size_t h = ft::hash_mix(_hash(k));
+			return h ^ (h >> (sizeof(size_t) * 4));
+		}
+		static size_t	_h1(size_t h) { return h >> 7; }
+		static ctrl_t	_h2(size_t h) { return static_cast<ctrl_t>(h & 0x7F); }
+
+		/* ctrl[0..14]를 바꾸면 끝의 복사본도 같이 바꾼다. 그 외의 i는 같은 자리에 두 번 쓴다. */
+		void	_set_ctrl(size_t i, ctrl_t c) {
+			_ctrl[i] = c;
+			_ctrl[((i - (width - 1)) & _capacity) + ((width - 1) & _capacity)] = c;
+		}
+
+		/* group 단위로 건너뛰며 찾는다. (시작 group에서 16, 32, 48, ... 씩 떨어진 group. 2^k개의 group을 모두 한 번씩 들른다) */
+		size_t	_find(const Key& k, size_t h) const {
+			size_t offset = _h1(h) & _capacity;
+			ctrl_t h2 = _h2(h);
+			for (size_t step = width; ; step += width) {
+				swiss_group g(_ctrl + offset);
+				for (unsigned m = g.match(h2); m; m &= m - 1) {
+					size_t i = (offset + __builtin_ctz(m)) & _capacity;
+					if (_eq(_kov(_slots[i]), k))
+						return i;
+				}
+				if (g.match_empty())
+					return npos;
+				offset = (offset + step) & _capacity;
+			}
+		}
+
+		size_t	_find_first_non_full(size_t h) const {
+			size_t offset = _h1(h) & _capacity;
+			for (size_t step = width; ; step += width) {
+				unsigned m = swiss_group(_ctrl + offset).match_empty_or_deleted();
+				if (m)
+					return (offset + __builtin_ctz(m)) & _capacity;
+				offset = (offset + step) & _capacity;
+			}
+		}
+
+		/* 두 배열을 다 할당한 뒤에야 멤버를 바꾼다. 할당이 실패하면 table은 그대로다. */
+		void	_allocate(size_t capacity) {
+			ctrl_t* ctrl = _ctrl_alloc.allocate(capacity + width);
+			ValueType* slots;
+			try {
+				slots = _alloc.allocate(capacity);
+			} catch (...) {
+				_ctrl_alloc.deallocate(ctrl, capacity + width);
+				throw;
+			}
+			std::memset(ctrl, swiss_ctrl::empty, capacity + width);
+			ctrl[capacity] = swiss_ctrl::sentinel;
+			_ctrl = ctrl;
+			_slots = slots;
+			_capacity = capacity;
+		}
+
+		void	_deallocate() {
+			if (_capacity == 0)
+				return;
+			_alloc.deallocate(_slots, _capacity);
+			_ctrl_alloc.deallocate(_ctrl, _capacity + width);
+		}
+
+		void	_destroy_all() {
+			if (is_trivially_relocatable<ValueType>::value)
+				return;
+			for (size_t i = 0; i < _capacity; i++)
+				if (_ctrl[i] >= 0)
+					_alloc.destroy(_slots + i);
+		}
+
+		void	_reset_empty() {
+			_ctrl = swiss_empty_group();
+			_slots = NULL;
+			_capacity = 0;
+			_size = 0;
+			_growth_left = 0;
+		}
+
+		/* capacity 크기의 새 배열로 옮긴다. 원소를 복사하다 예외가 나면 원래 table은 그대로다. */
+		void	_resize(size_t capacity) {
+			ctrl_t* old_ctrl = _ctrl;
+			ValueType* old_slots = _slots;
+			size_t old_capacity = _capacity;
+			_allocate(capacity);
+			size_t i = 0;
+			try {
+				for (; i < old_capacity; i++) {
+					if (old_ctrl[i] < 0)
+						continue;
+					size_t h = _hash_of(_kov(old_slots[i]));
+					size_t j = _find_first_non_full(h);
+					if (is_trivially_relocatable<ValueType>::value)
+						std::memcpy(static_cast<void*>(_slots + j), static_cast<const void*>(old_slots + i), sizeof(ValueType));
+					else
+						_alloc.construct(_slots + j, old_slots[i]);
+					_set_ctrl(j, _h2(h));
+				}
+			} catch (...) {
+				_destroy_all();
+				_deallocate();
+				_ctrl = old_ctrl;
+				_slots = old_slots;
+				_capacity = old_capacity;
+				throw;
+			}
+			std::swap(_ctrl, old_ctrl);
+			std::swap(_slots, old_slots);
+			std::swap(_capacity, old_capacity);
+			_destroy_all();
+			_deallocate();
+			_ctrl = old_ctrl;
+			_slots = old_slots;
+			_capacity = old_capacity;
+			_growth_left = _growth(_capacity) - _size;
+		}
+
+		/* growth_left가 다 떨어졌을 때. deleted가 capacity의 3/32 넘게 쌓였으면 같은 크기로 다시 만들어 치운다. */
+		void	_rehash_and_grow() {
+			if (_capacity == 0)
+				_resize(min_capacity);
+			else if (_size * 32 <= _capacity * 25)
+				_resize(_capacity);
+			else
+				_resize(_capacity * 2 + 1);
+		}
+
+		// growth(capacity) >= n 인 가장 작은 2^k - 1
+		static size_t	_capacity_for(size_t n) {
+			size_t capacity = min_capacity;
+			while (_growth(capacity) < n)
+				capacity = capacity * 2 + 1;
+			return capacity;
+		}
+
+		/* 앞뒤 group에 empty가 있어서 i를 지나쳐 찾아간 원소가 있을 수 없으면 deleted 대신 empty로 되돌린다.
+		 * (i를 포함하는 16칸 안에서 empty 사이의 거리가 16보다 짧으면, 그 사이가 꽉 찬 group으로 읽힌 적이 없다) */
+		void	_erase_at(size_t i) {
+			_alloc.destroy(_slots + i);
+			--_size;
+			bool was_never_full = true;		// group 하나짜리 table은 찾을 때 다음 group으로 넘어가지 않는다
+			if (_capacity >= width) {
+				unsigned empty_before = swiss_group(_ctrl + ((i - width) & _capacity)).match_empty();
+				unsigned empty_after = swiss_group(_ctrl + i).match_empty();
+				was_never_full = empty_before && empty_after
+					&& static_cast<size_t>(__builtin_clz(empty_before) - (sizeof(unsigned) * 8 - width)) + __builtin_ctz(empty_after) < width;
+			}
+			_set_ctrl(i, was_never_full ? swiss_ctrl::empty : swiss_ctrl::deleted);
+			if (was_never_full)
+				++_growth_left;
+		}
+
+	public:
+		SwissTable(const Hash& hash, const KeyEqual& eq, const Alloc& alloc)
+			: _hash(hash), _eq(eq), _kov(), _alloc(alloc), _ctrl_alloc(alloc) {
+				_reset_empty();
+		}
+
+		SwissTable(const SwissTable& other)
+			: _hash(other._hash), _eq(other._eq), _kov(), _alloc(other._alloc), _ctrl_alloc(other._ctrl_alloc) {
+				_reset_empty();
+				if (other._size == 0)
+					return;
+				_allocate(other._capacity);
+				std::memcpy(_ctrl, other._ctrl, _capacity + width);
+				size_t i = 0;
+				try {
+					for (; i < _capacity; i++)
+						if (_ctrl[i] >= 0)
+							_alloc.construct(_slots + i, other._slots[i]);
+				} catch (...) {
+					while (i-- > 0)
+						if (_ctrl[i] >= 0)
+							_alloc.destroy(_slots + i);
+					_deallocate();
+					throw;
+				}
+				_size = other._size;
+				_growth_left = other._growth_left;
+		}
+
+		~SwissTable() {
+			_destroy_all();
+			_deallocate();
+		}
+
+		size_t	getSize() const		{ return _size; }
+		size_t	capacity() const	{ return _capacity; }
+		size_t	max_size() const	{ return _alloc.max_size(); }
+
+		iterator		begin() {
+			iterator it(_ctrl, _slots);
+			it.skip_empty();
+			return it;
+		}
+		const_iterator	begin() const {
+			const_iterator it(_ctrl, _slots);
+			it.skip_empty();
+			return it;
+		}
+		iterator		end()			{ return iterator(_ctrl + _capacity, _slots + _capacity); }
+		const_iterator	end() const		{ return const_iterator(_ctrl + _capacity, _slots + _capacity); }
+
+		iterator		at_index(size_t i)			{ return iterator(_ctrl + i, _slots + i); }
+		const_iterator	at_index(size_t i) const	{ return const_iterator(_ctrl + i, _slots + i); }
+
+		/* hash를 한 번만 구해 찾는다. 없으면 insert_at(pos, v)로 넣는다. (v의 key는 찾은 key와 같아야 한다) */
+		position	locate(const Key& k) const {
+			position pos;
+			pos.hash = _hash_of(k);
+			pos.index = _find(k, pos.hash);
+			pos.found = (pos.index != npos);
+			return pos;
+		}
+
+		iterator	insert_at(const position& pos, const value_type& v) {
+			size_t i = _find_first_non_full(pos.hash);
+			if (_growth_left == 0 && _ctrl[i] != swiss_ctrl::deleted) {
+				_rehash_and_grow();
+				i = _find_first_non_full(pos.hash);
+			}
+			_alloc.construct(_slots + i, v);
+			if (_ctrl[i] == swiss_ctrl::empty)
+				--_growth_left;
+			_set_ctrl(i, _h2(pos.hash));
+			++_size;
+			return at_index(i);
+		}
+
+		ft::pair<iterator, bool>	insert(const value_type& v) {
+			position pos = locate(_kov(v));
+			if (pos.found)
+				return ft::make_pair(at_index(pos.index), false);
+			return ft::make_pair(insert_at(pos, v), true);
+		}
+
+		iterator		find(const Key& k) {
+			size_t i = _find(k, _hash_of(k));
+			return (i == npos) ? end() : at_index(i);
+		}
+		const_iterator	find(const Key& k) const {
+			size_t i = _find(k, _hash_of(k));
+			return (i == npos) ? end() : at_index(i);
+		}
+
+		bool	contains(const Key& k) const { return _find(k, _hash_of(k)) != npos; }
+
+		void	erase(const_iterator pos) {
+			_erase_at(static_cast<size_t>(pos._ctrl - _ctrl));
+		}
+
+		size_t	erase(const Key& k) {
+			size_t i = _find(k, _hash_of(k));
+			if (i == npos)
+				return 0;
+			_erase_at(i);
+			return 1;
+		}
+
+		// capacity는 그대로 둔다.
+		void	clear() {
+			if (_capacity == 0)
+				return;
+			_destroy_all();
+			std::memset(_ctrl, swiss_ctrl::empty, _capacity + width);
+			_ctrl[_capacity] = swiss_ctrl::sentinel;
+			_size = 0;
+			_growth_left = _growth(_capacity);
+		}
+
+		/* rehash 없이 n개까지 넣을 수 있게 한다. */
+		void	reserve(size_t n) {
+			size_t capacity = _capacity_for(n);
+			if (capacity > _capacity)
+				_resize(capacity);
+		}
+
+		/* capacity를 n 이상이면서 지금 원소가 들어가는 가장 작은 크기로 맞춘다. deleted도 모두 치운다. */
+		void	rehash(size_t n) {
+			size_t capacity = _capacity_for(_size);
+			while (capacity < n)
+				capacity = capacity * 2 + 1;
+			if (_size == 0 && n == 0) {
+				_destroy_all();
+				_deallocate();
+				_reset_empty();
+				return;
+			}
+			_resize(capacity);
+		}
+
+		void	swap(SwissTable& other) {
+			std::swap(_ctrl, other._ctrl);
+			std::swap(_slots, other._slots);
+			std::swap(_capacity, other._capacity);
+			std::swap(_size, other._size);
+			std::swap(_growth_left, other._growth_left);
+			std::swap(_hash, other._hash);
+			std::swap(_eq, other._eq);
+			std::swap(_alloc, other._alloc);
+			std::swap(_ctrl_alloc, other._ctrl_alloc);
+		}
+
+		Hash		hash_function() const	{ return _hash; }
+		KeyEqual	key_eq() const			{ return _eq; }
+
+	private:
+		SwissTable& operator=(const SwissTable& rhs);
+};
+
+
+}
+#endif
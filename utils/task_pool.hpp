@@ -0,0 +1,131 @@
+#ifndef TASK_POOL_HPP
+# define TASK_POOL_HPP
+
+# include <cstddef> // size_t
+# include <pthread.h>
+
+/* fork-join 용 작은 thread pool. (C++98이라 std::thread 대신 pthread)
+ *
+ *   ft::task_pool pool(4);           // 호출한 thread 포함 4개. worker thread는 3개
+ *   pool.submit(&t);                 // t.fn(t.arg)를 다른 thread에서 실행
+ *   ...                              // 그동안 이쪽 일을 하고
+ *   pool.wait(&t);                   // t가 끝날 때까지 기다린다
+ *
+ * wait()는 기다리는 동안 queue에 남은 task를 직접 실행한다. 재귀적으로 fork 하는 task가 worker를 모두 붙잡고
+ * 자식 task를 기다려도 교착되지 않고, 호출한 thread도 일을 나눠 맡는다.
+ * task 객체는 submit부터 wait가 끝날 때까지 살아있어야 한다. (보통 호출한 함수의 지역변수)
+ */
+
+namespace ft {
+
+class task_pool {
+	public:
+		struct task {
+			void	(*fn)(void*);
+			void*	arg;
+			bool	done;
+			task*	next;
+
+			task(void (*f)(void*) = NULL, void* a = NULL) : fn(f), arg(a), done(false), next(NULL) { }
+		};
+
+	private:
+		pthread_mutex_t	_lock;
+		pthread_cond_t	_cond;
+		task*			_head;
+		task*			_tail;
+		bool			_stop;
+		size_t			_nthreads;
+		pthread_t*		_workers;
+
+		task_pool(const task_pool&);
+		task_pool& operator=(const task_pool&);
+
+		/* _lock을 잡은 상태에서 호출 */
+		task* _pop() {
+			task* t = _head;
+			if (t) {
+				_head = t->next;
+				if (_head == NULL)
+					_tail = NULL;
+			}
+			return t;
+		}
+
+		/* _lock을 잡은 상태에서 호출. 실행하는 동안만 풀어둔다. */
+		void _run(task* t) {
+			pthread_mutex_unlock(&_lock);
+			t->fn(t->arg);
+			pthread_mutex_lock(&_lock);
+			t->done = true;
+			pthread_cond_broadcast(&_cond);
+		}
+
+		static void* _worker(void* arg) {
+			task_pool* pool = static_cast<task_pool*>(arg);
+			pthread_mutex_lock(&pool->_lock);
+			while (!pool->_stop) {
+				task* t = pool->_pop();
+				if (t)
+					pool->_run(t);
+				else
+					pthread_cond_wait(&pool->_cond, &pool->_lock);
+			}
+			pthread_mutex_unlock(&pool->_lock);
+			return NULL;
+		}
+
+	public:
+		/* threads: 호출한 thread를 포함한 thread 수. 1이면 worker 없이 submit한 task를 wait()에서 실행한다. */
+		explicit task_pool(size_t threads) : _head(NULL), _tail(NULL), _stop(false), _nthreads(threads ? threads : 1), _workers(NULL) {
+			pthread_mutex_init(&_lock, NULL);
+			pthread_cond_init(&_cond, NULL);
+			if (_nthreads > 1)
+				_workers = new pthread_t[_nthreads - 1];
+			for (size_t i = 0; i + 1 < _nthreads; i++)
+				pthread_create(&_workers[i], NULL, &_worker, this);
+		}
+
+		~task_pool() {
+			pthread_mutex_lock(&_lock);
+			_stop = true;
+			pthread_cond_broadcast(&_cond);
+			pthread_mutex_unlock(&_lock);
+			for (size_t i = 0; i + 1 < _nthreads; i++)
+				pthread_join(_workers[i], NULL);
+			delete[] _workers;
+			pthread_cond_destroy(&_cond);
+			pthread_mutex_destroy(&_lock);
+		}
+
+		size_t	size() const { return _nthreads; }
+
+		void submit(task* t) {
+			t->done = false;
+			t->next = NULL;
+			pthread_mutex_lock(&_lock);
+			if (_tail)
+				_tail->next = t;
+			else
+				_head = t;
+			_tail = t;
+			pthread_cond_signal(&_cond);
+			pthread_mutex_unlock(&_lock);
+		}
+
+		void wait(task* t) {
+			pthread_mutex_lock(&_lock);
+			while (!t->done) {
+				task* other = _pop();
+				if (other)
+					_run(other);
+				else
+					pthread_cond_wait(&_cond, &_lock);
+			}
+			pthread_mutex_unlock(&_lock);
+		}
+};
+
+
+}
+#endif
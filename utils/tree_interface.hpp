@@ -1,18 +1,74 @@
 #ifndef TREE_INTERFACE_HPP
 # define TREE_INTERFACE_HPP
 
+# include <new> // placement new
+# include "../vector.hpp"
 # include "node.hpp"
+# include "pool_allocator.hpp"
+# include "is_trivially_relocatable.hpp"
+# include "key_of_value.hpp"
+# include "pair.hpp"
 
 namespace ft {
 
-template <typename ValueType, typename Compare, typename Alloc>
+/* Tag for constructors that take input the caller guarantees to be sorted by key with no duplicates.
+ *   ft::set<int> s(ft::sorted_unique, v.begin(), v.end());
+ */
+struct sorted_unique_t { };
+static const sorted_unique_t	sorted_unique = sorted_unique_t();
+
+/* Stack of nodes for the in-order scan. A red-black tree is at most 2 log2(n) deep, so the fixed part
+ * always suffices for it; only an unbalanced tree (BinarySearchTreeEngine) can spill onto the heap. */
+template <typename Node>
+class scan_stack {
+	public:
+		scan_stack() : _size(0) { }
+
+		bool	empty() const { return _size == 0 && _spill.empty(); }
+		void	push(Node* n) {
+			if (_size < fixed)
+				_nodes[_size++] = n;
+			else
+				_spill.push_back(n);
+		}
+		Node*	pop() {
+			if (!_spill.empty()) {
+				Node* n = _spill.back();
+				_spill.pop_back();
+				return n;
+			}
+			return _nodes[--_size];
+		}
+
+	private:
+		enum { fixed = 96 };
+		Node*				_nodes[fixed];
+		size_t				_size;
+		ft::vector<Node*>	_spill;
+};
+
+/* Common part of the tree engines.
+ * Derived is the engine itself (CRTP). Rebalancing after a link (Derived::_insert_fixup) and unlinking
+ * (Derived::_erase) are forwarded at compile time, so there is no virtual call and lookups inline into
+ * the caller's comparison loop. Derived has to make TreeInterface a friend if it keeps them private.
+ *
+ * Nodes are ordered by Compare on the key that KeyOfValue extracts from each value,
+ * so lookups (find, lower_bound, erase by key...) take a Key and never build a ValueType.
+ *
+ * Node is what gets allocated: nodeBase itself, or a type derived from it that carries per-node data
+ * for an augmented engine (see augment.hpp). Links are always nodeBase*. After building a subtree
+ * in one go (copy, bulk build) each node is passed to Derived::_update bottom-up.
+ */
+template <typename Key, typename ValueType, typename KeyOfValue, typename Compare, typename Alloc, typename Derived,
+			typename Node = nodeBase<ValueType> >
 class TreeInterface {
 	protected:
 		typedef nodeBase<ValueType>		node;
-		node*	_end;
+		node*	_end;			// sentinel. _end->right is _root, _end->left is the rightmost node (NULL if empty)
 		node*	_root;
+		node*	_leftmost;		// begin(). _end if empty
 		size_t	_size;
-		typedef typename Alloc::template rebind<node>::other			NodeAlloc;
+		typedef typename Alloc::template rebind<Node>::other			NodeAlloc;
 		Compare		_comp;
 		NodeAlloc	_alloc;
 
@@ -20,105 +76,503 @@ class TreeInterface {
 		TreeInterface() { }
 		TreeInterface& operator=(const TreeInterface& rhs);
 
-		node* _copy_recurse(node* src, node* dst_parent) {
-			if (!src)
+		/* Build a balanced subtree from the next n distinct values of [first, last) and return its root.
+		 * Values with the same key as the previous one are skipped (the first one wins, as with insert).
+		 * Every node is black except the ones on red_depth, the last level when it is not full,
+		 * so every path has the same number of black nodes and no red node has a red child. */
+		template <typename ForwardIt>
+		node* _build_sorted(ForwardIt& first, ForwardIt last, size_t n, node* parent, size_t depth, size_t red_depth) {
+			if (n == 0)
 				return NULL;
-			//node* dst = new node(src->value, dst_parent);
-			node* dst = _alloc.allocate(1);
-			_alloc.construct(dst, node(src->value, dst_parent));
-			dst->color = src->color;
-			dst->left = _copy_recurse(src->left, dst);
-			dst->right = _copy_recurse(src->right, dst);
-			return dst;
+			size_t left_n = (n - 1) / 2;
+			node* left = _build_sorted(first, last, left_n, NULL, depth + 1, red_depth);
+			node* cur = _create_node(*first, parent);
+			cur->set_color((depth == red_depth) ? ft::RED : ft::BLACK);
+			cur->left = left;
+			if (left)
+				left->set_parent(cur);
+			ForwardIt prev = first;
+			while (++first != last && !_comp(_key(*prev), _key(*first)))
+				;
+			cur->right = _build_sorted(first, last, n - 1 - left_n, cur, depth + 1, red_depth);
+			_derived()._update(cur);
+			return cur;
 		}
 
-		void _deleteTree(node* cur) {
-			if (cur == NULL)
-				return;
-			_deleteTree(cur->left);
-			_deleteTree(cur->right);
-			//delete cur;
-			_alloc.destroy(cur);
-			_alloc.deallocate(cur, 1);
-			_size--;
+		/* If values need no destructor and the allocator can hand back every node at once
+		 * (e.g. ft::pool_allocator), drop the whole tree in O(1) instead of visiting each node.
+		 * _end goes with it, so the caller has to make a new one if the tree lives on. */
+		bool _release_all() {
+			if (!is_trivially_relocatable<ValueType>::value || !allocator_release<NodeAlloc>::release(_alloc))
+				return false;
+			_root = NULL;
+			_size = 0;
+			return true;
 		}
 
 	public:
-		TreeInterface(Compare comp, Alloc alloc) : _root(NULL), _size(0), _comp(comp), _alloc(NodeAlloc(alloc)) {
-			//_end = new node;
-			_end = _alloc.allocate(1);
-			_alloc.construct(_end, node());
+		TreeInterface(const Compare& comp, const Alloc& alloc) : _root(NULL), _size(0), _comp(comp), _alloc(NodeAlloc(alloc)) {
+			_end = _create_sentinel();
+			_leftmost = _end;
 		}
 
-		virtual ~TreeInterface() {
+		~TreeInterface() {
+			if (_release_all())
+				return;
 			_deleteTree(_root);
-			//delete _end;
-			_alloc.destroy(_end);
-			_alloc.deallocate(_end, 1);
+			_destroy_node(_end);
 		}
 		
 		TreeInterface(const TreeInterface& other) : _root(NULL), _size(other._size), _comp(other._comp), _alloc(other._alloc) {
-			_end = _alloc.allocate(1);
-			_alloc.construct(_end, node());
+			_end = _create_sentinel();
 			_root = _copy_recurse(other._root, _end);
+			_end->right = _root;
+			_reset_extremes();
+		}
+
+		/* Replace the (empty) tree with the n distinct values of [first, last), which must be sorted by key.
+		 * O(n): no comparisons against the tree and no rebalancing. */
+		template <typename ForwardIt>
+		void build_sorted(ForwardIt first, ForwardIt last, size_t n) {
+			size_t full_levels = 0;
+			while (((size_t)2 << full_levels) - 1 <= n)
+				full_levels++;
+			_root = _build_sorted(first, last, n, _end, 0, full_levels);
+			_end->right = _root;
+			_size = n;
+			_reset_extremes();
+		}
+
+		/* Build the (empty) tree in O(n) if [first, last) is sorted by key. Equal keys keep the first one.
+		 * Return false without touching the tree if it is not sorted. */
+		template <typename ForwardIt>
+		bool build_if_sorted(ForwardIt first, ForwardIt last) {
+			size_t n = 0;
+			if (first != last) {
+				n = 1;
+				ForwardIt prev = first;
+				for (ForwardIt it = prev; ++it != last; prev = it) {
+					if (_comp(_key(*it), _key(*prev)))
+						return false;
+					if (_comp(_key(*prev), _key(*it)))
+						n++;
+				}
+			}
+			build_sorted(first, last, n);
+			return true;
+		}
+
+		/* Where key is, or where it would be linked. */
+		struct position {
+			node*	found;		// node holding key, NULL if there is none
+			node*	parent;		// otherwise, the node to link under (_end for an empty tree)
+			bool	left;		// ... as its left child
+		};
+
+		/* One descent from _root. Pass the result to insert_at() to add key without searching again. */
+		position locate(const Key& key) const {
+			position pos;
+			pos.found = NULL;
+			pos.parent = _end;
+			pos.left = false;
+			node* cur = _root;
+			while (cur != NULL) {
+				pos.parent = cur;
+				if (_comp(key, _key(cur))) {
+					pos.left = true;
+					cur = cur->left;
+				}
+				else if (_comp(_key(cur), key)) {
+					pos.left = false;
+					cur = cur->right;
+				}
+				else {
+					pos.found = cur;
+					break;
+				}
+			}
+			return pos;
+		}
+
+		/* Link a new node holding value at pos and rebalance. Return the new node.
+		 * pos must come from locate() on the key of value, with no modification in between. */
+		node* insert_at(const position& pos, const ValueType& value) {
+			node* n = _create_node(value, pos.parent);
+			if (pos.parent == _end) {
+				_end->right = _root = n;
+				_end->left = _leftmost = n;
+			}
+			else if (pos.left) {
+				pos.parent->left = n;
+				if (pos.parent == _leftmost)
+					_leftmost = n;
+			}
+			else {
+				pos.parent->right = n;
+				if (pos.parent == _end->left)
+					_end->left = n;
+			}
+			_size++;
+			_derived()._insert_fixup(n);
+			return n;
+		}
+
+		/* Return (newly inserted element, true) or (existing element with the same key, false). */
+		ft::pair<node*, bool> insert(const ValueType& value) {
+			position pos = locate(_key(value));
+			if (pos.found)
+				return ft::make_pair(pos.found, false);
+			return ft::make_pair(insert_at(pos, value), true);
 		}
 
-		/* Return a pointer to newly inserted (or existing) element. */
-		node* insert(ValueType value) {
-			if (!_root) {
-				//_root = new node(value, _end);
-				_root = _alloc.allocate(1);
-				_alloc.construct(_root, node(value, _end));
-				_end->right = _root;
-				_size++;
-				_root->color = ft::BLACK;
-				return _root;
+		/* Where key goes when the caller expects it to come right before hint (end() for "after the last").
+		 * If key falls between hint and its predecessor, one of the two has a free child on that side
+		 * (the predecessor has no right child or hint has no left child), so the node is linked there
+		 * with one or two comparisons. Any other hint costs those comparisons plus a normal locate(). */
+		position locate_hint(node* hint, const Key& key) const {
+			position pos;
+			pos.found = NULL;
+			if (hint == _end) {
+				node* last = _end->left;
+				if (last != NULL && _comp(_key(last), key)) {		// 맨 뒤에 추가
+					pos.parent = last;
+					pos.left = false;
+					return pos;
+				}
+				return locate(key);
+			}
+			if (_comp(key, _key(hint))) {
+				node* before = (hint == _leftmost) ? NULL : hint->prev();
+				if (before == NULL || _comp(_key(before), key)) {		// before < key < hint
+					if (before == NULL || before->right != NULL) {
+						pos.parent = hint;
+						pos.left = true;
+					}
+					else {
+						pos.parent = before;
+						pos.left = false;
+					}
+					return pos;
+				}
+				return locate(key);
 			}
-			return _insert(_root, value);
+			if (_comp(_key(hint), key)) {
+				node* after = hint->next();
+				if (after == _end || _comp(key, _key(after))) {		// hint < key < after
+					if (hint->right == NULL) {
+						pos.parent = hint;
+						pos.left = false;
+					}
+					else {
+						pos.parent = after;
+						pos.left = true;
+					}
+					return pos;
+				}
+				return locate(key);
+			}
+			pos.found = hint;
+			return pos;
+		}
+
+		/* Return the new element or the existing one with the same key. See locate_hint(). */
+		node* insert(node* hint, const ValueType& value) {
+			position pos = locate_hint(hint, _key(value));
+			if (pos.found)
+				return pos.found;
+			return insert_at(pos, value);
 		}
-		node* insert(node* hint, ValueType value) { return _insert(hint, value); }
 
 		/* If key is not present, return tree end. */
-		node* find(ValueType value) {
-			node* result =_find(_root, value);
+		node* find(const Key& key) const {
+			node* result =_find(_root, key);
 			if (result == NULL)
 				return _end;
 			return result;
 		}
 
-		void erase(ValueType value) {
-			_erase(_root, value);
+		/* find() for every key of [first, last), writing Result(node) to out in the same order.
+		 * Lookups go in groups of find_group descents moved one level at a time, in lockstep. Each step
+		 * prefetches the child it moves to, so the cache misses of a group overlap instead of
+		 * following one another. [first, last) is read again while a group is in flight, so it has to be
+		 * a forward range. */
+		enum { find_group = 16 };
+
+		template <typename Result, typename ForwardIt, typename OutputIt>
+		OutputIt find_many(ForwardIt first, ForwardIt last, OutputIt out) const {
+			ForwardIt	keys[find_group];
+			node*		cur[find_group];
+			node*		result[find_group];
+			while (first != last) {
+				size_t n = 0;
+				for (; n < find_group && first != last; ++n, ++first) {
+					keys[n] = first;
+					cur[n] = _root;
+					result[n] = _end;
+				}
+				for (size_t active = n; active != 0; ) {
+					active = 0;
+					for (size_t i = 0; i < n; i++) {
+						if (cur[i] == NULL)
+							continue;
+						if (_comp(*keys[i], _key(cur[i])))
+							cur[i] = cur[i]->left;
+						else if (_comp(_key(cur[i]), *keys[i]))
+							cur[i] = cur[i]->right;
+						else {
+							result[i] = cur[i];
+							cur[i] = NULL;
+						}
+						if (cur[i] != NULL) {
+							__builtin_prefetch(cur[i]);
+							active++;
+						}
+					}
+				}
+				for (size_t i = 0; i < n; i++)
+					*out++ = Result(result[i]);
+			}
+			return out;
 		}
-		void erase(node* pos) {
-			_erase(pos, pos->value);
+
+		/* Call fn(Ref(value)) for every element whose key is in [*lo, *hi), in key order. A NULL bound is open.
+		 * The walk keeps the path in a stack instead of climbing parent links as next() does, and a node's right
+		 * subtree is prefetched when the node is pushed, so it is loaded while the left subtree is visited.
+		 * fn must not insert or erase. */
+		template <typename Ref, typename Function>
+		void scan(const Key* lo, const Key* hi, Function& fn) const {
+			scan_stack<node> path;
+			for (node* cur = _root; cur != NULL; ) {
+				if (lo != NULL && _comp(_key(cur), *lo))	// lo보다 작은 node와 그 왼쪽은 건너뛴다
+					cur = cur->right;
+				else
+					cur = _push_left(path, cur);
+			}
+			while (!path.empty()) {
+				node* cur = path.pop();
+				if (hi != NULL && !_comp(_key(cur), *hi))
+					return;
+				fn(static_cast<Ref>(cur->value));
+				for (cur = cur->right; cur != NULL; )
+					cur = _push_left(path, cur);
+			}
 		}
 
-		node* begin() const {
-			if (_root == NULL)
-				return _end;
+		/* Return the first element whose key is not less than key. If there is none, return tree end.
+		 * Descends from _root once, so it is O(height). */
+		node* lower_bound(const Key& key) const {
 			node* cur = _root;
-			while (cur->left)
-				cur = cur->left;
-			return cur;
+			node* result = _end;
+			while (cur != NULL) {
+				if (!_comp(_key(cur), key)) {		// cur >= key 이면 후보로 두고 더 작은 쪽을 탐색
+					result = cur;
+					cur = cur->left;
+				}
+				else
+					cur = cur->right;
+			}
+			return result;
+		}
+
+		/* Return the first element whose key is greater than key. If there is none, return tree end. */
+		node* upper_bound(const Key& key) const {
+			node* cur = _root;
+			node* result = _end;
+			while (cur != NULL) {
+				if (_comp(key, _key(cur))) {		// cur > key 이면 후보로 두고 더 작은 쪽을 탐색
+					result = cur;
+					cur = cur->left;
+				}
+				else
+					cur = cur->right;
+			}
+			return result;
+		}
+
+		/* Return the number of erased elements (0 or 1). */
+		size_t erase(const Key& key) {
+			node* del = _find(_root, key);
+			if (del == NULL)
+				return 0;
+			erase(del);
+			return 1;
+		}
+		void erase(node* pos) {
+			// 회전은 순서를 바꾸지 않으므로 양 끝은 삭제할 때만 갱신하면 된다.
+			if (pos == _leftmost)
+				_leftmost = pos->next();
+			if (pos == _end->left)
+				_end->left = (_size == 1) ? NULL : pos->prev();
+			_derived()._erase(pos);
+		}
+
+		/* The value in n was modified in place (map::insert_or_assign). Lets an augmented engine recompute n's path. */
+		void value_changed(node* n) {
+			_derived()._update_path(n);
+		}
+
+		/* Erase [first, last). */
+		void erase(node* first, node* last) {
+			_derived()._erase_range(first, last);
 		}
 
+		node* begin() const { return _leftmost; }
+
 		node*	end() const { return _end; }
 
 		size_t	getSize() const { return _size; }
 
-		void	clear() { _deleteTree(_root); _root = NULL; }
+		/* With a releasing allocator the sentinel is rebuilt, so end() obtained before clear() is invalidated too. */
+		void	clear() {
+			if (_release_all()) {
+				_end = _create_sentinel();
+				_leftmost = _end;
+				return;
+			}
+			_deleteTree(_root);
+			_root = NULL;
+			_end->right = NULL;
+			_end->left = NULL;
+			_leftmost = _end;
+		}
 
 		void	swap(TreeInterface& x) {
 			std::swap(_end, x._end);
 			std::swap(_root, x._root);
+			std::swap(_leftmost, x._leftmost);
 			std::swap(_size, x._size);
 			std::swap(_comp, x._comp);
 			std::swap(_alloc, x._alloc);
 		}
 
-		virtual node* _insert(node* cur, ValueType value) = 0;
-		virtual node* _find(node* cur, ValueType value) = 0;
-		virtual void _erase(node* cur, ValueType value) = 0;
+	protected:
+		Derived&	_derived() { return static_cast<Derived&>(*this); }
+
+		/* node를 임시로 만들어 복사하지 않고, 할당한 자리에 바로 생성한다. value는 한 번만 복사된다. */
+		node* _create_node(const ValueType& value, node* parent) {
+			Node* n = _alloc.allocate(1);
+			try {
+				::new (static_cast<void*>(n)) Node(value, parent);
+			} catch (...) {
+				_alloc.deallocate(n, 1);
+				throw;
+			}
+			return n;
+		}
+
+		node* _create_sentinel() {
+			Node* n = _alloc.allocate(1);
+			try {
+				::new (static_cast<void*>(n)) Node();
+			} catch (...) {
+				_alloc.deallocate(n, 1);
+				throw;
+			}
+			return n;
+		}
+
+		void _destroy_node(node* n) {
+			//delete n;
+			Node* p = static_cast<Node*>(n);
+			_alloc.destroy(p);
+			_alloc.deallocate(p, 1);
+		}
+
+		static const Key&	_key(const ValueType& value)	{ return KeyOfValue()(value); }
+		static const Key&	_key(const node* n)				{ return KeyOfValue()(n->value); }
+
+		/* Search from cur down. Same for every engine. */
+		node* _find(node* cur, const Key& key) const {
+			while (cur != NULL) {
+				if (_comp(key, _key(cur)))			// 찾으려는 key가 현재 node의 key보다 작다면
+					cur = cur->left;
+				else if (_comp(_key(cur), key))		// 찾으려는 key가 현재 node의 key 보다 크다면
+					cur = cur->right;
+				else
+					return cur;
+			}
+			return cur;
+		}
+
+		/* Push cur for the in-order scan and return its left child. */
+		static node* _push_left(scan_stack<node>& path, node* cur) {
+			if (cur->right != NULL)
+				__builtin_prefetch(cur->right);
+			path.push(cur);
+			return cur->left;
+		}
+
+		node* _find_min(node* cur) const {
+			while (cur->left)
+				cur = cur->left;
+			return cur;
+		}
+
+		node* _find_max(node* cur) const {
+			while (cur->right)
+				cur = cur->right;
+			return cur;
+		}
+
+		node* _copy_recurse(node* src, node* dst_parent) {
+			if (!src)
+				return NULL;
+			node* dst = _create_node(src->value, dst_parent);
+			dst->set_color(src->color());
+			dst->left = _copy_recurse(src->left, dst);
+			dst->right = _copy_recurse(src->right, dst);
+			_derived()._update(dst);
+			return dst;
+		}
+
+		void _deleteTree(node* cur) {
+			if (cur == NULL)
+				return;
+			_deleteTree(cur->left);
+			_deleteTree(cur->right);
+			_destroy_node(cur);
+			_size--;
+		}
+
+		/* Forget every node without freeing them (they were moved elsewhere). _size is left to the caller. */
+		void _reset_empty() {
+			_root = NULL;
+			_end->right = NULL;
+			_end->left = NULL;
+			_leftmost = _end;
+		}
+
+		/* Erase [first, last) one node at a time. Engines that can cut a range out faster define their own. */
+		void _erase_range(node* first, node* last) {
+			while (first != last) {
+				node* next = first->next();
+				erase(first);
+				first = next;
+			}
+		}
+
+		/* Recompute both ends after the tree was built as a whole (copy, bulk build). */
+		void _reset_extremes() {
+			_leftmost = (_root == NULL) ? _end : _find_min(_root);
+			_end->left = (_root == NULL) ? NULL : _find_max(_root);
+		}
+
+		/* del의 부모와 child를 서로 연결.
+		 * del 이 root node라면 child를 새로운 root로 지정
+		*/
+		void _link_parent_child(node* del, node* child) {
+			if (del == _root)
+				_end->right = _root = child;
+			else
+			{
+				if (del == del->parent()->left)
+					del->parent()->left = child;
+				else
+					del->parent()->right = child;
+			}
+			if (child != NULL)
+				child->set_parent(del->parent());
+		}
 
 
 };
@@ -2,12 +2,15 @@
 # define VECTOR_HPP
 
 # include <cstddef> // ptrdiff_t
+# include <cstring> // memcpy, memmove
 # include <memory> // allocator
 # include <limits> // numeric_limits, max
+# include <stdexcept> // length_error, out_of_range
 # include "random_access_iterator.hpp"
 # include "utils/reverse_iterator.hpp"
 # include "utils/enable_if.hpp"
 # include "utils/is_integral.hpp"
+# include "utils/is_trivially_relocatable.hpp"
 # include "utils/lexicographical_compare.hpp"
 
 /* std::allocator
@@ -18,6 +21,8 @@
  * std::allocator::deallocate(p, n)  : p 부터 p+n 까지의 메모리블록을 해제
  * std::allocator::construct(p, val) : p가 가리키는 곳에 object val의 생성자를 대입
  * std::allocator::destroy(p)        : p가 가리키는 object의 소멸자 호출 (해당 object의 메모리 반환은 사용자의 책임)
+ *
+ * T가 is_trivially_relocatable 이라면 원소를 옮길 때 construct/destroy 대신 memcpy/memmove를 쓰고, 소멸자 호출도 생략한다.
  */
 
 namespace ft {
@@ -88,8 +93,7 @@ class vector {
 			_ptr_start = _alloc.allocate(other._capacity);
 			_size = other._size;
 			_capacity = other._capacity;
-			for (size_t i = 0; i < _size; i++)
-				_alloc.construct(_ptr_start + i, other._ptr_start[i]);
+			_copy_construct(_ptr_start, other._ptr_start, _size);
 		}
 
 		// operator=
@@ -127,23 +131,11 @@ class vector {
 		 */
 		void			resize(size_type n, value_type val = value_type()) {
 			if (n > _capacity)
-			{
-				vector tmp(_alloc);
-				tmp.reserve((n > _capacity * 2) ? n : _capacity * 2);
-				tmp._size = n;
-				for (size_t i = 0; i < n; i++)
-					if (i < _size)
-						_alloc.construct(tmp._ptr_start + i, _ptr_start[i]);
-					else
-						_alloc.construct(tmp._ptr_start + i, val);
-				swap(tmp);
-			}
-			else
-			{
-				for (size_t i = _size; i < _capacity; i++)
-					_alloc.construct(_ptr_start + i, val);
-				_size = n;
-			}
+				reserve((n > _capacity * 2) ? n : _capacity * 2);
+			while (_size > n)
+				pop_back();
+			for (; _size < n; _size++)
+				_alloc.construct(_ptr_start + _size, val);
 		}
 
 		size_type		capacity() const { return _capacity; }
@@ -159,6 +151,17 @@ class vector {
 			if ( n > _capacity) {
 				if (n > max_size())
 					throw std::length_error("ft_vector");
+				if (is_trivially_relocatable<T>::value) {
+					// 새 블록으로 통째로 복사하고 옛 블록은 소멸자 호출 없이 반환
+					pointer new_start = _alloc.allocate(n);
+					if (_size)
+						std::memcpy(static_cast<void*>(new_start), _ptr_start, _size * sizeof(T));
+					if (_ptr_start)
+						_alloc.deallocate(_ptr_start, _capacity);
+					_ptr_start = new_start;
+					_capacity = n;
+					return;
+				}
 				vector tmp(_alloc);
 				tmp._ptr_start = _alloc.allocate(n);
 				tmp._capacity = n;
@@ -220,7 +223,7 @@ class vector {
 		}
 
 		void			pop_back() {
-			if (_size)
+			if (_size && !is_trivially_relocatable<T>::value)
 				_alloc.destroy(_ptr_start + _size - 1);
 			_size--;
 		}
@@ -238,27 +241,23 @@ class vector {
 			size_type insertion_idx = position - begin();
 
 			if (_size + n <= _capacity) {
-				for (size_type i = _size + n; i > insertion_idx; i--) {
-					_alloc.destroy(_ptr_start + i);
-					_alloc.construct(_ptr_start + i, _ptr_start[i-n]);
+				_shift_right(insertion_idx, n);
+				for (size_type i = insertion_idx; i < insertion_idx + n; i++) {
+					if (i < _size && !is_trivially_relocatable<T>::value)
+						_alloc.destroy(_ptr_start + i);
+					_alloc.construct(_ptr_start + i, val);
 				}
 				_size += n;
-				while (n) {
-					_alloc.destroy(_ptr_start + insertion_idx + n - 1);
-					_alloc.construct(_ptr_start + insertion_idx + n-- - 1, val);
-				}
 			}
 			else
 			{
 				vector tmp(_alloc);
-				tmp.reserve(_size + n);
+				tmp.reserve(_size + ((n > _size) ? n : _size));	// push_back처럼 배수로 늘려서 재할당 횟수를 줄인다
 				tmp._size = _size + n;
-				for (size_type i = 0; i < insertion_idx; i++)
-					_alloc.construct(tmp._ptr_start + i, _ptr_start[i]);
+				_copy_construct(tmp._ptr_start, _ptr_start, insertion_idx);
 				for (size_type i = insertion_idx; i < insertion_idx + n; i++)
 					_alloc.construct(tmp._ptr_start + i, val);
-				for (size_type i = insertion_idx + n; i < _size + n; i++)
-					_alloc.construct(tmp._ptr_start + i, _ptr_start[i-n]);
+				_copy_construct(tmp._ptr_start + insertion_idx + n, _ptr_start + insertion_idx, _size - insertion_idx);
 				swap(tmp);
 			}
 		}
@@ -273,28 +272,23 @@ class vector {
 			size_type insertion_idx = position - begin();
 
 			if (_size + n <= _capacity) {
-				for (size_type i = _size + n; i > insertion_idx; i--) {
-					_alloc.destroy(_ptr_start + i);
-					_alloc.construct(_ptr_start + i, _ptr_start[i - n]);
-				}
-				size_type i = 0;
-				while (first != last) {
-					_alloc.destroy(_ptr_start + insertion_idx + i);
-					_alloc.construct(_ptr_start + insertion_idx + i++, *(first++));
+				_shift_right(insertion_idx, n);
+				for (size_type i = insertion_idx; i < insertion_idx + n; i++) {
+					if (i < _size && !is_trivially_relocatable<T>::value)
+						_alloc.destroy(_ptr_start + i);
+					_alloc.construct(_ptr_start + i, *(first++));
 				}
 				_size += n;
 			}
 			else
 			{
 				vector tmp(_alloc);
-				tmp.reserve(_size + n);
+				tmp.reserve(_size + ((n > _size) ? n : _size));	// push_back처럼 배수로 늘려서 재할당 횟수를 줄인다
 				tmp._size = _size + n;
-				for (size_type i = 0; i < insertion_idx; i++)
-					_alloc.construct(tmp._ptr_start + i, _ptr_start[i]);
+				_copy_construct(tmp._ptr_start, _ptr_start, insertion_idx);
 				for (size_type i = insertion_idx; i < insertion_idx + n; i++)
 					_alloc.construct(tmp._ptr_start + i, *(first++));
-				for (size_type i = insertion_idx + n; i < _size + n; i++)
-					_alloc.construct(tmp._ptr_start + i, _ptr_start[i-n]);
+				_copy_construct(tmp._ptr_start + insertion_idx + n, _ptr_start + insertion_idx, _size - insertion_idx);
 				swap(tmp);
 			}
 		}
@@ -306,10 +300,18 @@ class vector {
 
 		iterator		erase(iterator first, iterator last) {
 			// pointer p_pos = &(*first);
+			if (first == last)
+				return first;
 			if (last == end()) {
 				while (first != last--)
 					pop_back();
 			}
+			else if (is_trivially_relocatable<T>::value) {
+				size_type n = last - first;
+				size_type idx = &(*first) - _ptr_start;
+				std::memmove(static_cast<void*>(_ptr_start + idx), _ptr_start + idx + n, (_size - idx - n) * sizeof(T));
+				_size -= n;
+			}
 			else {
 				size_type n = last - first;
 				for (size_type i = &(*first) - _ptr_start; i < _size - n; i++) {
@@ -330,6 +332,8 @@ class vector {
 		}
 
 		void			clear() {
+			if (is_trivially_relocatable<T>::value)
+				_size = 0;
 			while (_size)
 				pop_back();
 		}
@@ -339,6 +343,35 @@ class vector {
 			return _alloc;
 		}
 
+	private:
+		// src의 n개 원소를 초기화되지 않은 메모리 dst에 복사 생성한다.
+		void			_copy_construct(pointer dst, const_pointer src, size_type n) {
+			if (is_trivially_relocatable<T>::value) {
+				if (n)
+					std::memcpy(static_cast<void*>(dst), src, n * sizeof(T));
+				return;
+			}
+			for (size_type i = 0; i < n; i++)
+				_alloc.construct(dst + i, src[i]);
+		}
+
+		/* [pos, _size) 를 n칸 뒤로 민다. _size + n <= _capacity 여야 하고, _size는 바꾸지 않는다.
+		 * 호출 후 [pos, pos + n) 중 _size보다 앞의 칸에는 아직 이전 객체가 남아있으므로, 덮어쓰기 전에 destroy 해야 한다.
+		 */
+		void			_shift_right(size_type pos, size_type n) {
+			if (n == 0)
+				return;
+			if (is_trivially_relocatable<T>::value) {
+				std::memmove(static_cast<void*>(_ptr_start + pos + n), _ptr_start + pos, (_size - pos) * sizeof(T));
+				return;
+			}
+			for (size_type i = _size + n; i-- > pos + n; ) {
+				if (i < _size)
+					_alloc.destroy(_ptr_start + i);
+				_alloc.construct(_ptr_start + i, _ptr_start[i - n]);
+			}
+		}
+
 };
   
 // relational operators (==, !=, <, <=, >, >=)